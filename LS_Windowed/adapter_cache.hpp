@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Adapter wrappers shared by every live proxy factory, keyed by adapter LUID,
+// so enumerating the same adapter through any factory on any thread returns
+// the same wrapper. The cache holds one reference on each wrapper until the
+// last factory is released.
+//
+// Lookups are lock-free: entries are only appended, under the writer mutex,
+// and published by bumping m_count. They are removed only once no factory is
+// alive, and lookups only happen through a live factory, so a reader never
+// sees an entry being torn down.
+template <class T, size_t Capacity = 16>
+class AdapterCache {
+public:
+    // Factory lifetime. ReleaseFactory returns true when the last factory is
+    // gone; the cached wrappers have been released by then.
+    void RetainFactory() {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        m_factories++;
+    }
+
+    bool ReleaseFactory() {
+        T* released[Capacity];
+        size_t count;
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            if (--m_factories > 0) return false;
+            count = m_count.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < count; i++) released[i] = m_entries[i].value;
+            m_count.store(0, std::memory_order_relaxed);
+        }
+        // Outside the lock: a wrapper's destructor may call back into DXGI
+        for (size_t i = 0; i < count; i++) released[i]->Release();
+        return true;
+    }
+
+    // Returns the wrapper for key with a reference added for the caller,
+    // calling create() to build one on a miss. create() returns a wrapper with
+    // one reference, which the cache keeps. If the cache is full the new
+    // wrapper is returned uncached. *created tells the caller whether create()
+    // ran, i.e. whether it consumed the caller's adapter reference.
+    template <class CreateFn>
+    T* FindOrInsert(uint64_t key, CreateFn&& create, bool* created) {
+        *created = false;
+        if (T* found = Find(key)) return found;
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        if (T* found = Find(key)) return found; // Another thread inserted it meanwhile
+
+        T* wrapper = create();
+        *created = true;
+        size_t count = m_count.load(std::memory_order_relaxed);
+        if (count == Capacity) return wrapper;
+
+        m_entries[count].key = key;
+        m_entries[count].value = wrapper;
+        m_count.store(count + 1, std::memory_order_release);
+        m_inserts.fetch_add(1, std::memory_order_relaxed);
+        wrapper->AddRef(); // For the caller
+        return wrapper;
+    }
+
+    // Wrapper for key with a reference added for the caller, or nullptr
+    T* Find(uint64_t key) const {
+        size_t count = m_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            if (m_entries[i].key == key) {
+                m_entries[i].value->AddRef();
+                return m_entries[i].value;
+            }
+        }
+        return nullptr;
+    }
+
+    size_t Size() const { return m_count.load(std::memory_order_acquire); }
+    // Wrappers ever cached; more than the adapter count means some were rebuilt
+    uint64_t Inserts() const { return m_inserts.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        T* value;
+    };
+
+    Entry m_entries[Capacity] = {};
+    std::atomic<size_t> m_count{0};
+    std::atomic<uint64_t> m_inserts{0};
+    std::mutex m_writeMutex;
+    size_t m_factories = 0;
+};
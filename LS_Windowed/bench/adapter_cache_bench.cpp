@@ -0,0 +1,254 @@
+// Multi-threaded stress of the adapter wrapper cache behind
+// ProxyDXGIFactory::EnumAdapters. Reader threads enumerate adapters through a
+// long-lived factory while churn threads create and release factories of their
+// own and now and then invalidate the output topology; every wrapper returned
+// for a LUID must be the one the long-lived factory saw, and no wrapper may be
+// rebuilt while a factory is alive. A mutex-guarded
+// std::map with the same key is measured as a baseline for the lookup.
+//
+//   ls_adapter_cache_bench [--out results.json] [--quick] [--threads N]
+#include "adapter_cache.hpp"
+#include "bench_json.hpp"
+#include "dxgi_proxy.hpp"
+#include "mock_dxgi.hpp"
+#include "virtual_displays.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <vector>
+
+// Defined by main.cpp in the DLL
+VirtualDisplays g_VirtualDisplays({{0, 0, 1920, 1080}, {0, 0, 1920, 1080}, nullptr, nullptr});
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr UINT kAdapterCount = 4;
+
+struct MockSystem {
+    MockDXGIOutput6 output{RECT{0, 0, 2560, 1440}};
+    MockDXGIAdapter4 adapter0{LUID{0x1000, 0}, &output};
+    MockDXGIAdapter4 adapter1{LUID{0x2000, 0}, nullptr};
+    MockDXGIAdapter4 adapter2{LUID{0x3000, 1}, nullptr};
+    MockDXGIAdapter4 adapter3{LUID{0x4000, 1}, nullptr};
+    IDXGIAdapter4* adapters[kAdapterCount] = {&adapter0, &adapter1, &adapter2, &adapter3};
+    MockDXGIFactory6 factory{adapters, kAdapterCount};
+
+    ProxyDXGIFactory* NewProxyFactory() {
+        factory.AddRef(); // The proxy releases the real factory on destruction
+        return new ProxyDXGIFactory(&factory);
+    }
+};
+
+struct StressResult {
+    uint64_t lookups = 0;
+    uint64_t factoryCycles = 0;
+    uint64_t mismatches = 0;
+    double seconds = 0.0;
+};
+
+StressResult RunStress(MockSystem& system, int readers, int churners, std::chrono::milliseconds duration) {
+    ProxyDXGIFactory* owner = system.NewProxyFactory();
+    IDXGIAdapter* expected[kAdapterCount];
+    for (UINT i = 0; i < kAdapterCount; i++) {
+        owner->EnumAdapters(i, &expected[i]);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> lookups{0}, cycles{0}, mismatches{0};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < readers; t++) {
+        threads.emplace_back([&, t] {
+            uint64_t count = 0, bad = 0;
+            UINT index = (UINT)t;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; i++) {
+                    IDXGIAdapter* adapter = nullptr;
+                    owner->EnumAdapters(index % kAdapterCount, &adapter);
+                    if (adapter != expected[index % kAdapterCount]) bad++;
+                    IDXGIOutput* output = nullptr;
+                    if (SUCCEEDED(adapter->EnumOutputs(0, &output))) output->Release();
+                    adapter->Release();
+                    index++;
+                }
+                count += 256;
+            }
+            lookups += count;
+            mismatches += bad;
+        });
+    }
+
+    for (int t = 0; t < churners; t++) {
+        threads.emplace_back([&] {
+            uint64_t count = 0, bad = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                ProxyDXGIFactory* factory = system.NewProxyFactory();
+                for (UINT i = 0; i < kAdapterCount; i++) {
+                    IDXGIAdapter1* adapter = nullptr;
+                    factory->EnumAdapters1(i, &adapter);
+                    if (adapter != static_cast<IDXGIAdapter1*>(static_cast<ProxyDXGIAdapter*>(expected[i]))) bad++;
+                    adapter->Release();
+                }
+                factory->Release();
+                if (++count % 64 == 0) InvalidateOutputTopology();
+            }
+            cycles += count;
+            mismatches += bad;
+        });
+    }
+
+    auto start = Clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (std::thread& thread : threads) thread.join();
+
+    StressResult result;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.lookups = lookups;
+    result.factoryCycles = cycles;
+    result.mismatches = mismatches;
+
+    for (IDXGIAdapter* adapter : expected) adapter->Release();
+    owner->Release();
+    return result;
+}
+
+// No long-lived factory: the cache is emptied and rebuilt whenever every
+// thread happens to be between factories. Within one factory's lifetime a
+// LUID must always map to the same wrapper.
+StressResult RunChurnOnly(MockSystem& system, int threads, std::chrono::milliseconds duration) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> cycles{0}, mismatches{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            uint64_t count = 0, bad = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                ProxyDXGIFactory* factory = system.NewProxyFactory();
+                IDXGIAdapter* first[kAdapterCount];
+                for (UINT i = 0; i < kAdapterCount; i++) factory->EnumAdapters(i, &first[i]);
+                for (UINT i = 0; i < kAdapterCount; i++) {
+                    IDXGIAdapter* again = nullptr;
+                    factory->EnumAdapters(i, &again);
+                    if (again != first[i]) bad++;
+                    again->Release();
+                    first[i]->Release();
+                }
+                factory->Release();
+                count++;
+            }
+            cycles += count;
+            mismatches += bad;
+        });
+    }
+    auto start = Clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (std::thread& worker : workers) worker.join();
+
+    StressResult result;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.factoryCycles = cycles;
+    result.mismatches = mismatches;
+    return result;
+}
+
+// The obvious alternative: one lock around a map
+struct MutexMapCache {
+    std::mutex mutex;
+    std::map<uint64_t, ProxyDXGIAdapter*> map;
+
+    ProxyDXGIAdapter* Find(uint64_t key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = map.find(key);
+        if (it == map.end()) return nullptr;
+        it->second->AddRef();
+        return it->second;
+    }
+};
+
+template <class FindFn>
+double MeasureLookups(int threads, std::chrono::milliseconds duration, FindFn&& find, uint64_t* totalOut) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            uint64_t count = 0;
+            uint64_t key = (uint64_t)t;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; i++) {
+                    ProxyDXGIAdapter* adapter = find(key++ % kAdapterCount);
+                    adapter->Release();
+                }
+                count += 256;
+            }
+            total += count;
+        });
+    }
+    auto start = Clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (std::thread& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    *totalOut = total;
+    // Aggregate cost: wall time per lookup across all threads
+    return seconds * 1e9 / (double)total;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchSuite suite("ls_adapter_cache_bench", argc, argv);
+    int threads = (int)std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+    }
+    if (threads < 2) threads = 2;
+    auto duration = suite.Quick() ? std::chrono::milliseconds(100) : std::chrono::milliseconds(1000);
+    fprintf(stderr, "%d threads (%u hardware)\n", threads, std::thread::hardware_concurrency());
+
+    MockSystem system;
+
+    StressResult stress = RunStress(system, threads - 1, 1, duration);
+    suite.Add("adapter_cache/stress_enum_adapters", stress.seconds * 1e9 / (double)stress.lookups, stress.lookups);
+    suite.Add("adapter_cache/stress_factory_cycle", stress.seconds * 1e9 / (double)stress.factoryCycles,
+              stress.factoryCycles);
+
+    StressResult churn = RunChurnOnly(system, threads, duration);
+    suite.Add("adapter_cache/churn_factory_cycle", churn.seconds * 1e9 / (double)churn.factoryCycles,
+              churn.factoryCycles);
+    stress.mismatches += churn.mismatches;
+
+    // Lookup cost alone, against bare caches holding one wrapper per adapter
+    AdapterCache<ProxyDXGIAdapter> cache;
+    MutexMapCache mutexMap;
+    cache.RetainFactory();
+    for (UINT i = 0; i < kAdapterCount; i++) {
+        system.adapters[i]->AddRef();
+        ProxyDXGIAdapter* wrapper = new ProxyDXGIAdapter(system.adapters[i], i);
+        bool created;
+        cache.FindOrInsert(i, [&] { return wrapper; }, &created)->Release();
+        wrapper->AddRef();
+        mutexMap.map[i] = wrapper;
+    }
+    uint64_t total = 0;
+    double lockFree = MeasureLookups(threads, duration, [&](uint64_t key) { return cache.Find(key); }, &total);
+    suite.Add("adapter_cache/lookup_lock_free", lockFree, total);
+    double locked = MeasureLookups(threads, duration, [&](uint64_t key) { return mutexMap.Find(key); }, &total);
+    suite.Add("adapter_cache/lookup_mutex_map", locked, total);
+    for (auto& pair : mutexMap.map) pair.second->Release();
+    cache.ReleaseFactory();
+
+    // Every wrapper and factory reference taken above must have been returned
+    bool leakFree = system.output.RefCount() == 1 && system.adapter0.RefCount() == 1 && system.adapter3.RefCount() == 1 && system.factory.RefCount() == 1;
+    fprintf(stderr, "stress: %llu lookups, %llu factory cycles, %llu mismatches; references %s\n",
+            (unsigned long long)stress.lookups, (unsigned long long)stress.factoryCycles,
+            (unsigned long long)stress.mismatches, leakFree ? "balanced" : "LEAKED");
+    if (stress.mismatches || !leakFree) return 1;
+    return suite.Finish();
+}
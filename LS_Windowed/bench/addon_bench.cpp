@@ -0,0 +1,286 @@
+// Hot paths of the addon itself, built against the Win32/DXGI stand-ins in
+// winapi/ and driven through the mocks in mock_dxgi.hpp. dxgi_proxy.cpp is
+// compiled unchanged into this binary. Emits JSON for tracking between
+// releases; the correctness checks are in tests/addon_test.cpp:
+//
+//   ls_addon_bench [--out results.json] [--quick]
+#include "bench_json.hpp"
+#include "dxgi_proxy.hpp"
+#include "grid_layout.hpp"
+#include "hook_stats.hpp"
+#include "layout.hpp"
+#include "logger.hpp"
+#include "mock_dxgi.hpp"
+#include "present_stats.hpp"
+#include "virtual_displays.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+// Defined by main.cpp in the DLL
+VirtualDisplays g_VirtualDisplays({{0, 0, 1920, 1080}, {0, 0, 1920, 1080}, nullptr, nullptr});
+
+namespace {
+
+// A real output wrapped with the counting policy instead of HookStatsPolicy
+class CountedOutput final : public DXGIOutputForwarder<CountedOutput, CallCountPolicy> {
+    IDXGIOutput6* m_pOutput;
+
+public:
+    static constexpr const auto& kIids = kOutputIids;
+
+    explicit CountedOutput(IDXGIOutput6* pOutput) : m_pOutput(pOutput) {}
+    ~CountedOutput() { m_pOutput->Release(); }
+
+    IDXGIOutput6* Real() const { return m_pOutput; }
+};
+
+void BenchLayout(BenchSuite& suite) {
+    const LayoutRect targetWindow{100, 80, 1380, 830};
+    const LayoutRect targetClient{108, 111, 1372, 822};
+    for (int side = 0; side < 4; side++) {
+        static const char* kSides[] = {"left", "right", "top", "bottom"};
+        suite.Run(std::string("layout/position_beside_target/") + kSides[side], [&] {
+            LayoutRect result = PositionBesideTarget(targetWindow, targetClient, side);
+            DoNotOptimize(result);
+        });
+    }
+
+    GridLayout grid;
+    ParseGridLayout("3x2:0,0,2,2;2,0,1,1;2,1,1,1", &grid);
+    int cell = 0;
+    suite.Run("layout/grid_cell_rect", [&] {
+        LayoutRect region;
+        bool valid = GridCellRect(grid, cell, 2560, 1440, &region);
+        cell = (cell + 1) % grid.cellCount;
+        DoNotOptimize(valid);
+        DoNotOptimize(region);
+    });
+    // What the layout engine pays per apply once the cells are computed
+    GridTemplate cells;
+    int32_t width = 2560;
+    suite.Run("layout/grid_template_hit", [&] {
+        cells.Update(grid, width, 1440);
+        DoNotOptimize(cells.Cell(cell));
+    });
+}
+
+void BenchLogger(BenchSuite& suite) {
+    // Drop policy: measures what a hook pays, not how fast the disk is
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "ls_addon_bench.binlog";
+    LoggerOptions options;
+    options.overflowPolicy = LogOverflowPolicy::Drop;
+    Logger::Init(path.wstring(), options);
+
+    const std::string message = "[LS_Windowed] ProxyDXGIOutput::GetDesc (FAKE) returning 1920x1080 @ (0,0)";
+    suite.Run("logger/log_string", [&] { Logger::Log(message); });
+    int i = 0;
+    suite.Run("logger/log_info_4_ints", [&] {
+        LOG_INFO("[LS_Windowed] ProxyDXGIOutput::GetDesc (FAKE) returning %dx%d @ (%d,%d)", 1920, 1080, i, i);
+        i++;
+    });
+
+    Logger::Shutdown();
+    Logger::Close();
+    std::filesystem::remove(path);
+}
+
+void BenchProxies(BenchSuite& suite) {
+    MockDXGIOutput6 output(RECT{0, 0, 2560, 1440});
+    MockDXGIOutput6 secondaryOutput(RECT{2560, 0, 4480, 1080});
+    MockDXGIAdapter4 adapter0(LUID{0x1000, 0}, &output);
+    MockDXGIAdapter4 adapter1(LUID{0x2000, 0}, &secondaryOutput);
+    IDXGIAdapter4* adapters[] = {&adapter0, &adapter1};
+    MockDXGISwapChain4 mockSwapChain;
+    MockDXGIFactory6 factory(adapters, 2, &mockSwapChain);
+
+    // The proxy factory owns one reference to the mock; g_AdapterCache lives in
+    // dxgi_proxy.cpp and is filled by the first EnumAdapters per LUID
+    factory.AddRef();
+    ProxyDXGIFactory* proxyFactory = new ProxyDXGIFactory(&factory);
+
+    UINT index = 0;
+    suite.Run("adapter_cache/enum_adapters_hit", [&] {
+        IDXGIAdapter* adapter = nullptr;
+        proxyFactory->EnumAdapters(index, &adapter);
+        adapter->Release();
+        index ^= 1;
+    });
+
+    // Adapter 0 has one real output; the fake one is injected at index 1
+    IDXGIAdapter* adapter = nullptr;
+    proxyFactory->EnumAdapters(0, &adapter);
+    suite.Run("adapter/enum_outputs_real", [&] {
+        IDXGIOutput* enumerated = nullptr;
+        adapter->EnumOutputs(0, &enumerated);
+        enumerated->Release();
+    });
+    suite.Run("adapter/enum_outputs_fake", [&] {
+        IDXGIOutput* enumerated = nullptr;
+        adapter->EnumOutputs(1, &enumerated);
+        enumerated->Release();
+    });
+    suite.Run("adapter/enum_outputs_end", [&] {
+        IDXGIOutput* enumerated = nullptr;
+        HRESULT hr = adapter->EnumOutputs(2, &enumerated);
+        DoNotOptimize(hr);
+    });
+
+    // Every virtual display gets its own fake output and monitor handle
+    g_VirtualDisplays.SetCount(kMaxVirtualDisplays);
+    InvalidateOutputTopology();
+    suite.Run("virtual_displays/index_of", [&] {
+        static uintptr_t handle = VirtualDisplays::kMonitorBase;
+        DoNotOptimize(g_VirtualDisplays.IndexOf((HMONITOR)handle));
+        handle ^= 2;
+    });
+    g_VirtualDisplays.SetCount(1);
+    InvalidateOutputTopology();
+    adapter->Release();
+
+    // Fake output modes: the adapter above reported the mock panel's rates
+    IDXGIOutput* fakeEnumerated = nullptr;
+    proxyFactory->EnumAdapters(0, &adapter);
+    adapter->EnumOutputs(1, &fakeEnumerated);
+    adapter->Release();
+    IDXGIOutput1* fakeOutput1 = nullptr;
+    fakeEnumerated->QueryInterface(__uuidof(IDXGIOutput1), (void**)&fakeOutput1);
+    fakeEnumerated->Release();
+
+    DXGI_MODE_DESC1 modes[256];
+    suite.Run("modes/get_display_mode_list1", [&] {
+        UINT count = 0;
+        fakeOutput1->GetDisplayModeList1(DXGI_FORMAT_R8G8B8A8_UNORM, 0, &count, nullptr);
+        fakeOutput1->GetDisplayModeList1(DXGI_FORMAT_R8G8B8A8_UNORM, 0, &count, modes);
+        DoNotOptimize(modes);
+    });
+    static const UINT kRequests[][3] = {{1920, 1080, 144}, {1280, 720, 60}, {3840, 2160, 240}, {1600, 900, 75}};
+    UINT request = 0;
+    suite.Run("modes/find_closest_matching_mode1", [&] {
+        DXGI_MODE_DESC1 wanted = {};
+        wanted.Width = kRequests[request][0];
+        wanted.Height = kRequests[request][1];
+        wanted.RefreshRate = {kRequests[request][2], 1};
+        wanted.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        DXGI_MODE_DESC1 closest;
+        fakeOutput1->FindClosestMatchingMode1(&wanted, &closest, nullptr);
+        DoNotOptimize(closest);
+        request = (request + 1) & 3;
+    });
+    UINT modeCount = 256;
+    fakeOutput1->GetDisplayModeList1(DXGI_FORMAT_R8G8B8A8_UNORM, 0, &modeCount, modes);
+    fprintf(stderr, "fake output: %u modes, highest %ux%u @ %u/%u\n", modeCount, modes[modeCount - 1].Width,
+            modes[modeCount - 1].Height, modes[modeCount - 1].RefreshRate.Numerator,
+            modes[modeCount - 1].RefreshRate.Denominator);
+    fakeOutput1->Release();
+
+    output.AddRef();
+    ProxyDXGIOutput* realOutput = new ProxyDXGIOutput(&output);
+    FakeDXGIOutput* fakeOutput = new FakeDXGIOutput(0);
+
+    suite.Run("output/query_interface_own_iid", [&] {
+        void* object = nullptr;
+        realOutput->QueryInterface(__uuidof(IDXGIOutput6), &object);
+        static_cast<IUnknown*>(object)->Release();
+    });
+    suite.Run("output/query_interface_forwarded", [&] {
+        void* object = nullptr;
+        HRESULT hr = realOutput->QueryInterface(__uuidof(IDXGIResource), &object);
+        DoNotOptimize(hr);
+    });
+    suite.Run("output/get_desc_real", [&] {
+        DXGI_OUTPUT_DESC desc;
+        realOutput->GetDesc(&desc);
+        DoNotOptimize(desc);
+    });
+    output.AddRef();
+    CountedOutput* countedOutput = new CountedOutput(&output);
+    suite.Run("output/get_desc_counted", [&] {
+        DXGI_OUTPUT_DESC desc;
+        countedOutput->GetDesc(&desc);
+        DoNotOptimize(desc);
+    });
+    // The policies see every forwarded call: HookStatsPolicy times GetDesc on
+    // real outputs under the same hook as the fake output's, and leaves
+    // untimed methods alone
+    HookStats::Reset();
+    DXGI_OUTPUT_DESC desc;
+    DXGI_FRAME_STATISTICS frameStats;
+    realOutput->GetDesc(&desc);
+    realOutput->GetFrameStatistics(&frameStats);
+    countedOutput->GetFrameStatistics(&frameStats);
+    HookSummary hooks[kHookCount];
+    HookStats::Summarize(hooks);
+    fprintf(stderr, "output policies: %llu timed GetDesc, %llu counted GetDesc, %llu counted GetFrameStatistics\n",
+            (unsigned long long)hooks[(size_t)HookId::OutputGetDesc].calls,
+            (unsigned long long)CallCountPolicy::Calls<&IDXGIOutput::GetDesc>(),
+            (unsigned long long)CallCountPolicy::Calls<&IDXGIOutput::GetFrameStatistics>());
+    countedOutput->Release();
+
+    suite.Run("output/get_desc_fake", [&] {
+        DXGI_OUTPUT_DESC desc;
+        fakeOutput->GetDesc(&desc);
+        DoNotOptimize(desc);
+    });
+    suite.Run("output/frame_statistics_fake", [&] {
+        DXGI_FRAME_STATISTICS stats;
+        fakeOutput->GetFrameStatistics(&stats);
+        DoNotOptimize(stats);
+    });
+
+    // Swap chains come back wrapped, their presents timed into a ring that
+    // the settings UI summarizes
+    IDXGISwapChain1* swapChain = nullptr;
+    proxyFactory->CreateSwapChainForHwnd(nullptr, (HWND)0x1234, nullptr, nullptr, nullptr, &swapChain);
+    IDXGISwapChain4* directSwapChain = &mockSwapChain;
+    suite.Run("swap_chain/present_direct", [&] {
+        DoNotOptimize(directSwapChain);
+        directSwapChain->Present(1, 0);
+    });
+    suite.Run("swap_chain/present_proxy", [&] { swapChain->Present(1, 0); });
+
+    // The same with a frame capture running: every present is also appended
+    // to the mapped capture file
+    std::filesystem::path capturePath = std::filesystem::temp_directory_path() / "ls_addon_bench.framecap";
+    if (g_FrameCapture.Start(capturePath, g_VirtualVBlank[0].Period())) {
+        suite.Run("swap_chain/present_capture", [&] { swapChain->Present(1, 0); });
+        g_FrameCapture.Stop();
+        fprintf(stderr, "frame capture: %llu records, %llu dropped, %llu bytes in %s\n",
+                (unsigned long long)g_FrameCapture.Records(), (unsigned long long)g_FrameCapture.Dropped(),
+                (unsigned long long)std::filesystem::file_size(capturePath), capturePath.string().c_str());
+    } else {
+        fprintf(stderr, "cannot create %s\n", capturePath.string().c_str());
+    }
+    swapChain->Present(0, DXGI_PRESENT_TEST);
+    PresentSummary summary;
+    size_t live = 0;
+    suite.Run("swap_chain/summarize", [&] {
+        live = 0;
+        g_SwapChainPresents.ForEach([&](const PresentStats& presents) {
+            summary = presents.Summarize();
+            live++;
+        });
+        DoNotOptimize(summary);
+    });
+    swapChain->Release();
+    g_SwapChainPresents.ForEach([&](const PresentStats&) { live++; });
+    fprintf(stderr,
+            "swap chain: %llu presents, %zu frames in window, present p50 %.0f ns, last sync interval %u flags %u; "
+            "%zu still listed after release\n",
+            (unsigned long long)summary.presents, summary.window, summary.costP50Ns,
+            (unsigned)summary.last.syncInterval, (unsigned)summary.last.flags, live - 1);
+
+    fakeOutput->Release();
+    realOutput->Release();
+    proxyFactory->Release();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchSuite suite("ls_addon_bench", argc, argv);
+    BenchLayout(suite);
+    BenchLogger(suite);
+    BenchProxies(suite);
+    return suite.Finish();
+}
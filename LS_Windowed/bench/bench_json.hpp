@@ -0,0 +1,105 @@
+#pragma once
+// Tiny benchmark runner for the JSON-emitting suites. Each case is calibrated
+// to run for about kTargetTime per repetition; the median ns/op over the
+// repetitions is reported. Human-readable lines go to stderr, the JSON document
+// to stdout or to the file passed with --out.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+template <class T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+    (void)*sink;
+#endif
+}
+
+class BenchSuite {
+public:
+    struct Result {
+        std::string name;
+        double nsPerOp;
+        uint64_t iterations;
+    };
+
+    BenchSuite(std::string name, int argc, char** argv) : m_name(std::move(name)) {
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) m_outPath = argv[++i];
+            else if (strcmp(argv[i], "--quick") == 0) m_targetTime = std::chrono::milliseconds(5);
+        }
+    }
+
+    template <class Fn>
+    void Run(const std::string& name, Fn&& fn) {
+        using Clock = std::chrono::steady_clock;
+
+        // Grow the batch until one batch takes a measurable share of the target
+        uint64_t batch = 1;
+        for (;;) {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < batch; i++) fn();
+            if (Clock::now() - start >= m_targetTime / 10 || batch >= (1ull << 30)) break;
+            batch *= 2;
+        }
+
+        std::vector<double> samples;
+        uint64_t iterations = 0;
+        for (int rep = 0; rep < kRepetitions; rep++) {
+            auto start = Clock::now();
+            uint64_t count = 0;
+            while (Clock::now() - start < m_targetTime) {
+                for (uint64_t i = 0; i < batch; i++) fn();
+                count += batch;
+            }
+            samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (double)count);
+            iterations += count;
+        }
+        std::sort(samples.begin(), samples.end());
+        Result result{name, samples[samples.size() / 2], iterations};
+        fprintf(stderr, "%-40s %10.2f ns/op  (%llu iterations)\n", name.c_str(), result.nsPerOp,
+                (unsigned long long)iterations);
+        m_results.push_back(result);
+    }
+
+    // Records a result measured by the caller (e.g. a multi-threaded run)
+    void Add(const std::string& name, double nsPerOp, uint64_t iterations) {
+        fprintf(stderr, "%-40s %10.2f ns/op  (%llu iterations)\n", name.c_str(), nsPerOp,
+                (unsigned long long)iterations);
+        m_results.push_back({name, nsPerOp, iterations});
+    }
+
+    bool Quick() const { return m_targetTime < std::chrono::milliseconds(100); }
+
+    // Returns the process exit code
+    int Finish() const {
+        FILE* out = m_outPath.empty() ? stdout : fopen(m_outPath.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "cannot write %s\n", m_outPath.c_str());
+            return 1;
+        }
+        fprintf(out, "{\n  \"suite\": \"%s\",\n  \"results\": [\n", m_name.c_str());
+        for (size_t i = 0; i < m_results.size(); i++) {
+            const Result& result = m_results[i];
+            fprintf(out, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"iterations\": %llu}%s\n", result.name.c_str(),
+                    result.nsPerOp, (unsigned long long)result.iterations, i + 1 < m_results.size() ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+        if (out != stdout) fclose(out);
+        return 0;
+    }
+
+private:
+    static constexpr int kRepetitions = 5;
+
+    std::string m_name;
+    std::string m_outPath;
+    std::chrono::nanoseconds m_targetTime = std::chrono::milliseconds(100);
+    std::vector<Result> m_results;
+};
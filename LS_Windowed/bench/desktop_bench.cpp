@@ -0,0 +1,264 @@
+// Drives the layout engine against the simulated desktop with scripted window
+// moves, the way the tracker would on Windows: every event raised by the
+// desktop goes through the relevance filter and a batch with at least one
+// relevant event triggers an Apply. Reports JSON like ls_addon_bench and then
+// replays a fixed script twice to check the run is deterministic.
+//
+//   ls_desktop_bench [--out results.json] [--quick]
+#include "bench_json.hpp"
+#include "layout_engine.hpp"
+#include "simulated_desktop.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr LayoutRect kMonitor0{0, 0, 2560, 1440};
+constexpr LayoutRect kMonitor1{2560, 0, 4480, 1080};
+
+// A desktop with a game, a few unrelated windows and the LS overlay, wired to
+// an engine the way main.cpp wires the tracker
+struct Scenario {
+    SimulatedDesktop desktop;
+    uint64_t publishes = 0;
+    LayoutEngine engine{desktop, [this](size_t, const LayoutGeometry&) { publishes++; }};
+    LayoutSettings settings;
+    std::vector<WindowEvent> pending;
+    WindowHandle game = 0;
+    WindowHandle browser = 0;
+    WindowHandle overlay = 0;
+    uint64_t applies = 0;
+
+    explicit Scenario(const LayoutSettings& layoutSettings) : settings(layoutSettings) {
+        desktop.SetEventSink([this](const WindowEvent& event) { pending.push_back(event); });
+        desktop.AddMonitor(kMonitor0);
+        desktop.AddMonitor(kMonitor1);
+        for (int i = 0; i < 8; i++) {
+            desktop.AddWindow({100 + i * 40, 100 + i * 30, 900 + i * 40, 700 + i * 30});
+        }
+        browser = desktop.AddWindow({2600, 40, 4400, 1040});
+        game = desktop.AddWindow({200, 150, 1496, 918});
+        desktop.SetForeground(game);
+        Pump();
+
+        // LS creates its borderless output window over the target's client area
+        LayoutRect client;
+        desktop.ClientRect(game, &client);
+        overlay = desktop.AddWindow(client, true, LayoutRect{});
+        Pump();
+    }
+
+    // One tracker wake-up: filter the queued events, apply once if any matter
+    void Pump() {
+        while (!pending.empty()) {
+            std::vector<WindowEvent> batch;
+            batch.swap(pending);
+            bool relevant = false;
+            for (const WindowEvent& event : batch) relevant |= engine.IsRelevant(event);
+            if (relevant) {
+                engine.Apply(settings);
+                applies++;
+            }
+        }
+    }
+
+    // Drags the game along a closed loop so long runs stay on screen
+    void Step(uint64_t step) {
+        static const int32_t kDx[] = {3, 0, -3, 0};
+        static const int32_t kDy[] = {0, 2, 0, -2};
+        int phase = (int)((step / 64) & 3);
+        desktop.OffsetWindow(game, kDx[phase], kDy[phase]);
+        desktop.Advance(std::chrono::milliseconds(1));
+        Pump();
+    }
+};
+
+LayoutSettings PositionSettings(int side) {
+    LayoutSettings settings;
+    settings.positionMode = true;
+    settings.positionSide = side;
+    return settings;
+}
+
+LayoutSettings SplitSettings(int type) {
+    LayoutSettings settings;
+    settings.splitMode = true;
+    settings.splitGrid = LegacySplitGrid(type, &settings.splitCell);
+    return settings;
+}
+
+void BenchScenarios(BenchSuite& suite) {
+    {
+        Scenario scenario(PositionSettings(1));
+        uint64_t step = 0;
+        suite.Run("desktop/position_follow_move", [&] { scenario.Step(step++); });
+        // Each step moves the game, then lets 1 ms of virtual time pass
+        // before the tracker wakes up, so every follow should take 1 ms
+        FollowSummary follow = scenario.engine.followLatency.Summarize();
+        fprintf(stderr, "position follow: %llu follows, p50 %.2f ms, max %.2f ms, %llu in place, %llu missed\n",
+                (unsigned long long)follow.follows, follow.p50Ns / 1e6, follow.maxNs / 1e6,
+                (unsigned long long)follow.inPlace, (unsigned long long)follow.missed);
+    }
+    {
+        Scenario scenario(SplitSettings(0));
+        uint64_t step = 0;
+        suite.Run("desktop/split_move", [&] { scenario.Step(step++); });
+    }
+    {
+        // Alternating focus between the game and an unrelated app
+        Scenario scenario(PositionSettings(0));
+        bool gameFocused = true;
+        suite.Run("desktop/foreground_switch", [&] {
+            gameFocused = !gameFocused;
+            scenario.desktop.SetForeground(gameFocused ? scenario.game : scenario.browser);
+            scenario.Pump();
+        });
+    }
+    {
+        // Moves of windows the engine ignores; measures the relevance filter
+        Scenario scenario(PositionSettings(1));
+        WindowHandle other = scenario.browser;
+        suite.Run("desktop/unrelated_move", [&] {
+            scenario.desktop.OffsetWindow(other, 1, 0);
+            scenario.desktop.OffsetWindow(other, -1, 0);
+            scenario.Pump();
+        });
+    }
+}
+
+// Several game clients side by side, each with its own LS overlay, tracked at
+// once (one per virtual display)
+struct MultiScenario {
+    SimulatedDesktop desktop;
+    LayoutEngine engine{desktop};
+    LayoutSettings settings;
+    std::vector<WindowEvent> pending;
+    std::vector<WindowHandle> games;
+    std::vector<WindowHandle> overlays;
+
+    MultiScenario(int clients, const LayoutSettings& layoutSettings) : settings(layoutSettings) {
+        settings.targetCount = clients;
+        desktop.SetEventSink([this](const WindowEvent& event) { pending.push_back(event); });
+        desktop.AddMonitor(kMonitor0);
+        for (int i = 0; i < 8; i++) desktop.AddWindow({100 + i * 40, 100 + i * 30, 900 + i * 40, 700 + i * 30});
+        for (int i = 0; i < clients; i++) {
+            int32_t left = 20 + (i % 2) * 1280, top = 20 + (i / 2) * 700;
+            games.push_back(desktop.AddWindow({left, top, left + 1200, top + 660}));
+            desktop.SetForeground(games.back());
+            Pump();
+        }
+        for (WindowHandle game : games) {
+            LayoutRect client;
+            desktop.ClientRect(game, &client);
+            overlays.push_back(desktop.AddWindow(client, true, LayoutRect{}));
+        }
+        Pump();
+    }
+
+    void Pump() {
+        while (!pending.empty()) {
+            std::vector<WindowEvent> batch;
+            batch.swap(pending);
+            bool relevant = false;
+            for (const WindowEvent& event : batch) relevant |= engine.IsRelevant(event);
+            if (relevant) engine.Apply(settings);
+        }
+    }
+
+    // Every client keeps its slot and its overlay
+    bool Stable() const {
+        for (size_t i = 0; i < games.size(); i++) {
+            if (engine.SlotOf(games[i]) != (int)i || engine.Overlay(i) != overlays[i]) return false;
+        }
+        return true;
+    }
+};
+
+void BenchMultiTarget(BenchSuite& suite) {
+    bool stable = true;
+    for (int clients : {1, 2, 4}) {
+        // One client moves per tick; the others are tracked but untouched
+        MultiScenario scenario(clients, PositionSettings(1));
+        uint64_t step = 0;
+        suite.Run("desktop/multi_target_move/" + std::to_string(clients), [&] {
+            WindowHandle game = scenario.games[step % scenario.games.size()];
+            int32_t dx = (step / scenario.games.size()) & 1 ? -2 : 2;
+            scenario.desktop.OffsetWindow(game, dx, 0);
+            scenario.Pump();
+            step++;
+        });
+        stable &= scenario.Stable();
+    }
+    {
+        // Alt-tabbing between tracked clients must not move anything
+        MultiScenario scenario(4, SplitSettings(0));
+        size_t focus = 0;
+        uint64_t movesBefore = 0;
+        for (WindowHandle overlay : scenario.overlays) movesBefore += scenario.desktop.Find(overlay)->moves;
+        suite.Run("desktop/multi_target_alt_tab", [&] {
+            focus = (focus + 1) % scenario.games.size();
+            scenario.desktop.SetForeground(scenario.games[focus]);
+            scenario.Pump();
+        });
+        uint64_t movesAfter = 0;
+        for (WindowHandle overlay : scenario.overlays) movesAfter += scenario.desktop.Find(overlay)->moves;
+        stable &= scenario.Stable() && movesAfter == movesBefore;
+    }
+    fprintf(stderr, "multi-target: %s\n", stable ? "slots and overlays stable" : "UNSTABLE");
+    if (!stable) exit(1);
+}
+
+// Runs a fixed mixed script and returns a digest of the final state, or 0 if
+// the overlay did not end up beside the game
+uint64_t RunScript(uint64_t* appliesOut) {
+    Scenario scenario(PositionSettings(1));
+    uint64_t digest = 14695981039346656037ull;
+    auto mix = [&](int64_t value) { digest = (digest ^ (uint64_t)value) * 1099511628211ull; };
+
+    for (uint64_t step = 0; step < 20000; step++) {
+        scenario.Step(step);
+        if (step % 1000 == 999) {
+            scenario.desktop.SetForeground(scenario.browser);
+            scenario.Pump();
+            scenario.desktop.SetForeground(scenario.game);
+            scenario.Pump();
+        }
+        if (step % 5000 == 4999) {
+            scenario.settings.positionSide = (scenario.settings.positionSide + 1) & 3;
+            scenario.engine.Apply(scenario.settings);
+        }
+        const LayoutGeometry& geometry = scenario.engine.Geometry();
+        mix(geometry.lsRect.left);
+        mix(geometry.lsRect.top);
+    }
+
+    const SimulatedDesktop::Window* overlay = scenario.desktop.Find(scenario.overlay);
+    LayoutRect gameWindow, gameClient;
+    scenario.desktop.WindowRect(scenario.game, &gameWindow);
+    scenario.desktop.ClientRect(scenario.game, &gameClient);
+    if (overlay->rect != PositionBesideTarget(gameWindow, gameClient, scenario.settings.positionSide)) return 0;
+
+    mix(overlay->rect.left);
+    mix(overlay->rect.top);
+    mix((int64_t)overlay->moves);
+    *appliesOut = scenario.applies;
+    return digest;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchSuite suite("ls_desktop_bench", argc, argv);
+    BenchScenarios(suite);
+    BenchMultiTarget(suite);
+
+    uint64_t applies1 = 0, applies2 = 0;
+    uint64_t first = RunScript(&applies1);
+    uint64_t second = RunScript(&applies2);
+    fprintf(stderr, "scripted run: %llu applies, digest %016llx (%s)\n", (unsigned long long)applies1,
+            (unsigned long long)first, first == second && applies1 == applies2 ? "deterministic" : "MISMATCH");
+    if (!first || first != second || applies1 != applies2) return 1;
+    return suite.Finish();
+}
@@ -0,0 +1,119 @@
+// Interface id classification as the proxies' QueryInterface does it: the
+// compile-time perfect-hash sets against the chains of GUID compares they
+// replaced, for the first and last id of a chain and for ids the proxy does not
+// implement (forwarded to the real object, the common case for a wrapper).
+// Both must agree on every known id; the tables must also match the SDK's ids
+// as the shim headers define them. A disagreement exits with 1.
+//
+//   ls_iid_bench [--out results.json] [--quick]
+#include "bench_json.hpp"
+#include "dxgi_proxy.hpp"
+#include "iid_table.hpp"
+#include "virtual_displays.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Defined by main.cpp in the DLL
+VirtualDisplays g_VirtualDisplays({{0, 0, 1920, 1080}, {0, 0, 1920, 1080}, nullptr, nullptr});
+
+namespace {
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+// The chains ProxyDXGIOutput::QueryInterface and ProxyDXGIFactory::QueryInterface used
+BENCH_NOINLINE bool OutputChain(REFIID riid) {
+    return riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIObject) || riid == __uuidof(IDXGIOutput) ||
+           riid == __uuidof(IDXGIOutput1) || riid == __uuidof(IDXGIOutput2) || riid == __uuidof(IDXGIOutput3) ||
+           riid == __uuidof(IDXGIOutput4) || riid == __uuidof(IDXGIOutput5) || riid == __uuidof(IDXGIOutput6);
+}
+
+BENCH_NOINLINE bool FactoryChain(REFIID riid) {
+    return riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIObject) || riid == __uuidof(IDXGIFactory) ||
+           riid == __uuidof(IDXGIFactory1) || riid == __uuidof(IDXGIFactory2) || riid == __uuidof(IDXGIFactory3) ||
+           riid == __uuidof(IDXGIFactory4) || riid == __uuidof(IDXGIFactory5) || riid == __uuidof(IDXGIFactory6);
+}
+
+BENCH_NOINLINE bool OutputTable(REFIID riid) { return kOutputIids.Contains(riid); }
+BENCH_NOINLINE bool FactoryTable(REFIID riid) { return kFactoryIids.Contains(riid); }
+
+GUID ToGuid(const IidKey& key) {
+    GUID guid;
+    std::memcpy(&guid, &key, sizeof(guid));
+    return guid;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchSuite suite("iid", argc, argv);
+    int failures = 0;
+
+    if (!CheckIidTables()) {
+        fprintf(stderr, "IID table does not match the SDK ids\n");
+        failures++;
+    }
+
+    // Misses: an interface no proxy implements, and an id that differs from
+    // IDXGIOutput6 in its last byte only (same hash slot)
+    GUID resource = __uuidof(IDXGIResource);
+    GUID nearOutput6 = __uuidof(IDXGIOutput6);
+    nearOutput6.Data4[7] ^= 1;
+
+    std::vector<GUID> probes = {resource, nearOutput6};
+    for (const DxgiIidInfo& info : kDxgiIids) probes.push_back(ToGuid(info.key));
+    for (const GUID& probe : probes) {
+        if (OutputChain(probe) != OutputTable(probe) || FactoryChain(probe) != FactoryTable(probe)) {
+            fprintf(stderr, "chain and table disagree on %08x\n", probe.Data1);
+            failures++;
+        }
+    }
+
+    struct Case {
+        const char* name;
+        GUID iid;
+    };
+    const Case cases[] = {
+        {"hit_first", __uuidof(IUnknown)},
+        {"hit_last", __uuidof(IDXGIOutput6)},
+        {"miss", resource},
+        {"miss_same_slot", nearOutput6},
+    };
+    for (const Case& c : cases) {
+        GUID iid = c.iid;
+        suite.Run(std::string("iid/output_chain/") + c.name, [&] {
+            DoNotOptimize(iid);
+            bool found = OutputChain(iid);
+            DoNotOptimize(found);
+        });
+        suite.Run(std::string("iid/output_table/") + c.name, [&] {
+            DoNotOptimize(iid);
+            bool found = OutputTable(iid);
+            DoNotOptimize(found);
+        });
+    }
+    GUID factoryMiss = resource;
+    suite.Run("iid/factory_chain/miss", [&] {
+        DoNotOptimize(factoryMiss);
+        bool found = FactoryChain(factoryMiss);
+        DoNotOptimize(found);
+    });
+    suite.Run("iid/factory_table/miss", [&] {
+        DoNotOptimize(factoryMiss);
+        bool found = FactoryTable(factoryMiss);
+        DoNotOptimize(found);
+    });
+    GUID named = __uuidof(IDXGIAdapter3);
+    suite.Run("iid/name_lookup", [&] {
+        DoNotOptimize(named);
+        const char* name = DxgiIidName(named);
+        DoNotOptimize(name);
+    });
+
+    int finish = suite.Finish();
+    return failures ? 1 : finish;
+}
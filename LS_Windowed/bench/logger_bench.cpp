@@ -0,0 +1,102 @@
+// Producer-side latency of LOG_INFO() under multi-thread contention: the binary
+// ring-buffer logger (both overflow policies) against the original synchronous
+// text logger (snprintf, global mutex, ofstream write and flush per line),
+// reimplemented here.
+#include "logger.hpp"
+#include "percentile.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int kMessagesPerThread = 20000;
+
+struct SyncLogger {
+    std::mutex mutex;
+    std::ofstream file;
+
+    void Log(const std::string& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        file << message << std::endl;
+        file.flush();
+    }
+};
+
+SyncLogger g_SyncLogger;
+
+template <class LogFn>
+std::vector<double> RunProducers(int threads, LogFn log) {
+    std::vector<std::vector<double>> perThread(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            std::vector<double>& samples = perThread[t];
+            samples.reserve(kMessagesPerThread);
+            for (int i = 0; i < kMessagesPerThread; i++) {
+                auto start = Clock::now();
+                log(t, i);
+                samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    std::vector<double> all;
+    for (auto& samples : perThread) all.insert(all.end(), samples.begin(), samples.end());
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+void Report(const char* name, int threads, const std::vector<double>& samples, uint64_t dropped) {
+    printf("logger/%-12s threads=%d p50=%8.0fns p99=%8.0fns p99.9=%9.0fns max=%10.0fns dropped=%llu\n", name, threads,
+           Percentile(samples, 0.5), Percentile(samples, 0.99), Percentile(samples, 0.999),
+           samples.empty() ? 0.0 : samples.back(), (unsigned long long)dropped);
+}
+
+void RunAsync(const char* name, LogOverflowPolicy policy, int threads, const std::filesystem::path& path) {
+    LoggerOptions options;
+    options.overflowPolicy = policy;
+    Logger::Init(path.wstring(), options);
+    auto samples = RunProducers(threads, [](int thread, int i) {
+        LOG_INFO("[LS_Windowed] ProxyDXGIOutput::GetDesc (FAKE) returning %dx%d @ (%d,%d) thread %d", 1920, 1080, i, i,
+                 thread);
+    });
+    uint64_t dropped = Logger::DroppedMessages();
+    Logger::Shutdown();
+    Logger::Close();
+    Report(name, threads, samples, dropped);
+}
+
+void RunSync(int threads, const std::filesystem::path& path) {
+    g_SyncLogger.file.open(path, std::ios::out | std::ios::trunc);
+    auto samples = RunProducers(threads, [](int thread, int i) {
+        char buffer[1024];
+        snprintf(buffer, sizeof(buffer), "[LS_Windowed] ProxyDXGIOutput::GetDesc (FAKE) returning %dx%d @ (%d,%d) thread %d",
+                 1920, 1080, i, i, thread);
+        g_SyncLogger.Log(std::string(buffer));
+    });
+    g_SyncLogger.file.close();
+    Report("sync-flush", threads, samples, 0);
+}
+
+} // namespace
+
+int main() {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "ls_logger_bench.binlog";
+    for (int threads : {1, 4}) {
+        RunSync(threads, path);
+        RunAsync("ring-drop", LogOverflowPolicy::Drop, threads, path);
+        RunAsync("ring-block", LogOverflowPolicy::Block, threads, path);
+    }
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,303 @@
+#pragma once
+// Minimal in-memory DXGI objects for driving the proxies in dxgi_proxy.cpp off
+// Windows. Objects live on the stack or in globals: reference counts are
+// tracked (atomically, so the mocks can be shared between threads) but never
+// free anything.
+#include <atomic>
+#include <dxgi1_6.h>
+
+class MockRefCounted {
+public:
+    ULONG AddRefImpl() { return ++m_refCount; }
+    ULONG ReleaseImpl() { return --m_refCount; }
+    ULONG RefCount() const { return m_refCount.load(); }
+
+private:
+    std::atomic<ULONG> m_refCount{1};
+};
+
+class MockDXGIOutput6 : public IDXGIOutput6, public MockRefCounted {
+public:
+    // rateCount limits the panel to its lowest rates (2: the two 60 Hz modes)
+    explicit MockDXGIOutput6(RECT desktop, UINT rateCount = 5) : m_desktop(desktop), m_rateCount(rateCount) {}
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override {
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIOutput) || riid == __uuidof(IDXGIOutput6)) {
+            *ppvObject = static_cast<IDXGIOutput6*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return AddRefImpl(); }
+    ULONG STDMETHODCALLTYPE Release() override { return ReleaseImpl(); }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetParent(REFIID, void**) override { return E_NOTIMPL; }
+
+    HRESULT STDMETHODCALLTYPE GetDesc(DXGI_OUTPUT_DESC* pDesc) override {
+        wcscpy_s(pDesc->DeviceName, 32, L"\\\\.\\DISPLAY1");
+        pDesc->DesktopCoordinates = m_desktop;
+        pDesc->AttachedToDesktop = TRUE;
+        pDesc->Rotation = DXGI_MODE_ROTATION_IDENTITY;
+        pDesc->Monitor = (HMONITOR)0x10001;
+        return S_OK;
+    }
+    // A 1440p high-refresh panel: two sizes at NTSC 60, 60, 120, 143.856 and 240 Hz
+    HRESULT STDMETHODCALLTYPE GetDisplayModeList(DXGI_FORMAT format, UINT, UINT* pNumModes, DXGI_MODE_DESC* pDesc) override {
+        static const UINT kSizes[][2] = {{1920, 1080}, {2560, 1440}};
+        static const UINT kRates[][2] = {{60000, 1001}, {60, 1}, {120, 1}, {143856, 1000}, {240, 1}};
+        const UINT count = 2 * m_rateCount;
+        if (!pDesc) {
+            *pNumModes = count;
+            return S_OK;
+        }
+        UINT copied = *pNumModes < count ? *pNumModes : count;
+        for (UINT i = 0; i < copied; i++) {
+            pDesc[i] = {};
+            pDesc[i].Width = kSizes[i / m_rateCount][0];
+            pDesc[i].Height = kSizes[i / m_rateCount][1];
+            pDesc[i].RefreshRate.Numerator = kRates[i % m_rateCount][0];
+            pDesc[i].RefreshRate.Denominator = kRates[i % m_rateCount][1];
+            pDesc[i].Format = format;
+        }
+        *pNumModes = copied;
+        return copied < count ? DXGI_ERROR_MORE_DATA : S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE FindClosestMatchingMode(const DXGI_MODE_DESC*, DXGI_MODE_DESC*, IUnknown*) override {
+        return E_NOTIMPL;
+    }
+    HRESULT STDMETHODCALLTYPE WaitForVBlank() override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE TakeOwnership(IUnknown*, BOOL) override { return E_NOTIMPL; }
+    void STDMETHODCALLTYPE ReleaseOwnership() override {}
+    HRESULT STDMETHODCALLTYPE GetGammaControlCapabilities(DXGI_GAMMA_CONTROL_CAPABILITIES*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetGammaControl(const DXGI_GAMMA_CONTROL*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetGammaControl(DXGI_GAMMA_CONTROL*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetDisplaySurface(IDXGISurface*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetDisplaySurfaceData(IDXGISurface*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetFrameStatistics(DXGI_FRAME_STATISTICS*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetDisplayModeList1(DXGI_FORMAT, UINT, UINT*, DXGI_MODE_DESC1*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE FindClosestMatchingMode1(const DXGI_MODE_DESC1*, DXGI_MODE_DESC1*, IUnknown*) override {
+        return E_NOTIMPL;
+    }
+    HRESULT STDMETHODCALLTYPE GetDisplaySurfaceData1(IDXGIResource*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE DuplicateOutput(IUnknown*, IDXGIOutputDuplication**) override { return E_NOTIMPL; }
+    BOOL STDMETHODCALLTYPE SupportsOverlays() override { return FALSE; }
+    HRESULT STDMETHODCALLTYPE CheckOverlaySupport(DXGI_FORMAT, IUnknown*, UINT*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE CheckOverlayColorSpaceSupport(DXGI_FORMAT, DXGI_COLOR_SPACE_TYPE, IUnknown*, UINT*) override {
+        return E_NOTIMPL;
+    }
+    HRESULT STDMETHODCALLTYPE DuplicateOutput1(IUnknown*, UINT, UINT, const DXGI_FORMAT*, IDXGIOutputDuplication**) override {
+        return E_NOTIMPL;
+    }
+    HRESULT STDMETHODCALLTYPE GetDesc1(DXGI_OUTPUT_DESC1*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE CheckHardwareCompositionSupport(UINT*) override { return E_NOTIMPL; }
+
+private:
+    RECT m_desktop;
+    UINT m_rateCount;
+};
+
+class MockDXGIAdapter4 : public IDXGIAdapter4, public MockRefCounted {
+public:
+    MockDXGIAdapter4(LUID luid, IDXGIOutput6* output) : m_luid(luid), m_output(output) {}
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override {
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIAdapter) || riid == __uuidof(IDXGIAdapter1) ||
+            riid == __uuidof(IDXGIAdapter2) || riid == __uuidof(IDXGIAdapter3) || riid == __uuidof(IDXGIAdapter4)) {
+            *ppvObject = static_cast<IDXGIAdapter4*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return AddRefImpl(); }
+    ULONG STDMETHODCALLTYPE Release() override { return ReleaseImpl(); }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetParent(REFIID, void**) override { return E_NOTIMPL; }
+
+    HRESULT STDMETHODCALLTYPE EnumOutputs(UINT Output, IDXGIOutput** ppOutput) override {
+        if (Output != 0 || !m_output) return DXGI_ERROR_NOT_FOUND;
+        *ppOutput = m_output;
+        m_output->AddRef();
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetDesc(DXGI_ADAPTER_DESC* pDesc) override { return FillDesc(pDesc); }
+    HRESULT STDMETHODCALLTYPE CheckInterfaceSupport(REFGUID, LARGE_INTEGER*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetDesc1(DXGI_ADAPTER_DESC1* pDesc) override { return FillDesc(pDesc); }
+    HRESULT STDMETHODCALLTYPE GetDesc2(DXGI_ADAPTER_DESC2* pDesc) override { return FillDesc(pDesc); }
+    HRESULT STDMETHODCALLTYPE RegisterHardwareContentProtectionTeardownStatusEvent(HANDLE, DWORD*) override {
+        return E_NOTIMPL;
+    }
+    void STDMETHODCALLTYPE UnregisterHardwareContentProtectionTeardownStatus(DWORD) override {}
+    HRESULT STDMETHODCALLTYPE QueryVideoMemoryInfo(UINT, DXGI_MEMORY_SEGMENT_GROUP, DXGI_QUERY_VIDEO_MEMORY_INFO*) override {
+        return E_NOTIMPL;
+    }
+    HRESULT STDMETHODCALLTYPE SetVideoMemoryReservation(UINT, DXGI_MEMORY_SEGMENT_GROUP, UINT64) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE RegisterVideoMemoryBudgetChangeNotificationEvent(HANDLE, DWORD*) override { return E_NOTIMPL; }
+    void STDMETHODCALLTYPE UnregisterVideoMemoryBudgetChangeNotification(DWORD) override {}
+    HRESULT STDMETHODCALLTYPE GetDesc3(DXGI_ADAPTER_DESC3* pDesc) override { return FillDesc(pDesc); }
+
+private:
+    HRESULT FillDesc(DXGI_ADAPTER_DESC* pDesc) {
+        *pDesc = {};
+        wcscpy_s(pDesc->Description, 128, L"Mock Adapter");
+        pDesc->AdapterLuid = m_luid;
+        return S_OK;
+    }
+
+    LUID m_luid;
+    IDXGIOutput6* m_output;
+};
+
+// Presents return at once; everything else is unimplemented
+class MockDXGISwapChain4 : public IDXGISwapChain4, public MockRefCounted {
+public:
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override {
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IDXGISwapChain) || riid == __uuidof(IDXGISwapChain1) ||
+            riid == __uuidof(IDXGISwapChain4)) {
+            *ppvObject = static_cast<IDXGISwapChain4*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return AddRefImpl(); }
+    ULONG STDMETHODCALLTYPE Release() override { return ReleaseImpl(); }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetParent(REFIID, void**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetDevice(REFIID, void**) override { return E_NOTIMPL; }
+
+    HRESULT STDMETHODCALLTYPE Present(UINT, UINT) override {
+        m_presents++;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetBuffer(UINT, REFIID, void**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetFullscreenState(BOOL, IDXGIOutput*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetFullscreenState(BOOL*, IDXGIOutput**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetDesc(DXGI_SWAP_CHAIN_DESC*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE ResizeBuffers(UINT, UINT, UINT, DXGI_FORMAT, UINT) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE ResizeTarget(const DXGI_MODE_DESC*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetContainingOutput(IDXGIOutput**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetFrameStatistics(DXGI_FRAME_STATISTICS*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetLastPresentCount(UINT* pLastPresentCount) override {
+        *pLastPresentCount = m_presents;
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE GetDesc1(DXGI_SWAP_CHAIN_DESC1*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetFullscreenDesc(DXGI_SWAP_CHAIN_FULLSCREEN_DESC*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetHwnd(HWND*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetCoreWindow(REFIID, void**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE Present1(UINT, UINT, const DXGI_PRESENT_PARAMETERS*) override {
+        m_presents++;
+        return S_OK;
+    }
+    BOOL STDMETHODCALLTYPE IsTemporaryMonoSupported() override { return FALSE; }
+    HRESULT STDMETHODCALLTYPE GetRestrictToOutput(IDXGIOutput**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetBackgroundColor(const DXGI_RGBA*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetBackgroundColor(DXGI_RGBA*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetRotation(DXGI_MODE_ROTATION) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetRotation(DXGI_MODE_ROTATION*) override { return E_NOTIMPL; }
+
+    HRESULT STDMETHODCALLTYPE SetSourceSize(UINT, UINT) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetSourceSize(UINT*, UINT*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetMaximumFrameLatency(UINT) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetMaximumFrameLatency(UINT*) override { return E_NOTIMPL; }
+    HANDLE STDMETHODCALLTYPE GetFrameLatencyWaitableObject() override { return nullptr; }
+    HRESULT STDMETHODCALLTYPE SetMatrixTransform(const DXGI_MATRIX_3X2_F*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetMatrixTransform(DXGI_MATRIX_3X2_F*) override { return E_NOTIMPL; }
+
+    UINT STDMETHODCALLTYPE GetCurrentBackBufferIndex() override { return 0; }
+    HRESULT STDMETHODCALLTYPE CheckColorSpaceSupport(DXGI_COLOR_SPACE_TYPE, UINT*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetColorSpace1(DXGI_COLOR_SPACE_TYPE) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE ResizeBuffers1(UINT, UINT, UINT, DXGI_FORMAT, UINT, const UINT*, IUnknown* const*) override {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetHDRMetaData(DXGI_HDR_METADATA_TYPE, UINT, void*) override { return E_NOTIMPL; }
+
+private:
+    UINT m_presents = 0;
+};
+
+class MockDXGIFactory6 : public IDXGIFactory6, public MockRefCounted {
+public:
+    MockDXGIFactory6(IDXGIAdapter4** adapters, UINT count, IDXGISwapChain4* swapChain = nullptr)
+        : m_adapters(adapters), m_count(count), m_swapChain(swapChain) {}
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID /*riid*/, void** ppvObject) override {
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return AddRefImpl(); }
+    ULONG STDMETHODCALLTYPE Release() override { return ReleaseImpl(); }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetParent(REFIID, void**) override { return E_NOTIMPL; }
+
+    HRESULT STDMETHODCALLTYPE EnumAdapters(UINT Adapter, IDXGIAdapter** ppAdapter) override {
+        if (Adapter >= m_count) return DXGI_ERROR_NOT_FOUND;
+        *ppAdapter = m_adapters[Adapter];
+        m_adapters[Adapter]->AddRef();
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE MakeWindowAssociation(HWND, UINT) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetWindowAssociation(HWND*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE CreateSwapChain(IUnknown*, DXGI_SWAP_CHAIN_DESC*, IDXGISwapChain**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE CreateSoftwareAdapter(HMODULE, IDXGIAdapter**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumAdapters1(UINT, IDXGIAdapter1**) override { return E_NOTIMPL; }
+    BOOL STDMETHODCALLTYPE IsCurrent() override { return TRUE; }
+    BOOL STDMETHODCALLTYPE IsWindowedStereoEnabled() override { return FALSE; }
+    HRESULT STDMETHODCALLTYPE CreateSwapChainForHwnd(IUnknown*, HWND, const DXGI_SWAP_CHAIN_DESC1*,
+                                                     const DXGI_SWAP_CHAIN_FULLSCREEN_DESC*, IDXGIOutput*,
+                                                     IDXGISwapChain1** ppSwapChain) override {
+        if (!m_swapChain) return E_NOTIMPL;
+        *ppSwapChain = m_swapChain;
+        m_swapChain->AddRef();
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE CreateSwapChainForCoreWindow(IUnknown*, IUnknown*, const DXGI_SWAP_CHAIN_DESC1*, IDXGIOutput*,
+                                                           IDXGISwapChain1**) override {
+        return E_NOTIMPL;
+    }
+    HRESULT STDMETHODCALLTYPE GetSharedResourceAdapterLuid(HANDLE, LUID*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE RegisterStereoStatusWindow(HWND, UINT, DWORD*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE RegisterStereoStatusEvent(HANDLE, DWORD*) override { return E_NOTIMPL; }
+    void STDMETHODCALLTYPE UnregisterStereoStatus(DWORD) override {}
+    HRESULT STDMETHODCALLTYPE RegisterOcclusionStatusWindow(HWND, UINT, DWORD*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE RegisterOcclusionStatusEvent(HANDLE, DWORD*) override { return E_NOTIMPL; }
+    void STDMETHODCALLTYPE UnregisterOcclusionStatus(DWORD) override {}
+    HRESULT STDMETHODCALLTYPE CreateSwapChainForComposition(IUnknown*, const DXGI_SWAP_CHAIN_DESC1*, IDXGIOutput*,
+                                                            IDXGISwapChain1** ppSwapChain) override {
+        if (!m_swapChain) return E_NOTIMPL;
+        *ppSwapChain = m_swapChain;
+        m_swapChain->AddRef();
+        return S_OK;
+    }
+    UINT STDMETHODCALLTYPE GetCreationFlags() override { return 0; }
+    HRESULT STDMETHODCALLTYPE EnumAdapterByLuid(LUID, REFIID, void**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumWarpAdapter(REFIID, void**) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE CheckFeatureSupport(DXGI_FEATURE, void*, UINT) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumAdapterByGpuPreference(UINT, DXGI_GPU_PREFERENCE, REFIID, void**) override {
+        return E_NOTIMPL;
+    }
+
+private:
+    IDXGIAdapter4** m_adapters;
+    UINT m_count;
+    IDXGISwapChain4* m_swapChain;
+};
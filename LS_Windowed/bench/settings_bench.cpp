@@ -0,0 +1,198 @@
+// Cost of reading the shared settings: an RcuCell snapshot against copying the
+// struct under a mutex, uncontended and while a writer publishes continuously.
+// Every published snapshot has all fields equal, so a reader that ever sees
+// two different values observed a torn update; the bench then exits with 1.
+// The config_sync cases replay a burst of panel edits against a real file in
+// the temp directory and check that it is written once and that an external
+// edit is reloaded while the addon's own write is not.
+//
+//   ls_settings_bench [--out results.json] [--quick]
+#include "bench_json.hpp"
+#include "config_sync.hpp"
+#include "grid_layout.hpp"
+#include "rcu_cell.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Shaped like the addon's Settings
+struct BenchSettings {
+    int splitMode = 0;
+    GridLayout splitGrid;
+    int splitCell = 0;
+    int positionMode = 0;
+    int positionSide = 0;
+    int vblankRate = 0;
+    int virtualDisplays = 0;
+
+    void Fill(int value) {
+        splitMode = splitCell = positionMode = positionSide = vblankRate = virtualDisplays = value;
+        splitGrid.columns = (uint8_t)value;
+    }
+
+    bool Consistent() const {
+        return splitCell == splitMode && positionMode == splitMode && positionSide == splitMode &&
+               vblankRate == splitMode && virtualDisplays == splitMode && splitGrid.columns == (uint8_t)splitMode;
+    }
+};
+
+struct ContendedResult {
+    double readNs;
+    uint64_t reads;
+    uint64_t publishes;
+    uint64_t torn;
+};
+
+// Readers check every snapshot while one writer keeps publishing new ones
+ContendedResult RunContended(RcuCell<BenchSettings>& cell, int readers, std::chrono::milliseconds duration) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> torn{0};
+    uint64_t publishes = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; t++) {
+        threads.emplace_back([&] {
+            uint64_t count = 0;
+            uint64_t bad = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto snapshot = cell.Read();
+                bad += !snapshot->Consistent();
+                count++;
+            }
+            reads.fetch_add(count);
+            torn.fetch_add(bad);
+        });
+    }
+    std::thread writer([&] {
+        int value = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            cell.Update([&](BenchSettings& settings) { settings.Fill(++value); });
+            publishes++;
+            std::this_thread::yield();
+        }
+    });
+
+    auto start = Clock::now();
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    writer.join();
+    for (auto& thread : threads) thread.join();
+    double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    uint64_t total = reads.load();
+    return {total ? elapsedNs * readers / (double)total : 0.0, total, publishes, torn.load()};
+}
+
+std::string ReadText(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Edits arriving every millisecond for a while, then an external edit.
+// Returns the number of failed checks.
+int RunConfigSync(BenchSuite& suite) {
+    namespace fs = std::filesystem;
+    fs::path path = fs::temp_directory_path() / "ls_settings_bench_config.ini";
+    {
+        std::ofstream out(path);
+        out << "[Settings]\nSplitMode=0\n";
+    }
+
+    std::atomic<int> value{0};
+    std::atomic<int> reloads{0};
+    ConfigSyncOptions options;
+    options.debounce = std::chrono::milliseconds(50);
+    options.maxDelay = std::chrono::milliseconds(1000);
+    options.pollInterval = std::chrono::milliseconds(20);
+    ConfigSync sync(
+        [&](const fs::path& temp) {
+            std::ofstream out(temp, std::ios::trunc);
+            out << "[Settings]\nSplitMode=" << value.load() << "\n";
+            return (bool)out;
+        },
+        [&] { reloads++; }, options);
+    sync.Open(path);
+    std::thread thread([&] { sync.Run(); });
+
+    const int kEdits = 200;
+    double markNs = 0.0;
+    for (int i = 0; i < kEdits; i++) {
+        value = i + 1;
+        auto start = Clock::now();
+        sync.MarkDirty();
+        markNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kEdits;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ConfigSyncStats burst = sync.GetStats();
+    std::string written = ReadText(path);
+
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "[Settings]\nSplitMode=0\nPositionMode=1\n";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    sync.Stop();
+    thread.join();
+    fs::remove(path);
+
+    suite.Add("config_sync/mark_dirty", markNs, kEdits);
+    fprintf(stderr, "  %d edits: %llu writes, %d reloads after the external edit\n", kEdits,
+            (unsigned long long)burst.writes, reloads.load());
+    int failures = 0;
+    // The burst outlasts maxDelay, so a write may fall inside it
+    if (burst.writes < 1 || burst.writes > 3) failures++;
+    if (written.find("SplitMode=" + std::to_string(kEdits) + "\n") == std::string::npos) failures++;
+    if (reloads.load() != 1) failures++;
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchSuite suite("settings", argc, argv);
+
+    RcuCell<BenchSettings> cell;
+    cell.Update([](BenchSettings& settings) { settings.Fill(1); });
+    suite.Run("settings/rcu_read", [&] {
+        auto snapshot = cell.Read();
+        DoNotOptimize(snapshot->positionMode);
+    });
+    suite.Run("settings/rcu_generation", [&] { DoNotOptimize(cell.Generation()); });
+
+    std::mutex mutex;
+    BenchSettings locked;
+    locked.Fill(1);
+    suite.Run("settings/mutex_copy", [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        BenchSettings copy = locked;
+        DoNotOptimize(copy);
+    });
+
+    int value = 1;
+    suite.Run("settings/rcu_publish", [&] { cell.Update([&](BenchSettings& settings) { settings.Fill(++value); }); });
+
+    int exitCode = 0;
+    auto duration = std::chrono::milliseconds(suite.Quick() ? 50 : 500);
+    for (int readers : {1, 4}) {
+        ContendedResult result = RunContended(cell, readers, duration);
+        suite.Add("settings/rcu_read_contended/" + std::to_string(readers), result.readNs, result.reads);
+        fprintf(stderr, "  %d reader(s): %llu publishes, %llu torn reads, %zu snapshots pending\n", readers,
+                (unsigned long long)result.publishes, (unsigned long long)result.torn, cell.PendingReclaim());
+        if (result.torn) exitCode = 1;
+    }
+
+    if (RunConfigSync(suite)) exitCode = 1;
+
+    int finish = suite.Finish();
+    return exitCode ? exitCode : finish;
+}
@@ -0,0 +1,98 @@
+// Drives TargetTracker with a scripted event source and compares the
+// event-driven schedule, with move events from every process and with moves
+// scoped to the target's process, against the 200 ms polling fallback:
+// wake-ups per minute (all of them, and those that led to an apply) and the
+// delay between a target move and the apply that picks it up.
+#include "percentile.hpp"
+#include "target_tracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uintptr_t kGameWindow = 0x1000;
+constexpr uintptr_t kOtherWindow = 0x2000;
+constexpr uint32_t kGameProcess = 100;
+constexpr uint32_t kOtherProcess = 200;
+
+struct ScenarioResult {
+    TrackerStats stats;
+    Clock::time_point end;
+    std::vector<double> latenciesUs;
+};
+
+ScenarioResult RunScenario(bool eventsAvailable, bool scopeMoves) {
+    SimulatedEventSource source(eventsAvailable);
+
+    // Time of the oldest target move not yet picked up by an apply (0 = none)
+    std::atomic<int64_t> pendingMoveNs{0};
+    std::mutex latencyMutex;
+    std::vector<double> latenciesUs;
+
+    auto apply = [&] {
+        if (scopeMoves) source.WatchMoves({kGameProcess});
+        int64_t moved = pendingMoveNs.exchange(0);
+        if (!moved) return;
+        int64_t now = Clock::now().time_since_epoch().count();
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        latenciesUs.push_back((now - moved) / 1000.0);
+    };
+    auto isRelevant = [](const WindowEvent& event) {
+        return event.type == WindowEventType::Foreground || event.window == kGameWindow;
+    };
+
+    TargetTracker tracker(source, apply, isRelevant);
+    std::thread worker([&] { tracker.Run(); });
+
+    // 1 s idle, 1 s of 60 Hz target drags with 250 Hz unrelated noise, 0.5 s idle
+    std::this_thread::sleep_for(1s);
+    auto dragEnd = Clock::now() + 1s;
+    int tick = 0;
+    while (Clock::now() < dragEnd) {
+        if (tick % 4 == 0) {
+            int64_t expected = 0;
+            pendingMoveNs.compare_exchange_strong(expected, Clock::now().time_since_epoch().count());
+            source.Emit(WindowEventType::MoveSize, kGameWindow, kGameProcess);
+        }
+        source.Emit(WindowEventType::MoveSize, kOtherWindow, kOtherProcess);
+        tick++;
+        std::this_thread::sleep_for(4ms);
+    }
+    std::this_thread::sleep_for(500ms);
+
+    ScenarioResult result;
+    result.end = Clock::now();
+    result.stats = tracker.GetStats();
+    tracker.Stop();
+    worker.join();
+
+    result.latenciesUs = std::move(latenciesUs);
+    std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+    return result;
+}
+
+void Report(const char* name, const ScenarioResult& result) {
+    const TrackerStats& stats = result.stats;
+    printf("tracker/%-13s wakeups/min=%8.1f applying/min=%8.1f applies=%4llu ignored=%4llu "
+           "move->apply p50=%8.1fus p99=%8.1fus max=%8.1fus\n",
+           name, stats.WakeupsPerMinute(result.end), stats.ApplyingWakeupsPerMinute(result.end),
+           (unsigned long long)stats.applies,
+           (unsigned long long)stats.ignoredEvents, Percentile(result.latenciesUs, 0.5),
+           Percentile(result.latenciesUs, 0.99), result.latenciesUs.empty() ? 0.0 : result.latenciesUs.back());
+}
+
+} // namespace
+
+int main() {
+    Report("events-global", RunScenario(true, false));
+    Report("events-scoped", RunScenario(true, true));
+    Report("polling", RunScenario(false, false));
+    return 0;
+}
@@ -0,0 +1,153 @@
+// Pacing accuracy of the virtual vblank clock. For each refresh rate the clock
+// is waited on for a run of frames and the wake-up lateness (time past the
+// vblank boundary) is reported as p50/p99/max, next to a naive loop that sleeps
+// one period per frame, which is what the fake output used to do. Lateness is
+// reported in the ns_per_op field.
+//
+//   ls_vblank_bench [--out results.json] [--quick]
+#include "bench_json.hpp"
+#include "vblank_clock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Lateness {
+    double p50 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+Lateness Summarize(std::vector<uint64_t> samples) {
+    std::sort(samples.begin(), samples.end());
+    Lateness lateness;
+    lateness.p50 = (double)samples[samples.size() / 2];
+    lateness.p99 = (double)samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    lateness.max = (double)samples.back();
+    return lateness;
+}
+
+void Report(BenchSuite& suite, const std::string& prefix, const Lateness& lateness, uint64_t frames) {
+    suite.Add(prefix + "/lateness_p50", lateness.p50, frames);
+    suite.Add(prefix + "/lateness_p99", lateness.p99, frames);
+    suite.Add(prefix + "/lateness_max", lateness.max, frames);
+}
+
+// Naive pacing against the same ideal timeline: sleep one period, whatever the
+// time already spent past the boundary
+Lateness RunNaiveSleep(uint64_t periodNs, int frames) {
+    std::vector<uint64_t> samples;
+    uint64_t start = VBlankClock::NowNs();
+    uint64_t boundary = start;
+    for (int i = 0; i < frames; i++) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(periodNs));
+        boundary += periodNs;
+        uint64_t now = VBlankClock::NowNs();
+        // Drift accumulates: compare with the nearest boundary at or before now
+        uint64_t behind = now >= boundary ? (now - boundary) % periodNs : 0;
+        samples.push_back(behind);
+        boundary = now - behind;
+    }
+    return Summarize(samples);
+}
+
+Lateness RunClock(VBlankClock& clock, int frames, uint64_t* missed) {
+    std::vector<uint64_t> samples;
+    clock.ResetStats();
+    for (int i = 0; i < frames; i++) {
+        uint64_t vblank = clock.Wait();
+        uint64_t now = VBlankClock::NowNs();
+        samples.push_back(now > vblank ? now - vblank : 0);
+    }
+    *missed = clock.Stats().missed;
+    return Summarize(samples);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchSuite suite("ls_vblank_bench", argc, argv);
+    const int seconds = suite.Quick() ? 0 : 1;
+    int exitCode = 0;
+
+    for (uint32_t hz : {60u, 144u, 240u}) {
+        uint64_t period = 1000000000ull / hz;
+        int frames = seconds ? (int)hz * seconds : 20;
+        std::string prefix = "vblank/" + std::to_string(hz) + "hz";
+
+        VBlankClock clock(period);
+        clock.Wait(); // Let the timer overshoot estimate settle on the first frame
+        uint64_t missed = 0;
+        Lateness paced = RunClock(clock, frames, &missed);
+        Report(suite, prefix + "/clock", paced, frames);
+
+        Lateness naive = RunNaiveSleep(period, frames);
+        Report(suite, prefix + "/naive_sleep", naive, frames);
+
+        VBlankStats stats = clock.Stats();
+        fprintf(stderr, "%3u Hz: clock p99 %.1f us (spin %.0f us, %llu missed), naive sleep p99 %.1f us\n", hz,
+                paced.p99 / 1000.0, stats.spinNs / 1000.0, (unsigned long long)missed, naive.p99 / 1000.0);
+        if (stats.waits != (uint64_t)frames) exitCode = 1;
+    }
+
+    // Phase lock: a reference in the future or the past yields the same grid
+    VBlankClock clock;
+    uint64_t now = VBlankClock::NowNs();
+    uint64_t period = 1000000000ull / 144;
+    clock.SetReference({now + 3 * period + 1234, period});
+    uint64_t ahead = clock.NextVBlank(now);
+    clock.SetReference({now - 5 * period + 1234, period});
+    uint64_t behind = clock.NextVBlank(now);
+    if (ahead != behind || ahead <= now || ahead > now + period) {
+        fprintf(stderr, "phase lock mismatch: %llu vs %llu\n", (unsigned long long)ahead, (unsigned long long)behind);
+        exitCode = 1;
+    }
+
+    // The vblank count stays continuous when the phase or the period changes
+    VBlankSample beforeShift = clock.LastVBlank(now);
+    clock.SetReference({now - 5 * period + 200000, period});
+    VBlankSample afterShift = clock.LastVBlank(now);
+    clock.SetPeriodOverride(1000000000ull / 75);
+    VBlankSample afterOverride = clock.LastVBlank(VBlankClock::NowNs());
+    VBlankSample nextOverride = clock.LastVBlank(afterOverride.timeNs + 1000000000ull / 75);
+    if (afterShift.count != beforeShift.count && afterShift.count != beforeShift.count + 1) exitCode = 1;
+    if (afterOverride.count < afterShift.count || nextOverride.count != afterOverride.count + 1) exitCode = 1;
+    if (exitCode) fprintf(stderr, "vblank count discontinuity\n");
+
+    // The compositor's last vblank predates a clock created just now; the
+    // count must not wrap below zero
+    VBlankClock fresh(period);
+    fresh.SetReference({VBlankClock::NowNs() - period * 3 / 4, period});
+    if (fresh.LastVBlank(VBlankClock::NowNs()).count > 1) {
+        fprintf(stderr, "vblank count wrapped below zero\n");
+        exitCode = 1;
+    }
+
+    // A resync that moves the phase about half a period later maps the new
+    // reference onto an earlier vblank, so the raw timeline steps back; the
+    // published count and time must not
+    VBlankClock resynced(period);
+    uint64_t origin = VBlankClock::NowNs();
+    resynced.SetReference({origin, period});
+    uint64_t query = origin + 10 * period + period / 5;
+    VBlankSample published = resynced.PublishedVBlank(query);
+    resynced.SetReference({origin + 5 * period - period * 55 / 100, period});
+    VBlankSample raw = resynced.LastVBlank(query);
+    VBlankSample held = resynced.PublishedVBlank(query);
+    VBlankSample later = resynced.PublishedVBlank(query + period);
+    bool monotonic = held.count >= published.count && held.timeNs >= published.timeNs &&
+                     later.count >= held.count && later.timeNs >= held.timeNs;
+    fprintf(stderr, "resync half a period late: raw count %llu -> %llu, published %llu -> %llu (%s)\n",
+            (unsigned long long)published.count, (unsigned long long)raw.count, (unsigned long long)published.count,
+            (unsigned long long)held.count, monotonic ? "monotonic" : "WENT BACKWARDS");
+    if (!monotonic || raw.count >= published.count) exitCode = 1;
+
+    suite.Run("vblank/next_vblank", [&] { DoNotOptimize(clock.NextVBlank(VBlankClock::NowNs())); });
+
+    int finish = suite.Finish();
+    return exitCode ? exitCode : finish;
+}
@@ -0,0 +1,34 @@
+#pragma once
+// DWM composition timing stand-in: reports a steady 60 Hz vblank timeline on
+// the QueryPerformanceCounter clock, like a single 60 Hz display would.
+#include "windows.h"
+
+typedef uint64_t QPC_TIME;
+typedef uint64_t DWM_FRAME_COUNT;
+
+typedef struct _UNSIGNED_RATIO {
+    UINT32 uiNumerator;
+    UINT32 uiDenominator;
+} UNSIGNED_RATIO;
+
+typedef struct _DWM_TIMING_INFO {
+    UINT32 cbSize;
+    UNSIGNED_RATIO rateRefresh;
+    QPC_TIME qpcRefreshPeriod;
+    UNSIGNED_RATIO rateCompose;
+    QPC_TIME qpcVBlank;
+    DWM_FRAME_COUNT cRefresh;
+} DWM_TIMING_INFO;
+
+inline HRESULT DwmGetCompositionTimingInfo(HWND, DWM_TIMING_INFO* info) {
+    if (!info || info->cbSize != sizeof(DWM_TIMING_INFO)) return E_INVALIDARG;
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    info->rateRefresh = {60, 1};
+    info->rateCompose = {60, 1};
+    info->qpcRefreshPeriod = (QPC_TIME)frequency.QuadPart / 60;
+    info->cRefresh = (QPC_TIME)counter.QuadPart / info->qpcRefreshPeriod;
+    info->qpcVBlank = info->cRefresh * info->qpcRefreshPeriod;
+    return S_OK;
+}
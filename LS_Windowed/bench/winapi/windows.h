@@ -0,0 +1,187 @@
+#pragma once
+// Thin Win32 stand-ins so the portable parts of the addon (and dxgi_proxy.cpp)
+// compile on non-Windows hosts for benchmarking. Only what the addon touches is
+// declared here; none of this is used by the real DLL build.
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <thread>
+
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef uint32_t DWORD;
+typedef unsigned int UINT;
+typedef uint32_t UINT32;
+typedef int INT;
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef int64_t INT64;
+typedef uint64_t UINT64;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t UINT_PTR;
+typedef size_t SIZE_T;
+typedef LONG_PTR LPARAM;
+typedef UINT_PTR WPARAM;
+typedef LONG_PTR LRESULT;
+typedef LONG HRESULT;
+typedef void* HANDLE;
+typedef wchar_t WCHAR;
+typedef char CHAR;
+typedef float FLOAT;
+typedef WCHAR OLECHAR;
+typedef const wchar_t* LPCWSTR;
+typedef const char* LPCSTR;
+typedef void* LPVOID;
+
+#define DECLARE_SHIM_HANDLE(name) struct name##__ { int unused; }; typedef struct name##__* name
+DECLARE_SHIM_HANDLE(HWND);
+DECLARE_SHIM_HANDLE(HMONITOR);
+DECLARE_SHIM_HANDLE(HDC);
+DECLARE_SHIM_HANDLE(HINSTANCE);
+DECLARE_SHIM_HANDLE(HRGN);
+typedef HINSTANCE HMODULE;
+#undef DECLARE_SHIM_HANDLE
+
+#define TRUE 1
+#define FALSE 0
+#define WINAPI
+#define CALLBACK
+#define APIENTRY
+#define STDMETHODCALLTYPE
+#define MAX_PATH 260
+#define CCHDEVICENAME 32
+
+typedef struct tagRECT {
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+} RECT, *LPRECT;
+typedef const RECT* LPCRECT;
+
+typedef struct tagPOINT {
+    LONG x;
+    LONG y;
+} POINT;
+
+typedef struct _LUID {
+    DWORD LowPart;
+    LONG HighPart;
+} LUID;
+
+typedef union _LARGE_INTEGER {
+    struct {
+        DWORD LowPart;
+        LONG HighPart;
+    };
+    INT64 QuadPart;
+} LARGE_INTEGER;
+
+typedef struct _GUID {
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t Data4[8];
+} GUID, IID, CLSID;
+typedef const GUID& REFGUID;
+typedef const IID& REFIID;
+typedef const CLSID& REFCLSID;
+
+inline bool operator==(const GUID& a, const GUID& b) { return std::memcmp(&a, &b, sizeof(GUID)) == 0; }
+inline bool operator!=(const GUID& a, const GUID& b) { return !(a == b); }
+
+typedef struct tagMONITORINFO {
+    DWORD cbSize;
+    RECT rcMonitor;
+    RECT rcWork;
+    DWORD dwFlags;
+} MONITORINFO, *LPMONITORINFO;
+
+typedef struct tagMONITORINFOEXW : tagMONITORINFO {
+    WCHAR szDevice[CCHDEVICENAME];
+} MONITORINFOEXW, *LPMONITORINFOEXW;
+
+typedef BOOL(CALLBACK* MONITORENUMPROC)(HMONITOR, HDC, LPRECT, LPARAM);
+
+// Display mode of a GDI device; only the fields the addon reads
+typedef struct _devicemodeW {
+    WORD dmSize;
+    DWORD dmPelsWidth;
+    DWORD dmPelsHeight;
+    DWORD dmDisplayFrequency;
+} DEVMODEW;
+
+#define ENUM_CURRENT_SETTINGS ((DWORD)-1)
+
+// Every display runs at 60 Hz, like the DWM stand-in in dwmapi.h
+inline BOOL EnumDisplaySettingsW(LPCWSTR, DWORD, DEVMODEW* mode) {
+    mode->dmPelsWidth = 1920;
+    mode->dmPelsHeight = 1080;
+    mode->dmDisplayFrequency = 60;
+    return TRUE;
+}
+
+#define S_OK ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define E_NOTIMPL ((HRESULT)0x80004001L)
+#define E_NOINTERFACE ((HRESULT)0x80004002L)
+#define E_POINTER ((HRESULT)0x80004003L)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define E_OUTOFMEMORY ((HRESULT)0x8007000EL)
+#define E_INVALIDARG ((HRESULT)0x80070057L)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+// __uuidof stand-in: every interface declared by the shim specialises ShimUuidOf.
+template <class T> struct ShimUuidOf;
+#define __uuidof(T) (ShimUuidOf<T>::value)
+#define SHIM_DEFINE_IID(T, l, w1, w2, b1, b2, b3, b4, b5, b6, b7, b8) \
+    struct T;                                                          \
+    template <> struct ShimUuidOf<T> {                                 \
+        static constexpr GUID value = {l, w1, w2, {b1, b2, b3, b4, b5, b6, b7, b8}}; \
+    }
+
+SHIM_DEFINE_IID(IUnknown, 0x00000000, 0x0000, 0x0000, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46);
+
+struct IUnknown {
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) = 0;
+    virtual ULONG STDMETHODCALLTYPE AddRef() = 0;
+    virtual ULONG STDMETHODCALLTYPE Release() = 0;
+    virtual ~IUnknown() = default;
+};
+
+inline ULONG InterlockedIncrement(ULONG* p) { return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST); }
+inline ULONG InterlockedDecrement(ULONG* p) { return __atomic_sub_fetch(p, 1, __ATOMIC_SEQ_CST); }
+inline LONG InterlockedIncrement(LONG* p) { return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST); }
+inline LONG InterlockedDecrement(LONG* p) { return __atomic_sub_fetch(p, 1, __ATOMIC_SEQ_CST); }
+
+inline void Sleep(DWORD ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+inline int wcscpy_s(wchar_t* dst, size_t count, const wchar_t* src) {
+    if (!dst || !count) return 22;
+    size_t n = std::wcslen(src);
+    if (n >= count) n = count - 1;
+    std::wmemcpy(dst, src, n);
+    dst[n] = L'\0';
+    return 0;
+}
+template <size_t N> inline int wcscpy_s(wchar_t (&dst)[N], const wchar_t* src) { return wcscpy_s(dst, N, src); }
+template <size_t N> inline int wcsncpy_s(wchar_t (&dst)[N], const wchar_t* src, size_t count) {
+    size_t n = std::wcslen(src);
+    if (n > count) n = count;
+    return wcscpy_s(dst, n + 1 <= N ? n + 1 : N, src);
+}
+
+inline BOOL QueryPerformanceCounter(LARGE_INTEGER* value) {
+    value->QuadPart = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return TRUE;
+}
+inline BOOL QueryPerformanceFrequency(LARGE_INTEGER* value) {
+    value->QuadPart = 1000000000LL;
+    return TRUE;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+// Building blocks for COM proxies. A proxy derives from ComProxy<Self,
+// Interface> through forwarder templates that implement every method of an
+// interface family by calling the same method on Self::Real(); the proxy then
+// overrides just the methods it changes. Everything is resolved at compile
+// time, so a forwarded call costs what a hand-written one-line forwarder did.
+//
+// The Policy slot wraps every forwarded call: Policy::Scope<&Interface::Method>
+// is constructed before the call and destroyed after it. NoCallPolicy compiles
+// to nothing; a policy can time or count methods, each method getting its own
+// Scope instantiation.
+
+struct NoCallPolicy {
+    template <auto Method>
+    struct Scope {};
+};
+
+// Counts the calls to each forwarded method. For debugging and benchmarks.
+struct CallCountPolicy {
+    template <auto Method>
+    struct Scope {
+        Scope() { Calls().fetch_add(1, std::memory_order_relaxed); }
+
+        static std::atomic<uint64_t>& Calls() {
+            static std::atomic<uint64_t> calls{0};
+            return calls;
+        }
+    };
+
+    template <auto Method>
+    static uint64_t Calls() {
+        return Scope<Method>::Calls().load(std::memory_order_relaxed);
+    }
+};
+
+// IUnknown for a proxy: reference counting, and QueryInterface answering
+// Self::kIids (an IidSet) with the proxy itself. Other interfaces go to
+// Self::QueryOther, which by default asks the wrapped object.
+template <class Self, class Interface, class Policy = NoCallPolicy>
+class ComProxy : public Interface {
+public:
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override {
+        if (!ppvObject) return E_POINTER;
+        if (Self::kIids.Contains(riid)) {
+            *ppvObject = static_cast<Interface*>(this);
+            AddRef();
+            return S_OK;
+        }
+        return Derived()->QueryOther(riid, ppvObject);
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override { return InterlockedIncrement(&m_refCount); }
+
+    ULONG STDMETHODCALLTYPE Release() override {
+        ULONG ref = InterlockedDecrement(&m_refCount);
+        if (ref == 0) delete Derived();
+        return ref;
+    }
+
+protected:
+    HRESULT QueryOther(REFIID riid, void** ppvObject) { return Derived()->Real()->QueryInterface(riid, ppvObject); }
+
+    template <auto Method, class... Args>
+    decltype(auto) Forward(Args&&... args) {
+        [[maybe_unused]] typename Policy::template Scope<Method> scope;
+        return (Derived()->Real()->*Method)(std::forward<Args>(args)...);
+    }
+
+    Self* Derived() { return static_cast<Self*>(this); }
+
+private:
+    ULONG m_refCount = 1;
+};
+
+// Declares a forwarder inside a forwarder template whose most derived
+// interface is named Interface
+#define LS_FORWARD(Ret, Method, Params, Args)                          \
+    Ret STDMETHODCALLTYPE Method Params override {                     \
+        return this->template Forward<&Interface::Method> Args;        \
+    }
@@ -0,0 +1,125 @@
+#include "config_sync.hpp"
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+ConfigSync::ConfigSync(SaveFn save, ReloadFn reload, ConfigSyncOptions options)
+    : m_save(std::move(save)), m_reload(std::move(reload)), m_options(options) {}
+
+void ConfigSync::Open(const fs::path& path) {
+    std::lock_guard<std::mutex> file(m_fileMutex);
+    m_path = path;
+    m_knownStamp = ReadStamp();
+}
+
+void ConfigSync::Run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Clock::time_point nextPoll = Clock::now() + m_options.pollInterval;
+    while (m_running) {
+        m_cv.wait_until(lock, m_dirty ? std::min(nextPoll, DueTime()) : nextPoll);
+        if (!m_running) break;
+
+        Clock::time_point now = Clock::now();
+        bool due = m_dirty && now >= DueTime();
+        bool poll = now >= nextPoll;
+        if (!due && !poll) continue; // Early, or the deadline moved: wait again
+        lock.unlock();
+        if (due) Flush();
+        if (poll) CheckExternalEdit();
+        lock.lock();
+        if (poll) nextPoll = Clock::now() + m_options.pollInterval;
+    }
+}
+
+void ConfigSync::Stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = false;
+    m_cv.notify_all();
+}
+
+void ConfigSync::MarkDirty() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Clock::time_point now = Clock::now();
+    m_lastChange = now;
+    m_stats.changes++;
+    if (m_dirty) return; // Deadlines only move later; the thread rechecks when it wakes
+    m_firstChange = now;
+    m_dirty = true;
+    m_cv.notify_all();
+}
+
+void ConfigSync::Flush() {
+    std::lock_guard<std::mutex> file(m_fileMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_dirty || m_path.empty()) return;
+        // Cleared first: a change arriving during the write marks it again.
+        // The save callback reads the latest settings, so it may already be in.
+        m_dirty = false;
+    }
+
+    bool written = ReplaceFile();
+    FileStamp stamp = ReadStamp();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (written) {
+        m_knownStamp = stamp;
+        m_stats.writes++;
+    } else {
+        m_stats.failedWrites++;
+        if (!m_dirty) m_firstChange = m_lastChange = Clock::now(); // Retry after a debounce window
+        m_dirty = true;
+    }
+}
+
+ConfigSyncStats ConfigSync::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+ConfigSync::FileStamp ConfigSync::ReadStamp() const {
+    FileStamp stamp;
+    std::error_code error;
+    stamp.time = fs::last_write_time(m_path, error);
+    if (error) return stamp;
+    stamp.size = fs::file_size(m_path, error);
+    stamp.exists = !error;
+    return stamp;
+}
+
+ConfigSync::Clock::time_point ConfigSync::DueTime() const {
+    return std::min(m_lastChange + m_options.debounce, m_firstChange + m_options.maxDelay);
+}
+
+bool ConfigSync::ReplaceFile() {
+    std::error_code error;
+    fs::path temp = m_path;
+    temp += ".tmp";
+    fs::remove(temp, error);
+    if (fs::exists(m_path, error)) {
+        fs::copy_file(m_path, temp, fs::copy_options::overwrite_existing, error);
+        if (error) return false;
+    }
+    if (m_save(temp)) {
+        fs::rename(temp, m_path, error);
+        if (!error) return true;
+    }
+    fs::remove(temp, error);
+    return false;
+}
+
+void ConfigSync::CheckExternalEdit() {
+    std::lock_guard<std::mutex> file(m_fileMutex);
+    if (m_path.empty()) return;
+    FileStamp stamp = ReadStamp();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (stamp == m_knownStamp) return;
+        m_knownStamp = stamp;
+        // A deleted file is recreated by the next write; unsaved changes from
+        // the panel are newer than the edit and overwrite it shortly
+        if (!stamp.exists || m_dirty) return;
+        m_stats.reloads++;
+    }
+    m_reload();
+}
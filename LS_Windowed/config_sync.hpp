@@ -0,0 +1,90 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+
+struct ConfigSyncOptions {
+    // Changes are written once none arrived for debounce, and at the latest
+    // maxDelay after the first unsaved one.
+    std::chrono::milliseconds debounce{500};
+    std::chrono::milliseconds maxDelay{2000};
+    // How often the file is checked for edits made by something else.
+    std::chrono::milliseconds pollInterval{1000};
+};
+
+struct ConfigSyncStats {
+    uint64_t changes = 0;      // MarkDirty() calls
+    uint64_t writes = 0;       // Times the file was replaced
+    uint64_t failedWrites = 0; // Writes that failed and will be retried
+    uint64_t reloads = 0;      // External edits handed to the reload callback
+};
+
+// Keeps a config file and the in-memory settings in step from a thread of its
+// own. Changes are coalesced and written at most once per debounce window: the
+// save callback fills a copy of the file, which is then renamed over the
+// original, so other readers never see it half-written and keys the callback
+// does not touch survive. Edits made by anything else (a text editor) are
+// noticed by polling the file's size and modification time and handed to the
+// reload callback; the addon's own writes are not reported back.
+class ConfigSync {
+public:
+    // Writes the latest settings into the file at path. Returns false on failure.
+    using SaveFn = std::function<bool(const std::filesystem::path& path)>;
+    // Reads the settings back after an external edit.
+    using ReloadFn = std::function<void()>;
+
+    ConfigSync(SaveFn save, ReloadFn reload, ConfigSyncOptions options = {});
+
+    // Sets the file to keep in step. Call once, before Run(), after the
+    // settings were first loaded from it.
+    void Open(const std::filesystem::path& path);
+
+    // Blocks on the calling thread until Stop() is called.
+    void Run();
+
+    // Thread-safe.
+    void Stop();
+    void MarkDirty();
+    // Writes a pending change now, on the calling thread.
+    void Flush();
+    ConfigSyncStats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct FileStamp {
+        bool exists = false;
+        uintmax_t size = 0;
+        std::filesystem::file_time_type time;
+
+        bool operator==(const FileStamp& other) const {
+            return exists == other.exists && size == other.size && time == other.time;
+        }
+        bool operator!=(const FileStamp& other) const { return !(*this == other); }
+    };
+
+    FileStamp ReadStamp() const;
+    Clock::time_point DueTime() const;
+    bool ReplaceFile();
+    void CheckExternalEdit();
+
+    SaveFn m_save;
+    ReloadFn m_reload;
+    ConfigSyncOptions m_options;
+
+    // Serializes writes and reloads; taken before m_mutex
+    std::mutex m_fileMutex;
+    std::filesystem::path m_path;
+    FileStamp m_knownStamp; // Last state of the file we wrote or loaded
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_running = true;
+    bool m_dirty = false;
+    Clock::time_point m_firstChange;
+    Clock::time_point m_lastChange;
+    ConfigSyncStats m_stats;
+};
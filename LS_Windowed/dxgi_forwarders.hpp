@@ -0,0 +1,221 @@
+#pragma once
+#include <dxgi.h>
+#include <dxgi1_6.h>
+#include "com_proxy.hpp"
+
+// Forwarders for the DXGI interface families the addon wraps. Each implements
+// the newest interface of its family by passing every call to Self::Real(), a
+// pointer to the same interface on the wrapped object.
+
+template <class Self, class Interface, class Policy>
+class DXGIObjectForwarder : public ComProxy<Self, Interface, Policy> {
+public:
+    LS_FORWARD(HRESULT, SetPrivateData, (REFGUID Name, UINT DataSize, const void* pData), (Name, DataSize, pData))
+    LS_FORWARD(HRESULT, SetPrivateDataInterface, (REFGUID Name, const IUnknown* pUnknown), (Name, pUnknown))
+    LS_FORWARD(HRESULT, GetPrivateData, (REFGUID Name, UINT* pDataSize, void* pData), (Name, pDataSize, pData))
+    LS_FORWARD(HRESULT, GetParent, (REFIID riid, void** ppParent), (riid, ppParent))
+};
+
+template <class Self, class Policy = NoCallPolicy, class Interface = IDXGIFactory6>
+class DXGIFactoryForwarder : public DXGIObjectForwarder<Self, Interface, Policy> {
+public:
+    // IDXGIFactory
+    LS_FORWARD(HRESULT, EnumAdapters, (UINT Adapter, IDXGIAdapter** ppAdapter), (Adapter, ppAdapter))
+    LS_FORWARD(HRESULT, MakeWindowAssociation, (HWND WindowHandle, UINT Flags), (WindowHandle, Flags))
+    LS_FORWARD(HRESULT, GetWindowAssociation, (HWND* pWindowHandle), (pWindowHandle))
+    LS_FORWARD(HRESULT, CreateSwapChain, (IUnknown* pDevice, DXGI_SWAP_CHAIN_DESC* pDesc, IDXGISwapChain** ppSwapChain),
+               (pDevice, pDesc, ppSwapChain))
+    LS_FORWARD(HRESULT, CreateSoftwareAdapter, (HMODULE Module, IDXGIAdapter** ppAdapter), (Module, ppAdapter))
+
+    // IDXGIFactory1
+    LS_FORWARD(HRESULT, EnumAdapters1, (UINT Adapter, IDXGIAdapter1** ppAdapter), (Adapter, ppAdapter))
+    LS_FORWARD(BOOL, IsCurrent, (), ())
+
+    // IDXGIFactory2
+    LS_FORWARD(BOOL, IsWindowedStereoEnabled, (), ())
+    LS_FORWARD(HRESULT, CreateSwapChainForHwnd,
+               (IUnknown* pDevice, HWND hWnd, const DXGI_SWAP_CHAIN_DESC1* pDesc,
+                const DXGI_SWAP_CHAIN_FULLSCREEN_DESC* pFullscreenDesc, IDXGIOutput* pRestrictToOutput,
+                IDXGISwapChain1** ppSwapChain),
+               (pDevice, hWnd, pDesc, pFullscreenDesc, pRestrictToOutput, ppSwapChain))
+    LS_FORWARD(HRESULT, CreateSwapChainForCoreWindow,
+               (IUnknown* pDevice, IUnknown* pWindow, const DXGI_SWAP_CHAIN_DESC1* pDesc, IDXGIOutput* pRestrictToOutput,
+                IDXGISwapChain1** ppSwapChain),
+               (pDevice, pWindow, pDesc, pRestrictToOutput, ppSwapChain))
+    LS_FORWARD(HRESULT, GetSharedResourceAdapterLuid, (HANDLE hResource, LUID* pLuid), (hResource, pLuid))
+    LS_FORWARD(HRESULT, RegisterStereoStatusWindow, (HWND WindowHandle, UINT wMsg, DWORD* pdwCookie),
+               (WindowHandle, wMsg, pdwCookie))
+    LS_FORWARD(HRESULT, RegisterStereoStatusEvent, (HANDLE hEvent, DWORD* pdwCookie), (hEvent, pdwCookie))
+    LS_FORWARD(void, UnregisterStereoStatus, (DWORD dwCookie), (dwCookie))
+    LS_FORWARD(HRESULT, RegisterOcclusionStatusWindow, (HWND WindowHandle, UINT wMsg, DWORD* pdwCookie),
+               (WindowHandle, wMsg, pdwCookie))
+    LS_FORWARD(HRESULT, RegisterOcclusionStatusEvent, (HANDLE hEvent, DWORD* pdwCookie), (hEvent, pdwCookie))
+    LS_FORWARD(void, UnregisterOcclusionStatus, (DWORD dwCookie), (dwCookie))
+    LS_FORWARD(HRESULT, CreateSwapChainForComposition,
+               (IUnknown* pDevice, const DXGI_SWAP_CHAIN_DESC1* pDesc, IDXGIOutput* pRestrictToOutput,
+                IDXGISwapChain1** ppSwapChain),
+               (pDevice, pDesc, pRestrictToOutput, ppSwapChain))
+
+    // IDXGIFactory3
+    LS_FORWARD(UINT, GetCreationFlags, (), ())
+
+    // IDXGIFactory4
+    LS_FORWARD(HRESULT, EnumAdapterByLuid, (LUID AdapterLuid, REFIID riid, void** ppvAdapter),
+               (AdapterLuid, riid, ppvAdapter))
+    LS_FORWARD(HRESULT, EnumWarpAdapter, (REFIID riid, void** ppvAdapter), (riid, ppvAdapter))
+
+    // IDXGIFactory5
+    LS_FORWARD(HRESULT, CheckFeatureSupport, (DXGI_FEATURE Feature, void* pFeatureSupportData, UINT FeatureSupportDataSize),
+               (Feature, pFeatureSupportData, FeatureSupportDataSize))
+
+    // IDXGIFactory6
+    LS_FORWARD(HRESULT, EnumAdapterByGpuPreference,
+               (UINT Adapter, DXGI_GPU_PREFERENCE GpuPreference, REFIID riid, void** ppvAdapter),
+               (Adapter, GpuPreference, riid, ppvAdapter))
+};
+
+template <class Self, class Policy = NoCallPolicy, class Interface = IDXGIAdapter4>
+class DXGIAdapterForwarder : public DXGIObjectForwarder<Self, Interface, Policy> {
+public:
+    // IDXGIAdapter
+    LS_FORWARD(HRESULT, EnumOutputs, (UINT Output, IDXGIOutput** ppOutput), (Output, ppOutput))
+    LS_FORWARD(HRESULT, GetDesc, (DXGI_ADAPTER_DESC* pDesc), (pDesc))
+    LS_FORWARD(HRESULT, CheckInterfaceSupport, (REFGUID InterfaceName, LARGE_INTEGER* pUMDVersion),
+               (InterfaceName, pUMDVersion))
+
+    // IDXGIAdapter1
+    LS_FORWARD(HRESULT, GetDesc1, (DXGI_ADAPTER_DESC1* pDesc), (pDesc))
+
+    // IDXGIAdapter2
+    LS_FORWARD(HRESULT, GetDesc2, (DXGI_ADAPTER_DESC2* pDesc), (pDesc))
+
+    // IDXGIAdapter3
+    LS_FORWARD(HRESULT, RegisterHardwareContentProtectionTeardownStatusEvent, (HANDLE hEvent, DWORD* pdwCookie),
+               (hEvent, pdwCookie))
+    LS_FORWARD(void, UnregisterHardwareContentProtectionTeardownStatus, (DWORD dwCookie), (dwCookie))
+    LS_FORWARD(HRESULT, QueryVideoMemoryInfo,
+               (UINT NodeIndex, DXGI_MEMORY_SEGMENT_GROUP MemorySegmentGroup,
+                DXGI_QUERY_VIDEO_MEMORY_INFO* pVideoMemoryInfo),
+               (NodeIndex, MemorySegmentGroup, pVideoMemoryInfo))
+    LS_FORWARD(HRESULT, SetVideoMemoryReservation,
+               (UINT NodeIndex, DXGI_MEMORY_SEGMENT_GROUP MemorySegmentGroup, UINT64 Reservation),
+               (NodeIndex, MemorySegmentGroup, Reservation))
+    LS_FORWARD(HRESULT, RegisterVideoMemoryBudgetChangeNotificationEvent, (HANDLE hEvent, DWORD* pdwCookie),
+               (hEvent, pdwCookie))
+    LS_FORWARD(void, UnregisterVideoMemoryBudgetChangeNotification, (DWORD dwCookie), (dwCookie))
+
+    // IDXGIAdapter4
+    LS_FORWARD(HRESULT, GetDesc3, (DXGI_ADAPTER_DESC3* pDesc), (pDesc))
+};
+
+template <class Self, class Policy = NoCallPolicy, class Interface = IDXGIOutput6>
+class DXGIOutputForwarder : public DXGIObjectForwarder<Self, Interface, Policy> {
+public:
+    // IDXGIOutput
+    LS_FORWARD(HRESULT, GetDesc, (DXGI_OUTPUT_DESC* pDesc), (pDesc))
+    LS_FORWARD(HRESULT, GetDisplayModeList, (DXGI_FORMAT EnumFormat, UINT Flags, UINT* pNumModes, DXGI_MODE_DESC* pDesc),
+               (EnumFormat, Flags, pNumModes, pDesc))
+    LS_FORWARD(HRESULT, FindClosestMatchingMode,
+               (const DXGI_MODE_DESC* pModeToMatch, DXGI_MODE_DESC* pClosestMatch, IUnknown* pConcernedDevice),
+               (pModeToMatch, pClosestMatch, pConcernedDevice))
+    LS_FORWARD(HRESULT, WaitForVBlank, (), ())
+    LS_FORWARD(HRESULT, TakeOwnership, (IUnknown* pDevice, BOOL Exclusive), (pDevice, Exclusive))
+    LS_FORWARD(void, ReleaseOwnership, (), ())
+    LS_FORWARD(HRESULT, GetGammaControlCapabilities, (DXGI_GAMMA_CONTROL_CAPABILITIES* pGammaCaps), (pGammaCaps))
+    LS_FORWARD(HRESULT, SetGammaControl, (const DXGI_GAMMA_CONTROL* pArray), (pArray))
+    LS_FORWARD(HRESULT, GetGammaControl, (DXGI_GAMMA_CONTROL* pArray), (pArray))
+    LS_FORWARD(HRESULT, SetDisplaySurface, (IDXGISurface* pScanoutSurface), (pScanoutSurface))
+    LS_FORWARD(HRESULT, GetDisplaySurfaceData, (IDXGISurface* pDestination), (pDestination))
+    LS_FORWARD(HRESULT, GetFrameStatistics, (DXGI_FRAME_STATISTICS* pStats), (pStats))
+
+    // IDXGIOutput1
+    LS_FORWARD(HRESULT, GetDisplayModeList1,
+               (DXGI_FORMAT EnumFormat, UINT Flags, UINT* pNumModes, DXGI_MODE_DESC1* pDesc),
+               (EnumFormat, Flags, pNumModes, pDesc))
+    LS_FORWARD(HRESULT, FindClosestMatchingMode1,
+               (const DXGI_MODE_DESC1* pModeToMatch, DXGI_MODE_DESC1* pClosestMatch, IUnknown* pConcernedDevice),
+               (pModeToMatch, pClosestMatch, pConcernedDevice))
+    LS_FORWARD(HRESULT, GetDisplaySurfaceData1, (IDXGIResource* pDestination), (pDestination))
+    LS_FORWARD(HRESULT, DuplicateOutput, (IUnknown* pDevice, IDXGIOutputDuplication** ppOutputDuplication),
+               (pDevice, ppOutputDuplication))
+
+    // IDXGIOutput2
+    LS_FORWARD(BOOL, SupportsOverlays, (), ())
+
+    // IDXGIOutput3
+    LS_FORWARD(HRESULT, CheckOverlaySupport, (DXGI_FORMAT EnumFormat, IUnknown* pConcernedDevice, UINT* pFlags),
+               (EnumFormat, pConcernedDevice, pFlags))
+
+    // IDXGIOutput4
+    LS_FORWARD(HRESULT, CheckOverlayColorSpaceSupport,
+               (DXGI_FORMAT Format, DXGI_COLOR_SPACE_TYPE ColorSpace, IUnknown* pConcernedDevice, UINT* pFlags),
+               (Format, ColorSpace, pConcernedDevice, pFlags))
+
+    // IDXGIOutput5
+    LS_FORWARD(HRESULT, DuplicateOutput1,
+               (IUnknown* pDevice, UINT Flags, UINT SupportedFormatsCount, const DXGI_FORMAT* pSupportedFormats,
+                IDXGIOutputDuplication** ppOutputDuplication),
+               (pDevice, Flags, SupportedFormatsCount, pSupportedFormats, ppOutputDuplication))
+
+    // IDXGIOutput6
+    LS_FORWARD(HRESULT, GetDesc1, (DXGI_OUTPUT_DESC1* pDesc), (pDesc))
+    LS_FORWARD(HRESULT, CheckHardwareCompositionSupport, (UINT* pFlags), (pFlags))
+};
+
+template <class Self, class Policy = NoCallPolicy, class Interface = IDXGISwapChain4>
+class DXGISwapChainForwarder : public DXGIObjectForwarder<Self, Interface, Policy> {
+public:
+    // IDXGIDeviceSubObject
+    LS_FORWARD(HRESULT, GetDevice, (REFIID riid, void** ppDevice), (riid, ppDevice))
+
+    // IDXGISwapChain
+    LS_FORWARD(HRESULT, Present, (UINT SyncInterval, UINT Flags), (SyncInterval, Flags))
+    LS_FORWARD(HRESULT, GetBuffer, (UINT Buffer, REFIID riid, void** ppSurface), (Buffer, riid, ppSurface))
+    LS_FORWARD(HRESULT, SetFullscreenState, (BOOL Fullscreen, IDXGIOutput* pTarget), (Fullscreen, pTarget))
+    LS_FORWARD(HRESULT, GetFullscreenState, (BOOL* pFullscreen, IDXGIOutput** ppTarget), (pFullscreen, ppTarget))
+    LS_FORWARD(HRESULT, GetDesc, (DXGI_SWAP_CHAIN_DESC* pDesc), (pDesc))
+    LS_FORWARD(HRESULT, ResizeBuffers,
+               (UINT BufferCount, UINT Width, UINT Height, DXGI_FORMAT NewFormat, UINT SwapChainFlags),
+               (BufferCount, Width, Height, NewFormat, SwapChainFlags))
+    LS_FORWARD(HRESULT, ResizeTarget, (const DXGI_MODE_DESC* pNewTargetParameters), (pNewTargetParameters))
+    LS_FORWARD(HRESULT, GetContainingOutput, (IDXGIOutput** ppOutput), (ppOutput))
+    LS_FORWARD(HRESULT, GetFrameStatistics, (DXGI_FRAME_STATISTICS* pStats), (pStats))
+    LS_FORWARD(HRESULT, GetLastPresentCount, (UINT* pLastPresentCount), (pLastPresentCount))
+
+    // IDXGISwapChain1
+    LS_FORWARD(HRESULT, GetDesc1, (DXGI_SWAP_CHAIN_DESC1* pDesc), (pDesc))
+    LS_FORWARD(HRESULT, GetFullscreenDesc, (DXGI_SWAP_CHAIN_FULLSCREEN_DESC* pDesc), (pDesc))
+    LS_FORWARD(HRESULT, GetHwnd, (HWND* pHwnd), (pHwnd))
+    LS_FORWARD(HRESULT, GetCoreWindow, (REFIID refiid, void** ppUnk), (refiid, ppUnk))
+    LS_FORWARD(HRESULT, Present1,
+               (UINT SyncInterval, UINT PresentFlags, const DXGI_PRESENT_PARAMETERS* pPresentParameters),
+               (SyncInterval, PresentFlags, pPresentParameters))
+    LS_FORWARD(BOOL, IsTemporaryMonoSupported, (), ())
+    LS_FORWARD(HRESULT, GetRestrictToOutput, (IDXGIOutput** ppRestrictToOutput), (ppRestrictToOutput))
+    LS_FORWARD(HRESULT, SetBackgroundColor, (const DXGI_RGBA* pColor), (pColor))
+    LS_FORWARD(HRESULT, GetBackgroundColor, (DXGI_RGBA* pColor), (pColor))
+    LS_FORWARD(HRESULT, SetRotation, (DXGI_MODE_ROTATION Rotation), (Rotation))
+    LS_FORWARD(HRESULT, GetRotation, (DXGI_MODE_ROTATION* pRotation), (pRotation))
+
+    // IDXGISwapChain2
+    LS_FORWARD(HRESULT, SetSourceSize, (UINT Width, UINT Height), (Width, Height))
+    LS_FORWARD(HRESULT, GetSourceSize, (UINT* pWidth, UINT* pHeight), (pWidth, pHeight))
+    LS_FORWARD(HRESULT, SetMaximumFrameLatency, (UINT MaxLatency), (MaxLatency))
+    LS_FORWARD(HRESULT, GetMaximumFrameLatency, (UINT* pMaxLatency), (pMaxLatency))
+    LS_FORWARD(HANDLE, GetFrameLatencyWaitableObject, (), ())
+    LS_FORWARD(HRESULT, SetMatrixTransform, (const DXGI_MATRIX_3X2_F* pMatrix), (pMatrix))
+    LS_FORWARD(HRESULT, GetMatrixTransform, (DXGI_MATRIX_3X2_F* pMatrix), (pMatrix))
+
+    // IDXGISwapChain3
+    LS_FORWARD(UINT, GetCurrentBackBufferIndex, (), ())
+    LS_FORWARD(HRESULT, CheckColorSpaceSupport, (DXGI_COLOR_SPACE_TYPE ColorSpace, UINT* pColorSpaceSupport),
+               (ColorSpace, pColorSpaceSupport))
+    LS_FORWARD(HRESULT, SetColorSpace1, (DXGI_COLOR_SPACE_TYPE ColorSpace), (ColorSpace))
+    LS_FORWARD(HRESULT, ResizeBuffers1,
+               (UINT BufferCount, UINT Width, UINT Height, DXGI_FORMAT Format, UINT SwapChainFlags,
+                const UINT* pCreationNodeMask, IUnknown* const* ppPresentQueue),
+               (BufferCount, Width, Height, Format, SwapChainFlags, pCreationNodeMask, ppPresentQueue))
+
+    // IDXGISwapChain4
+    LS_FORWARD(HRESULT, SetHDRMetaData, (DXGI_HDR_METADATA_TYPE Type, UINT Size, void* pMetaData), (Type, Size, pMetaData))
+};
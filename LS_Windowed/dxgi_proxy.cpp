@@ -1,96 +1,318 @@
 #include "dxgi_proxy.hpp"
+#include "adapter_cache.hpp"
+#include "hook_stats.hpp"
 #include "logger.hpp"
+#include "mode_table.hpp"
+#include "virtual_displays.hpp"
+#include <dwmapi.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
-#include <map>
 
 // Global flag to track factory lifetime
 bool g_FactoryAlive = false;
 
-// External globals from main.cpp
-extern RECT g_TargetRect;
-extern void UpdateTargetRect();
+// Wrapped adapters shared by all live factories, to prevent double-wrapping
+static AdapterCache<ProxyDXGIAdapter> g_AdapterCache;
 
-// Helper to compare LUIDs
-struct LUIDComparator {
-    bool operator()(const LUID& a, const LUID& b) const {
-        if (a.HighPart != b.HighPart) return a.HighPart < b.HighPart;
-        return a.LowPart < b.LowPart;
-    }
-};
-
-// Static cache for wrapped adapters to prevent double-wrapping (keyed by LUID)
-static std::map<LUID, ProxyDXGIAdapter*, LUIDComparator> g_AdapterCache;
+static uint64_t LuidKey(const LUID& luid) {
+    return ((uint64_t)(uint32_t)luid.HighPart << 32) | luid.LowPart;
+}
 
-// Fake output instance
-static ProxyDXGIOutput* g_FakeOutput = nullptr;
+// Fake output instances, one per virtual display, shared by every adapter that
+// injects them
+static std::mutex g_FakeOutputMutex;
+static FakeDXGIOutput* g_FakeOutputs[kMaxVirtualDisplays] = {};
 
-// --- ProxyDXGIFactory ---
+// A real output as last enumerated by its adapter. id changes whenever the
+// entry is rebuilt, so mode caches can tell a stale rate list in O(1).
+struct HostOutput {
+    uint64_t id;
+    UINT adapterIndex;
+    IDXGIOutput* output; // One reference
+    WCHAR deviceName[32];
+    RECT desktop;
+    std::vector<ModeRate> rates;
+};
 
-ProxyDXGIFactory::ProxyDXGIFactory(IDXGIFactory6* pFactory) : m_pFactory(pFactory), m_refCount(1) {
-    Log("[LS_Windowed] ProxyDXGIFactory created.");
+static std::mutex g_HostOutputMutex;
+static std::vector<HostOutput> g_HostOutputs;
+static uint64_t g_NextHostOutputId = 1;
+
+// The real output a virtual display is mapped to: the one its target window's
+// centre sits on, else the first one enumerated. Called with g_HostOutputMutex held.
+static const HostOutput* HostOutputFor(const RECT& targetRect) {
+    LONG x = targetRect.left + (targetRect.right - targetRect.left) / 2;
+    LONG y = targetRect.top + (targetRect.bottom - targetRect.top) / 2;
+    for (const HostOutput& host : g_HostOutputs) {
+        if (x >= host.desktop.left && x < host.desktop.right && y >= host.desktop.top && y < host.desktop.bottom) {
+            return &host;
+        }
+    }
+    return g_HostOutputs.empty() ? nullptr : &g_HostOutputs.front();
 }
 
-ProxyDXGIFactory::~ProxyDXGIFactory() {
-    Log("[LS_Windowed] ProxyDXGIFactory::~ProxyDXGIFactory() called - about to release real factory");
-    
-    g_FactoryAlive = false; // Disable fake monitor injection
-    
-    // Clear the adapter cache when factory is destroyed
-    Log("[LS_Windowed] Clearing adapter cache (size: %d)", g_AdapterCache.size());
-    for (auto& pair : g_AdapterCache) {
-        if (pair.second) {
-            Log("[LS_Windowed] Releasing cached adapter from factory destructor");
-            pair.second->Release(); // Release the extra reference we kept
-        }
+// Modes of each fake output: its display's size at the refresh rates of the
+// real output it is mapped to
+static ModeTableCache g_FakeModes[kMaxVirtualDisplays];
+
+static std::shared_ptr<const ModeTable> FakeModeTable(size_t display) {
+    RECT targetRect = g_VirtualDisplays.Geometry(display).targetRect;
+    {
+        static const std::vector<ModeRate> kNoRates;
+        std::lock_guard<std::mutex> lock(g_HostOutputMutex);
+        const HostOutput* host = HostOutputFor(targetRect);
+        g_FakeModes[display].SetHostRates(host ? host->id : 0, host ? host->rates : kNoRates);
     }
-    g_AdapterCache.clear();
-    
-    if (g_FakeOutput) {
-        g_FakeOutput->Release();
-        g_FakeOutput = nullptr;
+    return g_FakeModes[display].Get(
+        {(uint32_t)(targetRect.right - targetRect.left), (uint32_t)(targetRect.bottom - targetRect.top)});
+}
+
+// Refresh rates a real output supports, from its 8-bit RGBA mode list
+static void CollectRefreshRates(IDXGIOutput* pOutput, std::vector<ModeRate>& rates) {
+    UINT count = 0;
+    if (FAILED(pOutput->GetDisplayModeList(DXGI_FORMAT_R8G8B8A8_UNORM, 0, &count, nullptr)) || !count) return;
+    std::vector<DXGI_MODE_DESC> modes(count);
+    if (FAILED(pOutput->GetDisplayModeList(DXGI_FORMAT_R8G8B8A8_UNORM, 0, &count, modes.data()))) return;
+    for (UINT i = 0; i < count; i++) {
+        rates.push_back({modes[i].RefreshRate.Numerator, modes[i].RefreshRate.Denominator});
     }
-
-    if (m_pFactory) m_pFactory->Release();
-    Log("[LS_Windowed] ProxyDXGIFactory destroyed.");
 }
 
-HRESULT ProxyDXGIFactory::QueryInterface(REFIID riid, void** ppvObject) {
-    if (!ppvObject) return E_POINTER;
-    if (riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIObject) || riid == __uuidof(IDXGIFactory) || 
-        riid == __uuidof(IDXGIFactory1) || riid == __uuidof(IDXGIFactory2) || riid == __uuidof(IDXGIFactory3) ||
-        riid == __uuidof(IDXGIFactory4) || riid == __uuidof(IDXGIFactory5) || riid == __uuidof(IDXGIFactory6)) {
-        *ppvObject = this;
-        AddRef();
+// Each phase-locked to the real output its virtual display is mapped to. They
+// run at 60 Hz from creation until their first successful sync.
+VBlankClock g_VirtualVBlank[kMaxVirtualDisplays];
+
+static constexpr uint64_t kVBlankResyncNs = 500000000; // Refresh clocks drift slowly; resync twice a second
+static std::atomic<uint64_t> g_VBlankSyncNs[kMaxVirtualDisplays]; // Last sync of each clock
+
+// steady_clock and QPC differ in epoch and scale. Times are translated through
+// a back-to-back reading of both clocks; only differences are scaled, so a
+// double keeps them exact to well under a tick.
+struct QpcMapping {
+    int64_t qpc;
+    uint64_t steadyNs;
+    double nsPerTick;
+
+    static QpcMapping Read() {
+        LARGE_INTEGER frequency, counter;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&counter);
+        return {counter.QuadPart, VBlankClock::NowNs(), 1e9 / (double)frequency.QuadPart};
+    }
+    uint64_t ToSteadyNs(int64_t qpcTime) const { return steadyNs + (int64_t)((double)(qpcTime - qpc) * nsPerTick); }
+    int64_t ToQpc(uint64_t timeNs) const { return qpc + (int64_t)((double)(int64_t)(timeNs - steadyNs) / nsPerTick); }
+};
+
+// Current refresh rate of the real output a virtual display is mapped to, and
+// that output (with a reference). Windows reports whole Hz (59 for 59.94), so
+// the output's own mode list supplies the exact rate.
+static IDXGIOutput* HostRefresh(size_t display, ModeRate* rate) {
+    std::lock_guard<std::mutex> lock(g_HostOutputMutex);
+    const HostOutput* host = HostOutputFor(g_VirtualDisplays.Geometry(display).targetRect);
+    if (!host) return nullptr;
+    DEVMODEW mode = {};
+    mode.dmSize = sizeof(mode);
+    if (!EnumDisplaySettingsW(host->deviceName, ENUM_CURRENT_SETTINGS, &mode) || mode.dmDisplayFrequency <= 1) {
+        return nullptr;
+    }
+    *rate = {mode.dmDisplayFrequency, 1};
+    double nearest = 1.0;
+    for (const ModeRate& candidate : host->rates) {
+        double distance = std::fabs(candidate.Hz() - (double)mode.dmDisplayFrequency);
+        if (distance < nearest) {
+            nearest = distance;
+            *rate = candidate;
+        }
+    }
+    host->output->AddRef();
+    return host->output;
+}
+
+// Locks a virtual display's clock to its host output. DWM's timing is used
+// when the compositor runs at the host's rate; DwmGetCompositionTimingInfo only
+// takes a NULL window since Windows 8.1, so it cannot be asked about another
+// panel. Otherwise the period comes from the host's mode and, if the caller may
+// block, the phase from a real WaitForVBlank on it. Returns true if it waited.
+static bool SyncVirtualVBlank(size_t display, uint64_t nowNs, bool mayWait) {
+    VBlankClock& clock = g_VirtualVBlank[display];
+    std::atomic<uint64_t>& lastSync = g_VBlankSyncNs[display];
+    uint64_t last = lastSync.load(std::memory_order_relaxed);
+    if (last && nowNs - last < kVBlankResyncNs) return false;
+    if (!lastSync.compare_exchange_strong(last, nowNs, std::memory_order_relaxed)) return false;
+
+    ModeRate hostRate;
+    IDXGIOutput* host = HostRefresh(display, &hostRate);
+    DWM_TIMING_INFO info = {};
+    info.cbSize = sizeof(info);
+    bool dwm = SUCCEEDED(DwmGetCompositionTimingInfo(nullptr, &info)) && info.qpcRefreshPeriod;
+
+    QpcMapping clocks = QpcMapping::Read();
+    VBlankReference reference;
+    bool waited = false;
+    double dwmHz = dwm ? 1e9 / ((double)info.qpcRefreshPeriod * clocks.nsPerTick) : 0.0;
+    if (dwm && (!host || std::fabs(dwmHz - hostRate.Hz()) < 0.5)) {
+        reference.periodNs = (uint64_t)((double)info.qpcRefreshPeriod * clocks.nsPerTick);
+        reference.vblankNs = clocks.ToSteadyNs((int64_t)info.qpcVBlank);
+    } else if (host) {
+        reference.periodNs = (uint64_t)(1e9 / hostRate.Hz());
+        // A forced rate has its own phase; waiting on the host would not match it
+        bool overridden = clock.Period() != clock.Reference().periodNs;
+        if (mayWait && !overridden && SUCCEEDED(host->WaitForVBlank())) {
+            reference.vblankNs = VBlankClock::NowNs();
+            waited = true;
+        } else {
+            reference.vblankNs = clock.LastVBlank(nowNs).timeNs; // Keep the phase
+        }
+    }
+    if (host) host->Release();
+    if (reference.periodNs) clock.SetReference(reference);
+    return waited;
+}
+
+template <class ModeDesc>
+static void FillModeDesc(ModeDesc& desc, const DisplayMode& mode, DXGI_FORMAT format) {
+    desc = {};
+    desc.Width = mode.size.width;
+    desc.Height = mode.size.height;
+    desc.RefreshRate.Numerator = mode.refresh.numerator;
+    desc.RefreshRate.Denominator = mode.refresh.denominator;
+    desc.Format = format;
+    desc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_PROGRESSIVE;
+    desc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+}
+
+// GetDisplayModeList semantics: count query, partial copy with MORE_DATA.
+// The virtual display has no interlaced or stereo modes, so those flags add
+// nothing; DXGI_ENUM_MODES_SCALING adds each mode's centered and stretched
+// variants, as a panel that scales the smaller sizes in ModeTable would.
+template <class ModeDesc>
+static HRESULT ListFakeModes(size_t display, DXGI_FORMAT format, UINT flags, UINT* pNumModes, ModeDesc* pDesc) {
+    static const DXGI_MODE_SCALING kScalings[] = {DXGI_MODE_SCALING_UNSPECIFIED, DXGI_MODE_SCALING_CENTERED,
+                                                  DXGI_MODE_SCALING_STRETCHED};
+    if (!pNumModes) return E_INVALIDARG;
+    std::shared_ptr<const ModeTable> table = FakeModeTable(display);
+    UINT variants = (flags & DXGI_ENUM_MODES_SCALING) ? 3 : 1;
+    UINT count = (UINT)table->ModeCount() * variants;
+    if (!pDesc) {
+        *pNumModes = count;
         return S_OK;
     }
-    return m_pFactory->QueryInterface(riid, ppvObject);
+    UINT copied = *pNumModes < count ? *pNumModes : count;
+    for (UINT i = 0; i < copied; i++) {
+        FillModeDesc(pDesc[i], table->ModeAt(i / variants), format);
+        pDesc[i].Scaling = kScalings[i % variants];
+    }
+    *pNumModes = copied;
+    return copied < count ? DXGI_ERROR_MORE_DATA : S_OK;
+}
+
+template <class ModeDesc>
+static HRESULT MatchFakeMode(size_t display, const ModeDesc* pModeToMatch, ModeDesc* pClosestMatch) {
+    if (!pClosestMatch) return E_INVALIDARG;
+    ModeSize size;
+    ModeRate refresh;
+    DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    if (pModeToMatch) {
+        size = {pModeToMatch->Width, pModeToMatch->Height};
+        refresh = {pModeToMatch->RefreshRate.Numerator, pModeToMatch->RefreshRate.Denominator};
+        if (pModeToMatch->Format != DXGI_FORMAT_UNKNOWN) format = pModeToMatch->Format;
+    }
+    DisplayMode mode = FakeModeTable(display)->FindClosest(size, refresh);
+    FillModeDesc(*pClosestMatch, mode, format);
+    LOG_TRACE("[LS_Windowed] FindClosestMatchingMode (FAKE) %ux%u -> %ux%u @ %u/%u", size.width, size.height,
+              mode.size.width, mode.size.height, mode.refresh.numerator, mode.refresh.denominator);
+    return S_OK;
+}
+
+PresentRegistry g_SwapChainPresents;
+FrameCapture g_FrameCapture;
+static std::atomic<uint32_t> g_SwapChainCount{0};
+
+// Presents of the wrapped swap chains on each virtual display, reported by its
+// fake output's frame statistics, and the refresh the last one became visible on
+struct DisplayPresents {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> refreshCount{0};
+};
+static DisplayPresents g_DisplayPresents[kMaxVirtualDisplays];
+
+// The virtual display a swap chain's window belongs to: the one whose LS or
+// target window it is, else display 0
+static size_t PresentDisplay(uint64_t window) {
+    int display = g_VirtualDisplays.IndexOfWindow((HWND)(uintptr_t)window);
+    return display < 0 ? 0 : (size_t)display;
+}
+
+// Replaces a swap chain the real factory created with a wrapper. Swap chains
+// without IDXGISwapChain4 (runtimes before Windows 10) stay unwrapped.
+template <class SwapChain>
+static HRESULT WrapSwapChain(HRESULT hr, SwapChain** ppSwapChain, HWND window) {
+    if (FAILED(hr) || !ppSwapChain || !*ppSwapChain) return hr;
+    IDXGISwapChain4* pSwapChain4 = nullptr;
+    if (FAILED((*ppSwapChain)->QueryInterface(__uuidof(IDXGISwapChain4), (void**)&pSwapChain4))) return hr;
+    (*ppSwapChain)->Release();
+    *ppSwapChain = new ProxyDXGISwapChain(pSwapChain4, window);
+    return hr;
 }
 
-ULONG ProxyDXGIFactory::AddRef() {
-    return InterlockedIncrement(&m_refCount);
+// Bumped on display topology changes; adapters rebuild stale output lists
+static std::atomic<uint32_t> g_OutputTopologyGeneration{0};
+
+bool CheckIidTables() {
+    const IID* sdk[kDxgiIidCount] = {
+        &__uuidof(IUnknown),      &__uuidof(IDXGIObject),   &__uuidof(IDXGIFactory),  &__uuidof(IDXGIFactory1),
+        &__uuidof(IDXGIFactory2), &__uuidof(IDXGIFactory3), &__uuidof(IDXGIFactory4), &__uuidof(IDXGIFactory5),
+        &__uuidof(IDXGIFactory6), &__uuidof(IDXGIAdapter),  &__uuidof(IDXGIAdapter1), &__uuidof(IDXGIAdapter2),
+        &__uuidof(IDXGIAdapter3), &__uuidof(IDXGIAdapter4), &__uuidof(IDXGIOutput),   &__uuidof(IDXGIOutput1),
+        &__uuidof(IDXGIOutput2),  &__uuidof(IDXGIOutput3),  &__uuidof(IDXGIOutput4),  &__uuidof(IDXGIOutput5),
+        &__uuidof(IDXGIOutput6),  &__uuidof(IDXGIDeviceSubObject), &__uuidof(IDXGISwapChain),
+        &__uuidof(IDXGISwapChain1), &__uuidof(IDXGISwapChain2), &__uuidof(IDXGISwapChain3), &__uuidof(IDXGISwapChain4),
+    };
+    for (size_t i = 0; i < kDxgiIidCount; i++) {
+        IidKey key = IidKey::Of(*sdk[i]);
+        if (!(key == kDxgiIids[i].key) || kAllDxgiIids.Find(key) != (int)i) return false;
+    }
+    return true;
 }
 
-ULONG ProxyDXGIFactory::Release() {
-    ULONG ref = InterlockedDecrement(&m_refCount);
-    if (ref == 0) delete this;
-    return ref;
+void InvalidateOutputTopology() {
+    g_OutputTopologyGeneration.fetch_add(1, std::memory_order_acq_rel);
 }
 
-HRESULT ProxyDXGIFactory::SetPrivateData(REFGUID Name, UINT DataSize, const void* pData) {
-    return m_pFactory->SetPrivateData(Name, DataSize, pData);
-}
+// --- ProxyDXGIFactory ---
 
-HRESULT ProxyDXGIFactory::SetPrivateDataInterface(REFGUID Name, const IUnknown* pUnknown) {
-    return m_pFactory->SetPrivateDataInterface(Name, pUnknown);
+ProxyDXGIFactory::ProxyDXGIFactory(IDXGIFactory6* pFactory) : m_pFactory(pFactory) {
+    g_AdapterCache.RetainFactory();
+    LOG_DEBUG("[LS_Windowed] ProxyDXGIFactory created.");
 }
 
-HRESULT ProxyDXGIFactory::GetPrivateData(REFGUID Name, UINT* pDataSize, void* pData) {
-    return m_pFactory->GetPrivateData(Name, pDataSize, pData);
-}
+ProxyDXGIFactory::~ProxyDXGIFactory() {
+    LOG_DEBUG("[LS_Windowed] ProxyDXGIFactory::~ProxyDXGIFactory() called - about to release real factory");
+
+    // Cached adapters stay valid for the other factories; the last one to go
+    // releases them
+    size_t cached = g_AdapterCache.Size();
+    if (g_AdapterCache.ReleaseFactory()) {
+        LOG_DEBUG("[LS_Windowed] Last factory released, cleared adapter cache (size: %d)", (int)cached);
+        g_FactoryAlive = false; // Disable fake monitor injection
+
+        {
+            std::lock_guard<std::mutex> lock(g_FakeOutputMutex);
+            for (FakeDXGIOutput*& output : g_FakeOutputs) {
+                if (!output) continue;
+                output->Release(); // Adapters still holding it keep their own references
+                output = nullptr;
+            }
+        }
+        std::lock_guard<std::mutex> lock(g_HostOutputMutex);
+        for (HostOutput& host : g_HostOutputs) host.output->Release();
+        g_HostOutputs.clear();
+    }
 
-HRESULT ProxyDXGIFactory::GetParent(REFIID riid, void** ppParent) {
-    return m_pFactory->GetParent(riid, ppParent);
+    m_pFactory->Release();
+    LOG_DEBUG("[LS_Windowed] ProxyDXGIFactory destroyed.");
 }
 
 HRESULT ProxyDXGIFactory::EnumAdapters(UINT Adapter, IDXGIAdapter** ppAdapter) {
@@ -104,25 +326,16 @@ HRESULT ProxyDXGIFactory::EnumAdapters(UINT Adapter, IDXGIAdapter** ppAdapter) {
             pAdapter4->GetDesc2(&desc);
             LUID adapterLuid = desc.AdapterLuid;
             
-            // Check if we already have a wrapper for this adapter
-            auto it = g_AdapterCache.find(adapterLuid);
-            if (it != g_AdapterCache.end()) {
-                *ppAdapter = it->second;
-                it->second->AddRef();
-                pAdapter4->Release(); // Release our temp ref
-                pRealAdapter->Release(); // Release original ref
-                return S_OK;
-            }
-            
-            // Create new wrapper
-            ProxyDXGIAdapter* pProxy = new ProxyDXGIAdapter(pAdapter4, Adapter);
-            pProxy->AddRef(); // Add ref for cache
-            g_AdapterCache[adapterLuid] = pProxy;
-            
+            // Reuse the wrapper any factory already made for this adapter
+            bool created = false;
+            ProxyDXGIAdapter* pProxy = g_AdapterCache.FindOrInsert(
+                LuidKey(adapterLuid), [&] { return new ProxyDXGIAdapter(pAdapter4, Adapter); }, &created);
+            // A wrapper cached before a topology change moves to this factory's
+            // adapter, whose output snapshot is current
+            if (!created && !pProxy->AdoptIfNewer(pAdapter4)) pAdapter4->Release();
+
             *ppAdapter = pProxy;
-            pProxy->AddRef(); // Add ref for caller
-            
-            pRealAdapter->Release(); // Release original ref, proxy took ownership of pAdapter4
+            pRealAdapter->Release(); // Release original ref
             return S_OK;
         }
         // Fallback
@@ -131,22 +344,6 @@ HRESULT ProxyDXGIFactory::EnumAdapters(UINT Adapter, IDXGIAdapter** ppAdapter) {
     return hr;
 }
 
-HRESULT ProxyDXGIFactory::MakeWindowAssociation(HWND WindowHandle, UINT Flags) {
-    return m_pFactory->MakeWindowAssociation(WindowHandle, Flags);
-}
-
-HRESULT ProxyDXGIFactory::GetWindowAssociation(HWND* pWindowHandle) {
-    return m_pFactory->GetWindowAssociation(pWindowHandle);
-}
-
-HRESULT ProxyDXGIFactory::CreateSwapChain(IUnknown* pDevice, DXGI_SWAP_CHAIN_DESC* pDesc, IDXGISwapChain** ppSwapChain) {
-    return m_pFactory->CreateSwapChain(pDevice, pDesc, ppSwapChain);
-}
-
-HRESULT ProxyDXGIFactory::CreateSoftwareAdapter(HMODULE Module, IDXGIAdapter** ppAdapter) {
-    return m_pFactory->CreateSoftwareAdapter(Module, ppAdapter);
-}
-
 HRESULT ProxyDXGIFactory::EnumAdapters1(UINT Adapter, IDXGIAdapter1** ppAdapter) {
     // Redirect to EnumAdapters logic to ensure wrapping
     IDXGIAdapter* pAdapterBase = nullptr;
@@ -159,468 +356,407 @@ HRESULT ProxyDXGIFactory::EnumAdapters1(UINT Adapter, IDXGIAdapter1** ppAdapter)
 }
 
 BOOL ProxyDXGIFactory::IsCurrent() {
-    return m_pFactory->IsCurrent();
-}
-
-BOOL ProxyDXGIFactory::IsWindowedStereoEnabled() {
-    return m_pFactory->IsWindowedStereoEnabled();
+    BOOL current = m_pFactory->IsCurrent();
+    if (!current) InvalidateOutputTopology();
+    return current;
 }
 
-HRESULT ProxyDXGIFactory::CreateSwapChainForHwnd(IUnknown *pDevice, HWND hWnd, const DXGI_SWAP_CHAIN_DESC1 *pDesc, const DXGI_SWAP_CHAIN_FULLSCREEN_DESC *pFullscreenDesc, IDXGIOutput *pRestrictToOutput, IDXGISwapChain1 **ppSwapChain) {
-    return m_pFactory->CreateSwapChainForHwnd(pDevice, hWnd, pDesc, pFullscreenDesc, pRestrictToOutput, ppSwapChain);
-}
-
-HRESULT ProxyDXGIFactory::CreateSwapChainForCoreWindow(IUnknown *pDevice, IUnknown *pWindow, const DXGI_SWAP_CHAIN_DESC1 *pDesc, IDXGIOutput *pRestrictToOutput, IDXGISwapChain1 **ppSwapChain) {
-    return m_pFactory->CreateSwapChainForCoreWindow(pDevice, pWindow, pDesc, pRestrictToOutput, ppSwapChain);
-}
-
-HRESULT ProxyDXGIFactory::GetSharedResourceAdapterLuid(HANDLE hResource, LUID *pLuid) {
-    return m_pFactory->GetSharedResourceAdapterLuid(hResource, pLuid);
-}
-
-HRESULT ProxyDXGIFactory::RegisterStereoStatusWindow(HWND WindowHandle, UINT wMsg, DWORD *pdwCookie) {
-    return m_pFactory->RegisterStereoStatusWindow(WindowHandle, wMsg, pdwCookie);
-}
-
-HRESULT ProxyDXGIFactory::RegisterStereoStatusEvent(HANDLE hEvent, DWORD *pdwCookie) {
-    return m_pFactory->RegisterStereoStatusEvent(hEvent, pdwCookie);
-}
-
-void ProxyDXGIFactory::UnregisterStereoStatus(DWORD dwCookie) {
-    m_pFactory->UnregisterStereoStatus(dwCookie);
+HRESULT ProxyDXGIFactory::CreateSwapChain(IUnknown* pDevice, DXGI_SWAP_CHAIN_DESC* pDesc, IDXGISwapChain** ppSwapChain) {
+    HRESULT hr = m_pFactory->CreateSwapChain(pDevice, pDesc, ppSwapChain);
+    return WrapSwapChain(hr, ppSwapChain, pDesc ? pDesc->OutputWindow : nullptr);
 }
 
-HRESULT ProxyDXGIFactory::RegisterOcclusionStatusWindow(HWND WindowHandle, UINT wMsg, DWORD *pdwCookie) {
-    return m_pFactory->RegisterOcclusionStatusWindow(WindowHandle, wMsg, pdwCookie);
+HRESULT ProxyDXGIFactory::CreateSwapChainForHwnd(IUnknown* pDevice, HWND hWnd, const DXGI_SWAP_CHAIN_DESC1* pDesc, const DXGI_SWAP_CHAIN_FULLSCREEN_DESC* pFullscreenDesc, IDXGIOutput* pRestrictToOutput, IDXGISwapChain1** ppSwapChain) {
+    HRESULT hr = m_pFactory->CreateSwapChainForHwnd(pDevice, hWnd, pDesc, pFullscreenDesc, pRestrictToOutput, ppSwapChain);
+    return WrapSwapChain(hr, ppSwapChain, hWnd);
 }
 
-HRESULT ProxyDXGIFactory::RegisterOcclusionStatusEvent(HANDLE hEvent, DWORD *pdwCookie) {
-    return m_pFactory->RegisterOcclusionStatusEvent(hEvent, pdwCookie);
-}
+// --- ProxyDXGISwapChain ---
 
-void ProxyDXGIFactory::UnregisterOcclusionStatus(DWORD dwCookie) {
-    m_pFactory->UnregisterOcclusionStatus(dwCookie);
+ProxyDXGISwapChain::ProxyDXGISwapChain(IDXGISwapChain4* pSwapChain, HWND window)
+    : m_pSwapChain(pSwapChain), m_presents((uint64_t)(uintptr_t)window),
+      m_captureSource(g_SwapChainCount.fetch_add(1, std::memory_order_relaxed)) {
+    g_SwapChainPresents.Add(&m_presents);
+    LOG_DEBUG("[LS_Windowed] ProxyDXGISwapChain created for window %p", (void*)window);
 }
 
-HRESULT ProxyDXGIFactory::CreateSwapChainForComposition(IUnknown *pDevice, const DXGI_SWAP_CHAIN_DESC1 *pDesc, IDXGIOutput *pRestrictToOutput, IDXGISwapChain1 **ppSwapChain) {
-    return m_pFactory->CreateSwapChainForComposition(pDevice, pDesc, pRestrictToOutput, ppSwapChain);
+ProxyDXGISwapChain::~ProxyDXGISwapChain() {
+    g_SwapChainPresents.Remove(&m_presents);
+    PresentSummary summary = m_presents.Summarize();
+    LOG_INFO("[LS_Windowed] Swap chain of window %p released after %llu presents (%llu failed); last %zu frames: "
+             "%.1f fps, frame time p50 %.2f ms, p99 %.2f ms, present p99 %.0f us",
+             (void*)(uintptr_t)m_presents.Window(), (unsigned long long)summary.presents,
+             (unsigned long long)summary.failed, summary.window, summary.framesPerSecond, summary.frameP50Ns / 1e6,
+             summary.frameP99Ns / 1e6, summary.costP99Ns / 1e3);
+    m_pSwapChain->Release();
 }
 
-UINT ProxyDXGIFactory::GetCreationFlags() {
-    return m_pFactory->GetCreationFlags();
+HRESULT ProxyDXGISwapChain::Present(UINT SyncInterval, UINT Flags) {
+    PresentRecord record;
+    record.startNs = VBlankClock::NowNs();
+    HRESULT hr = m_pSwapChain->Present(SyncInterval, Flags);
+    record.durationNs = (uint32_t)(VBlankClock::NowNs() - record.startNs);
+    record.flags = Flags;
+    record.syncInterval = (uint8_t)SyncInterval;
+    record.failed = FAILED(hr);
+    Record(record);
+    return hr;
 }
 
-HRESULT ProxyDXGIFactory::EnumAdapterByLuid(LUID AdapterLuid, REFIID riid, void **ppvAdapter) {
-    return m_pFactory->EnumAdapterByLuid(AdapterLuid, riid, ppvAdapter);
+HRESULT ProxyDXGISwapChain::Present1(UINT SyncInterval, UINT PresentFlags, const DXGI_PRESENT_PARAMETERS* pPresentParameters) {
+    PresentRecord record;
+    record.startNs = VBlankClock::NowNs();
+    HRESULT hr = m_pSwapChain->Present1(SyncInterval, PresentFlags, pPresentParameters);
+    record.durationNs = (uint32_t)(VBlankClock::NowNs() - record.startNs);
+    record.flags = PresentFlags;
+    record.syncInterval = (uint8_t)SyncInterval;
+    record.present1 = true;
+    record.failed = FAILED(hr);
+    Record(record);
+    return hr;
 }
 
-HRESULT ProxyDXGIFactory::EnumWarpAdapter(REFIID riid, void **ppvAdapter) {
-    return m_pFactory->EnumWarpAdapter(riid, ppvAdapter);
-}
+void ProxyDXGISwapChain::Record(const PresentRecord& record) {
+    m_presents.Record(record);
+    bool counted = !record.failed && !(record.flags & DXGI_PRESENT_TEST);
+    if (!counted && !g_FrameCapture.IsActive()) return;
 
-HRESULT ProxyDXGIFactory::CheckFeatureSupport(DXGI_FEATURE Feature, void *pFeatureSupportData, UINT FeatureSupportDataSize) {
-    return m_pFactory->CheckFeatureSupport(Feature, pFeatureSupportData, FeatureSupportDataSize);
-}
+    size_t display = PresentDisplay(m_presents.Window());
+    const VBlankClock& clock = g_VirtualVBlank[display];
+    if (counted) {
+        DisplayPresents& presents = g_DisplayPresents[display];
+        presents.count.fetch_add(1, std::memory_order_relaxed);
+        uint64_t shownOn = clock.LastVBlank(record.startNs + record.durationNs).count + 1;
+        presents.refreshCount.store(shownOn, std::memory_order_relaxed);
+    }
+    if (!g_FrameCapture.IsActive()) return;
 
-HRESULT ProxyDXGIFactory::EnumAdapterByGpuPreference(UINT Adapter, DXGI_GPU_PREFERENCE GpuPreference, REFIID riid, void **ppvAdapter) {
-    return m_pFactory->EnumAdapterByGpuPreference(Adapter, GpuPreference, riid, ppvAdapter);
+    FrameRecord frame = {};
+    frame.timeNs = record.startNs;
+    frame.kind = FrameEventKind::Present;
+    frame.source = m_captureSource;
+    frame.flags = (uint16_t)record.flags;
+    frame.present.durationNs = record.durationNs;
+    frame.present.vblank = clock.LastVBlank(record.startNs).count;
+    frame.present.syncInterval = record.syncInterval;
+    frame.present.failed = record.failed;
+    frame.present.present1 = record.present1;
+    g_FrameCapture.Append(frame);
 }
 
 // --- ProxyDXGIAdapter ---
 
-ProxyDXGIAdapter::ProxyDXGIAdapter(IDXGIAdapter4* pAdapter, UINT index) : m_pAdapter(pAdapter), m_refCount(1), m_adapterIndex(index) {
-    Log("[LS_Windowed] ProxyDXGIAdapter created for index %d", index);
+ProxyDXGIAdapter::ProxyDXGIAdapter(IDXGIAdapter4* pAdapter, UINT index)
+    : m_pAdapter(pAdapter), m_adapterIndex(index),
+      m_adapterGeneration(g_OutputTopologyGeneration.load(std::memory_order_acquire)) {
+    LOG_DEBUG("[LS_Windowed] ProxyDXGIAdapter created for index %d", index);
 }
 
 ProxyDXGIAdapter::~ProxyDXGIAdapter() {
-    Log("[LS_Windowed] ProxyDXGIAdapter::~ProxyDXGIAdapter() called for index %d", m_adapterIndex);
-    if (m_pAdapter) {
-        m_pAdapter->Release();
-    }
+    LOG_DEBUG("[LS_Windowed] ProxyDXGIAdapter::~ProxyDXGIAdapter() called for index %d", m_adapterIndex);
+    // The last reference is gone, so no call can still be inside
+    m_retired.push_back({m_outputList.load(std::memory_order_acquire), Real(), 0});
+    for (const Retired& retired : m_retired) Free(retired);
 }
 
-HRESULT ProxyDXGIAdapter::QueryInterface(REFIID riid, void** ppvObject) {
-    if (!ppvObject) return E_POINTER;
-    if (riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIObject) || riid == __uuidof(IDXGIAdapter) || 
-        riid == __uuidof(IDXGIAdapter1) || riid == __uuidof(IDXGIAdapter2) || riid == __uuidof(IDXGIAdapter3) ||
-        riid == __uuidof(IDXGIAdapter4)) {
-        *ppvObject = this;
-        AddRef();
-        return S_OK;
+void ProxyDXGIAdapter::Free(const Retired& retired) {
+    if (retired.list) {
+        for (IDXGIOutput* output : retired.list->outputs) output->Release();
+        delete retired.list;
     }
-    return m_pAdapter->QueryInterface(riid, ppvObject);
-}
-
-ULONG ProxyDXGIAdapter::AddRef() {
-    return InterlockedIncrement(&m_refCount);
-}
-
-ULONG ProxyDXGIAdapter::Release() {
-    ULONG ref = InterlockedDecrement(&m_refCount);
-    if (ref == 0) delete this;
-    return ref;
+    if (retired.adapter) retired.adapter->Release();
+}
+
+// Queues what was just unpublished and releases whatever no read section can
+// still hold. Called with m_rebuildMutex held, after the swap.
+void ProxyDXGIAdapter::RetireLocked(const OutputList* list, IDXGIAdapter4* adapter) {
+    if (list || adapter) m_retired.push_back({list, adapter, RcuDomain::Advance()});
+    uint64_t oldest = RcuDomain::OldestReader();
+    size_t kept = 0;
+    for (const Retired& retired : m_retired) {
+        if (retired.epoch <= oldest) {
+            Free(retired);
+        } else {
+            m_retired[kept++] = retired;
+        }
+    }
+    m_retired.resize(kept);
 }
 
-HRESULT ProxyDXGIAdapter::SetPrivateData(REFGUID Name, UINT DataSize, const void* pData) {
-    return m_pAdapter->SetPrivateData(Name, DataSize, pData);
+HRESULT ProxyDXGIAdapter::QueryOther(REFIID riid, void** ppvObject) {
+    RcuDomain::Enter();
+    HRESULT hr = Real()->QueryInterface(riid, ppvObject);
+    RcuDomain::Leave();
+    return hr;
 }
 
-HRESULT ProxyDXGIAdapter::SetPrivateDataInterface(REFGUID Name, const IUnknown* pUnknown) {
-    return m_pAdapter->SetPrivateDataInterface(Name, pUnknown);
-}
+bool ProxyDXGIAdapter::AdoptIfNewer(IDXGIAdapter4* pAdapter) {
+    uint32_t generation = g_OutputTopologyGeneration.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(m_rebuildMutex);
+    if (m_adapterGeneration == generation) return false;
 
-HRESULT ProxyDXGIAdapter::GetPrivateData(REFGUID Name, UINT* pDataSize, void* pData) {
-    return m_pAdapter->GetPrivateData(Name, pDataSize, pData);
+    // Other threads may still be calling into the old adapter
+    RetireLocked(nullptr, m_pAdapter.exchange(pAdapter, std::memory_order_acq_rel));
+    m_adapterGeneration = generation;
+    LOG_DEBUG("[LS_Windowed] ProxyDXGIAdapter %d now wraps the adapter of topology generation %u", m_adapterIndex,
+              generation);
+    return true;
 }
 
-HRESULT ProxyDXGIAdapter::GetParent(REFIID riid, void** ppParent) {
-    return m_pAdapter->GetParent(riid, ppParent);
-}
+ProxyDXGIAdapter::OutputList* ProxyDXGIAdapter::BuildOutputList(uint32_t generation) {
+    OutputList* list = new OutputList();
+    list->generation = generation;
 
-HRESULT ProxyDXGIAdapter::EnumOutputs(UINT Output, IDXGIOutput** ppOutput) {
     IDXGIOutput* pRealOutput = nullptr;
-    HRESULT hr = m_pAdapter->EnumOutputs(Output, &pRealOutput);
-    
-    if (hr == DXGI_ERROR_NOT_FOUND) {
-        if (m_adapterIndex == 0) {
-            bool isNextSlot = false;
-            if (Output == 0) {
-                isNextSlot = true;
-            } else {
-                IDXGIOutput* pPrev = nullptr;
-                if (SUCCEEDED(m_pAdapter->EnumOutputs(Output - 1, &pPrev))) {
-                    pPrev->Release();
-                    isNextSlot = true;
-                }
-            }
-            
-            if (isNextSlot) {
-                Log("[LS_Windowed] Injecting Fake DXGI Output at index %d", Output);
-                // Create or reuse the fake output
-                if (!g_FakeOutput) {
-                    g_FakeOutput = new ProxyDXGIOutput(nullptr, true);
-                    g_FakeOutput->AddRef(); // Keep an extra reference so it never gets destroyed
-                }
-                *ppOutput = g_FakeOutput;
-                g_FakeOutput->AddRef(); // Add reference for the caller
-                return S_OK;
-            }
+    std::vector<HostOutput> hostOutputs;
+    while (SUCCEEDED(Real()->EnumOutputs((UINT)list->outputs.size(), &pRealOutput))) {
+        HostOutput host = {0, m_adapterIndex, pRealOutput, {}, {}, {}};
+        pRealOutput->AddRef();
+        DXGI_OUTPUT_DESC desc;
+        if (SUCCEEDED(pRealOutput->GetDesc(&desc))) {
+            wcscpy_s(host.deviceName, 32, desc.DeviceName);
+            host.desktop = desc.DesktopCoordinates;
         }
-        return hr;
-    }
-    
-    if (SUCCEEDED(hr)) {
+        CollectRefreshRates(pRealOutput, host.rates);
+        hostOutputs.push_back(std::move(host));
         IDXGIOutput6* pOutput6 = nullptr;
         if (SUCCEEDED(pRealOutput->QueryInterface(__uuidof(IDXGIOutput6), (void**)&pOutput6))) {
-            *ppOutput = new ProxyDXGIOutput(pOutput6, false);
+            list->outputs.push_back(new ProxyDXGIOutput(pOutput6));
             pRealOutput->Release();
         } else {
-             *ppOutput = pRealOutput;
+            list->outputs.push_back(pRealOutput);
         }
     }
-    
-    return hr;
-}
-
-HRESULT ProxyDXGIAdapter::GetDesc(DXGI_ADAPTER_DESC* pDesc) {
-    return m_pAdapter->GetDesc(pDesc);
-}
-
-HRESULT ProxyDXGIAdapter::CheckInterfaceSupport(REFGUID InterfaceName, LARGE_INTEGER* pUMDVersion) {
-    return m_pAdapter->CheckInterfaceSupport(InterfaceName, pUMDVersion);
-}
-
-HRESULT ProxyDXGIAdapter::GetDesc1(DXGI_ADAPTER_DESC1* pDesc) {
-    return m_pAdapter->GetDesc1(pDesc);
-}
 
-HRESULT ProxyDXGIAdapter::GetDesc2(DXGI_ADAPTER_DESC2* pDesc) {
-    return m_pAdapter->GetDesc2(pDesc);
-}
-
-HRESULT ProxyDXGIAdapter::RegisterHardwareContentProtectionTeardownStatusEvent(HANDLE hEvent, DWORD *pdwCookie) {
-    return m_pAdapter->RegisterHardwareContentProtectionTeardownStatusEvent(hEvent, pdwCookie);
-}
-
-void ProxyDXGIAdapter::UnregisterHardwareContentProtectionTeardownStatus(DWORD dwCookie) {
-    m_pAdapter->UnregisterHardwareContentProtectionTeardownStatus(dwCookie);
-}
+    // This adapter's entries are replaced; the other adapters' stay
+    {
+        std::lock_guard<std::mutex> lock(g_HostOutputMutex);
+        auto stale = std::remove_if(g_HostOutputs.begin(), g_HostOutputs.end(),
+                                    [&](const HostOutput& host) { return host.adapterIndex == m_adapterIndex; });
+        for (auto it = stale; it != g_HostOutputs.end(); ++it) it->output->Release();
+        g_HostOutputs.erase(stale, g_HostOutputs.end());
+        for (HostOutput& host : hostOutputs) {
+            host.id = g_NextHostOutputId++;
+            g_HostOutputs.push_back(std::move(host));
+        }
+    }
 
-HRESULT ProxyDXGIAdapter::QueryVideoMemoryInfo(UINT NodeIndex, DXGI_MEMORY_SEGMENT_GROUP MemorySegmentGroup, DXGI_QUERY_VIDEO_MEMORY_INFO *pVideoMemoryInfo) {
-    return m_pAdapter->QueryVideoMemoryInfo(NodeIndex, MemorySegmentGroup, pVideoMemoryInfo);
+    // The fake outputs go in the slots right after the last real output
+    if (m_adapterIndex == 0) {
+        size_t displays = g_VirtualDisplays.Count();
+        LOG_DEBUG("[LS_Windowed] Injecting %d Fake DXGI Output(s) at index %d", (int)displays, (int)list->outputs.size());
+        std::lock_guard<std::mutex> lock(g_FakeOutputMutex);
+        for (size_t i = 0; i < displays; i++) {
+            if (!g_FakeOutputs[i]) {
+                g_FakeOutputs[i] = new FakeDXGIOutput(i); // Reference owned by g_FakeOutputs
+            }
+            g_FakeOutputs[i]->AddRef(); // Reference owned by the list
+            list->outputs.push_back(g_FakeOutputs[i]);
+        }
+    }
+    return list;
 }
 
-HRESULT ProxyDXGIAdapter::SetVideoMemoryReservation(UINT NodeIndex, DXGI_MEMORY_SEGMENT_GROUP MemorySegmentGroup, UINT64 Reservation) {
-    return m_pAdapter->SetVideoMemoryReservation(NodeIndex, MemorySegmentGroup, Reservation);
-}
+const ProxyDXGIAdapter::OutputList* ProxyDXGIAdapter::CurrentOutputs() {
+    uint32_t generation = g_OutputTopologyGeneration.load(std::memory_order_acquire);
+    const OutputList* list = m_outputList.load(std::memory_order_acquire);
+    if (list && list->generation == generation) return list;
 
-HRESULT ProxyDXGIAdapter::RegisterVideoMemoryBudgetChangeNotificationEvent(HANDLE hEvent, DWORD *pdwCookie) {
-    return m_pAdapter->RegisterVideoMemoryBudgetChangeNotificationEvent(hEvent, pdwCookie);
-}
+    std::lock_guard<std::mutex> lock(m_rebuildMutex);
+    list = m_outputList.load(std::memory_order_relaxed);
+    if (list && list->generation == generation) return list; // Another thread rebuilt it
 
-void ProxyDXGIAdapter::UnregisterVideoMemoryBudgetChangeNotification(DWORD dwCookie) {
-    m_pAdapter->UnregisterVideoMemoryBudgetChangeNotification(dwCookie);
+    OutputList* fresh = BuildOutputList(generation);
+    m_outputList.store(fresh, std::memory_order_seq_cst);
+    RetireLocked(list, nullptr);
+    LOG_DEBUG("[LS_Windowed] ProxyDXGIAdapter %d output list built: %d outputs", m_adapterIndex,
+              (int)fresh->outputs.size());
+    return fresh;
 }
 
-HRESULT ProxyDXGIAdapter::GetDesc3(DXGI_ADAPTER_DESC3 *pDesc) {
-    return m_pAdapter->GetDesc3(pDesc);
+HRESULT ProxyDXGIAdapter::EnumOutputs(UINT Output, IDXGIOutput** ppOutput) {
+    LS_HOOK_TIMER(HookId::AdapterEnumOutputs);
+    if (!ppOutput) return DXGI_ERROR_INVALID_CALL;
+
+    // The list may be replaced meanwhile; it stays valid until Leave()
+    RcuDomain::Enter();
+    const OutputList* list = CurrentOutputs();
+    HRESULT hr = DXGI_ERROR_NOT_FOUND;
+    if (Output < list->outputs.size()) {
+        *ppOutput = list->outputs[Output];
+        (*ppOutput)->AddRef();
+        hr = S_OK;
+    }
+    RcuDomain::Leave();
+    return hr;
 }
 
-// --- ProxyDXGIOutput ---
+// --- FakeDXGIOutput ---
 
-ProxyDXGIOutput::ProxyDXGIOutput(IDXGIOutput6* pOutput, bool isFake) : m_pOutput(pOutput), m_refCount(1), m_isFake(isFake) {
-    if (m_isFake) {
-        Log("[LS_Windowed] ProxyDXGIOutput (FAKE) created.");
-    }
+FakeDXGIOutput::FakeDXGIOutput(size_t virtualDisplay) : m_virtualDisplay(virtualDisplay) {
+    LOG_DEBUG("[LS_Windowed] FakeDXGIOutput %d created.", (int)m_virtualDisplay);
 }
 
-ProxyDXGIOutput::~ProxyDXGIOutput() {
-    if (m_isFake) {
-        Log("[LS_Windowed] ProxyDXGIOutput (FAKE) destroyed.");
-    }
-    if (m_pOutput) m_pOutput->Release();
+FakeDXGIOutput::~FakeDXGIOutput() {
+    LOG_DEBUG("[LS_Windowed] FakeDXGIOutput %d destroyed.", (int)m_virtualDisplay);
 }
 
-HRESULT ProxyDXGIOutput::QueryInterface(REFIID riid, void** ppvObject) {
-    if (!ppvObject) return E_POINTER;
-    if (riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIObject) || riid == __uuidof(IDXGIOutput) || 
-        riid == __uuidof(IDXGIOutput1) || riid == __uuidof(IDXGIOutput2) || riid == __uuidof(IDXGIOutput3) ||
-        riid == __uuidof(IDXGIOutput4) || riid == __uuidof(IDXGIOutput5) || riid == __uuidof(IDXGIOutput6)) {
-        *ppvObject = this;
-        AddRef();
-        return S_OK;
-    }
-    if (m_isFake) {
-        return E_NOINTERFACE;
-    }
-    if (m_pOutput) return m_pOutput->QueryInterface(riid, ppvObject);
+HRESULT FakeDXGIOutput::QueryOther(REFIID, void**) {
     return E_NOINTERFACE;
 }
 
-ULONG ProxyDXGIOutput::AddRef() {
-    return InterlockedIncrement(&m_refCount);
+HRESULT FakeDXGIOutput::SetPrivateData(REFGUID, UINT, const void*) {
+    return S_OK;
 }
 
-ULONG ProxyDXGIOutput::Release() {
-    ULONG ref = InterlockedDecrement(&m_refCount);
-    if (ref == 0) delete this;
-    return ref;
+HRESULT FakeDXGIOutput::SetPrivateDataInterface(REFGUID, const IUnknown*) {
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::SetPrivateData(REFGUID Name, UINT DataSize, const void* pData) {
-    if (m_isFake) return S_OK;
-    return m_pOutput->SetPrivateData(Name, DataSize, pData);
+HRESULT FakeDXGIOutput::GetPrivateData(REFGUID, UINT*, void*) {
+    return DXGI_ERROR_NOT_FOUND;
 }
 
-HRESULT ProxyDXGIOutput::SetPrivateDataInterface(REFGUID Name, const IUnknown* pUnknown) {
-    if (m_isFake) return S_OK;
-    return m_pOutput->SetPrivateDataInterface(Name, pUnknown);
+HRESULT FakeDXGIOutput::GetParent(REFIID, void**) {
+    return E_NOTIMPL;
 }
 
-HRESULT ProxyDXGIOutput::GetPrivateData(REFGUID Name, UINT* pDataSize, void* pData) {
-    if (m_isFake) return DXGI_ERROR_NOT_FOUND;
-    return m_pOutput->GetPrivateData(Name, pDataSize, pData);
-}
+HRESULT FakeDXGIOutput::GetDesc(DXGI_OUTPUT_DESC* pDesc) {
+    LS_HOOK_TIMER(HookId::OutputGetDesc);
+    if (!pDesc) return E_INVALIDARG;
+    wcscpy_s(pDesc->DeviceName, 32, g_VirtualDisplays.OutputName(m_virtualDisplay));
 
-HRESULT ProxyDXGIOutput::GetParent(REFIID riid, void** ppParent) {
-    if (m_isFake) return E_NOTIMPL;
-    return m_pOutput->GetParent(riid, ppParent);
-}
+    RECT targetRect = g_VirtualDisplays.Geometry(m_virtualDisplay).targetRect;
+    pDesc->DesktopCoordinates = targetRect;
 
-HRESULT ProxyDXGIOutput::GetDesc(DXGI_OUTPUT_DESC* pDesc) {
-    if (m_isFake) {
-        if (!pDesc) return E_INVALIDARG;
-        wcscpy_s(pDesc->DeviceName, 32, L"\\\\.\\DISPLAY_VIRTUAL");
-        
-        UpdateTargetRect(); // Update target rect before returning
-        
-        pDesc->DesktopCoordinates = g_TargetRect;
-        
-        pDesc->AttachedToDesktop = TRUE;
-        pDesc->Rotation = DXGI_MODE_ROTATION_IDENTITY;
-        pDesc->Monitor = (HMONITOR)0xBADF00D; 
-        Log("[LS_Windowed] ProxyDXGIOutput::GetDesc (FAKE) returning %dx%d @ (%d,%d)", 
-            g_TargetRect.right - g_TargetRect.left, g_TargetRect.bottom - g_TargetRect.top,
-            g_TargetRect.left, g_TargetRect.top);
-        return S_OK;
-    }
-    return m_pOutput->GetDesc(pDesc);
+    pDesc->AttachedToDesktop = TRUE;
+    pDesc->Rotation = DXGI_MODE_ROTATION_IDENTITY;
+    pDesc->Monitor = VirtualDisplays::Monitor(m_virtualDisplay);
+    LOG_TRACE("[LS_Windowed] FakeDXGIOutput::GetDesc returning %dx%d @ (%d,%d)",
+              targetRect.right - targetRect.left, targetRect.bottom - targetRect.top,
+              targetRect.left, targetRect.top);
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::GetDisplayModeList(DXGI_FORMAT EnumFormat, UINT Flags, UINT* pNumModes, DXGI_MODE_DESC* pDesc) {
-    if (m_isFake) {
-        if (!pNumModes) return E_INVALIDARG;
-        if (!pDesc) {
-            *pNumModes = 1;
-            return S_OK;
-        }
-        if (*pNumModes < 1) return DXGI_ERROR_MORE_DATA;
-        
-        UpdateTargetRect();
-
-        pDesc[0].Width = g_TargetRect.right - g_TargetRect.left;
-        pDesc[0].Height = g_TargetRect.bottom - g_TargetRect.top;
-        pDesc[0].RefreshRate.Numerator = 60; // Default to 60Hz
-        pDesc[0].RefreshRate.Denominator = 1;
-        pDesc[0].Format = EnumFormat; 
-        pDesc[0].ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_PROGRESSIVE;
-        pDesc[0].Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-        
-        *pNumModes = 1;
-        return S_OK;
-    }
-    return m_pOutput->GetDisplayModeList(EnumFormat, Flags, pNumModes, pDesc);
+HRESULT FakeDXGIOutput::GetDisplayModeList(DXGI_FORMAT EnumFormat, UINT Flags, UINT* pNumModes, DXGI_MODE_DESC* pDesc) {
+    LS_HOOK_TIMER(HookId::OutputGetDisplayModeList);
+    return ListFakeModes(m_virtualDisplay, EnumFormat, Flags, pNumModes, pDesc);
 }
 
-HRESULT ProxyDXGIOutput::FindClosestMatchingMode(const DXGI_MODE_DESC* pModeToMatch, DXGI_MODE_DESC* pClosestMatch, IUnknown* pConcernedDevice) {
-    if (m_isFake) {
-        if (!pClosestMatch) return E_INVALIDARG;
-        if (pModeToMatch) *pClosestMatch = *pModeToMatch;
-        return S_OK;
-    }
-    return m_pOutput->FindClosestMatchingMode(pModeToMatch, pClosestMatch, pConcernedDevice);
+HRESULT FakeDXGIOutput::FindClosestMatchingMode(const DXGI_MODE_DESC* pModeToMatch, DXGI_MODE_DESC* pClosestMatch, IUnknown*) {
+    LS_HOOK_TIMER(HookId::OutputFindClosestMatchingMode);
+    return MatchFakeMode(m_virtualDisplay, pModeToMatch, pClosestMatch);
 }
 
-HRESULT ProxyDXGIOutput::WaitForVBlank() {
-    if (m_isFake) {
-        Sleep(16); 
-        return S_OK;
-    }
-    return m_pOutput->WaitForVBlank();
+HRESULT FakeDXGIOutput::WaitForVBlank() {
+    LS_HOOK_TIMER(HookId::OutputWaitForVBlank);
+    // A resync that waited on the host output already returned on a vblank
+    if (!SyncVirtualVBlank(m_virtualDisplay, VBlankClock::NowNs(), true)) g_VirtualVBlank[m_virtualDisplay].Wait();
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::TakeOwnership(IUnknown* pDevice, BOOL Exclusive) {
-    if (m_isFake) return S_OK;
-    return m_pOutput->TakeOwnership(pDevice, Exclusive);
+HRESULT FakeDXGIOutput::TakeOwnership(IUnknown*, BOOL) {
+    return S_OK;
 }
 
-void ProxyDXGIOutput::ReleaseOwnership() {
-    if (m_isFake) return;
-    m_pOutput->ReleaseOwnership();
-}
+void FakeDXGIOutput::ReleaseOwnership() {}
 
-HRESULT ProxyDXGIOutput::GetGammaControlCapabilities(DXGI_GAMMA_CONTROL_CAPABILITIES* pGammaCaps) {
-    if (m_isFake) return E_NOTIMPL;
-    return m_pOutput->GetGammaControlCapabilities(pGammaCaps);
+HRESULT FakeDXGIOutput::GetGammaControlCapabilities(DXGI_GAMMA_CONTROL_CAPABILITIES*) {
+    return E_NOTIMPL;
 }
 
-HRESULT ProxyDXGIOutput::SetGammaControl(const DXGI_GAMMA_CONTROL* pArray) {
-    if (m_isFake) return S_OK;
-    return m_pOutput->SetGammaControl(pArray);
+HRESULT FakeDXGIOutput::SetGammaControl(const DXGI_GAMMA_CONTROL*) {
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::GetGammaControl(DXGI_GAMMA_CONTROL* pArray) {
-    if (m_isFake) return E_NOTIMPL;
-    return m_pOutput->GetGammaControl(pArray);
+HRESULT FakeDXGIOutput::GetGammaControl(DXGI_GAMMA_CONTROL*) {
+    return E_NOTIMPL;
 }
 
-HRESULT ProxyDXGIOutput::SetDisplaySurface(IDXGISurface* pScanoutSurface) {
-    if (m_isFake) return S_OK;
-    return m_pOutput->SetDisplaySurface(pScanoutSurface);
+HRESULT FakeDXGIOutput::SetDisplaySurface(IDXGISurface*) {
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::GetDisplaySurfaceData(IDXGISurface* pDestination) {
-    if (m_isFake) return S_OK;
-    return m_pOutput->GetDisplaySurfaceData(pDestination);
+HRESULT FakeDXGIOutput::GetDisplaySurfaceData(IDXGISurface*) {
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::GetFrameStatistics(DXGI_FRAME_STATISTICS* pStats) {
-    if (m_isFake) return E_NOTIMPL;
-    return m_pOutput->GetFrameStatistics(pStats);
+HRESULT FakeDXGIOutput::GetFrameStatistics(DXGI_FRAME_STATISTICS* pStats) {
+    LS_HOOK_TIMER(HookId::OutputGetFrameStatistics);
+    if (!pStats) return E_INVALIDARG;
+    // Refreshes come from the display's clock, presents from the wrapped swap
+    // chains of its windows (0 until one presents, like an output nothing was
+    // presented to).
+    // A present not yet on screen is not counted as shown.
+    uint64_t now = VBlankClock::NowNs();
+    SyncVirtualVBlank(m_virtualDisplay, now, false);
+    VBlankSample vblank = g_VirtualVBlank[m_virtualDisplay].PublishedVBlank(now);
+    const DisplayPresents& presents = g_DisplayPresents[m_virtualDisplay];
+    uint64_t presentRefresh = presents.refreshCount.load(std::memory_order_relaxed);
+    pStats->PresentCount = (UINT)presents.count.load(std::memory_order_relaxed);
+    pStats->PresentRefreshCount = (UINT)(presentRefresh < vblank.count ? presentRefresh : vblank.count);
+    pStats->SyncRefreshCount = (UINT)vblank.count;
+    pStats->SyncQPCTime.QuadPart = QpcMapping::Read().ToQpc(vblank.timeNs);
+    pStats->SyncGPUTime.QuadPart = 0;
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::GetDisplayModeList1(DXGI_FORMAT EnumFormat, UINT Flags, UINT* pNumModes, DXGI_MODE_DESC1* pDesc) {
-    if (m_isFake) {
-        if (!pNumModes) return E_INVALIDARG;
-        if (!pDesc) {
-            *pNumModes = 1;
-            return S_OK;
-        }
-        if (*pNumModes < 1) return DXGI_ERROR_MORE_DATA;
-        
-        UpdateTargetRect();
-
-        pDesc[0].Width = g_TargetRect.right - g_TargetRect.left;
-        pDesc[0].Height = g_TargetRect.bottom - g_TargetRect.top;
-        pDesc[0].RefreshRate.Numerator = 60;
-        pDesc[0].RefreshRate.Denominator = 1;
-        pDesc[0].Format = EnumFormat; 
-        pDesc[0].ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_PROGRESSIVE;
-        pDesc[0].Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-        pDesc[0].Stereo = FALSE; 
-        
-        *pNumModes = 1;
-        return S_OK;
-    }
-    return m_pOutput->GetDisplayModeList1(EnumFormat, Flags, pNumModes, pDesc);
+HRESULT FakeDXGIOutput::GetDisplayModeList1(DXGI_FORMAT EnumFormat, UINT Flags, UINT* pNumModes, DXGI_MODE_DESC1* pDesc) {
+    LS_HOOK_TIMER(HookId::OutputGetDisplayModeList1);
+    return ListFakeModes(m_virtualDisplay, EnumFormat, Flags, pNumModes, pDesc);
 }
 
-HRESULT ProxyDXGIOutput::FindClosestMatchingMode1(const DXGI_MODE_DESC1* pModeToMatch, DXGI_MODE_DESC1* pClosestMatch, IUnknown* pConcernedDevice) {
-    if (m_isFake) {
-        if (!pClosestMatch) return E_INVALIDARG;
-        if (pModeToMatch) *pClosestMatch = *pModeToMatch;
-        return S_OK;
-    }
-    return m_pOutput->FindClosestMatchingMode1(pModeToMatch, pClosestMatch, pConcernedDevice);
+HRESULT FakeDXGIOutput::FindClosestMatchingMode1(const DXGI_MODE_DESC1* pModeToMatch, DXGI_MODE_DESC1* pClosestMatch, IUnknown*) {
+    LS_HOOK_TIMER(HookId::OutputFindClosestMatchingMode1);
+    return MatchFakeMode(m_virtualDisplay, pModeToMatch, pClosestMatch);
 }
 
-HRESULT ProxyDXGIOutput::GetDisplaySurfaceData1(IDXGIResource* pDestination) {
-    if (m_isFake) return S_OK;
-    return m_pOutput->GetDisplaySurfaceData1(pDestination);
+HRESULT FakeDXGIOutput::GetDisplaySurfaceData1(IDXGIResource*) {
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::DuplicateOutput(IUnknown* pDevice, IDXGIOutputDuplication** ppOutputDuplication) {
-    if (m_isFake) return DXGI_ERROR_UNSUPPORTED;
-    return m_pOutput->DuplicateOutput(pDevice, ppOutputDuplication);
+HRESULT FakeDXGIOutput::DuplicateOutput(IUnknown*, IDXGIOutputDuplication**) {
+    return DXGI_ERROR_UNSUPPORTED;
 }
 
-BOOL ProxyDXGIOutput::SupportsOverlays() {
-    if (m_isFake) return FALSE;
-    return m_pOutput->SupportsOverlays();
+BOOL FakeDXGIOutput::SupportsOverlays() {
+    return FALSE;
 }
 
-HRESULT ProxyDXGIOutput::CheckOverlaySupport(DXGI_FORMAT EnumFormat, IUnknown *pConcernedDevice, UINT *pFlags) {
-    if (m_isFake) return E_NOTIMPL;
-    return m_pOutput->CheckOverlaySupport(EnumFormat, pConcernedDevice, pFlags);
+HRESULT FakeDXGIOutput::CheckOverlaySupport(DXGI_FORMAT, IUnknown*, UINT*) {
+    return E_NOTIMPL;
 }
 
-HRESULT ProxyDXGIOutput::CheckOverlayColorSpaceSupport(DXGI_FORMAT Format, DXGI_COLOR_SPACE_TYPE ColorSpace, IUnknown *pConcernedDevice, UINT *pFlags) {
-    if (m_isFake) return E_NOTIMPL;
-    return m_pOutput->CheckOverlayColorSpaceSupport(Format, ColorSpace, pConcernedDevice, pFlags);
+HRESULT FakeDXGIOutput::CheckOverlayColorSpaceSupport(DXGI_FORMAT, DXGI_COLOR_SPACE_TYPE, IUnknown*, UINT*) {
+    return E_NOTIMPL;
 }
 
-HRESULT ProxyDXGIOutput::DuplicateOutput1(IUnknown *pDevice, UINT Flags, UINT SupportedFormatsCount, const DXGI_FORMAT *pSupportedFormats, IDXGIOutputDuplication **ppOutputDuplication) {
-    if (m_isFake) return DXGI_ERROR_UNSUPPORTED;
-    return m_pOutput->DuplicateOutput1(pDevice, Flags, SupportedFormatsCount, pSupportedFormats, ppOutputDuplication);
+HRESULT FakeDXGIOutput::DuplicateOutput1(IUnknown*, UINT, UINT, const DXGI_FORMAT*, IDXGIOutputDuplication**) {
+    return DXGI_ERROR_UNSUPPORTED;
 }
 
-HRESULT ProxyDXGIOutput::GetDesc1(DXGI_OUTPUT_DESC1 *pDesc) {
-    if (m_isFake) {
-        if (!pDesc) return E_INVALIDARG;
-        wcscpy_s(pDesc->DeviceName, 32, L"\\\\.\\DISPLAY_VIRTUAL");
-        
-        UpdateTargetRect();
+HRESULT FakeDXGIOutput::GetDesc1(DXGI_OUTPUT_DESC1* pDesc) {
+    LS_HOOK_TIMER(HookId::OutputGetDesc1);
+    if (!pDesc) return E_INVALIDARG;
+    wcscpy_s(pDesc->DeviceName, 32, g_VirtualDisplays.OutputName(m_virtualDisplay));
 
-        pDesc->DesktopCoordinates = g_TargetRect;
-        
-        pDesc->AttachedToDesktop = TRUE;
-        pDesc->Rotation = DXGI_MODE_ROTATION_IDENTITY;
-        pDesc->Monitor = (HMONITOR)0xBADF00D;
-        pDesc->BitsPerColor = 8;
-        pDesc->ColorSpace = DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709;
-        pDesc->RedPrimary[0] = 0.64f; pDesc->RedPrimary[1] = 0.33f;
-        pDesc->GreenPrimary[0] = 0.30f; pDesc->GreenPrimary[1] = 0.60f;
-        pDesc->BluePrimary[0] = 0.15f; pDesc->BluePrimary[1] = 0.06f;
-        pDesc->WhitePoint[0] = 0.3127f; pDesc->WhitePoint[1] = 0.3290f;
-        pDesc->MinLuminance = 0.0f;
-        pDesc->MaxLuminance = 100.0f;
-        pDesc->MaxFullFrameLuminance = 100.0f;
-        return S_OK;
-    }
-    return m_pOutput->GetDesc1(pDesc);
+    pDesc->DesktopCoordinates = g_VirtualDisplays.Geometry(m_virtualDisplay).targetRect;
+
+    pDesc->AttachedToDesktop = TRUE;
+    pDesc->Rotation = DXGI_MODE_ROTATION_IDENTITY;
+    pDesc->Monitor = VirtualDisplays::Monitor(m_virtualDisplay);
+    pDesc->BitsPerColor = 8;
+    pDesc->ColorSpace = DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709;
+    pDesc->RedPrimary[0] = 0.64f; pDesc->RedPrimary[1] = 0.33f;
+    pDesc->GreenPrimary[0] = 0.30f; pDesc->GreenPrimary[1] = 0.60f;
+    pDesc->BluePrimary[0] = 0.15f; pDesc->BluePrimary[1] = 0.06f;
+    pDesc->WhitePoint[0] = 0.3127f; pDesc->WhitePoint[1] = 0.3290f;
+    pDesc->MinLuminance = 0.0f;
+    pDesc->MaxLuminance = 100.0f;
+    pDesc->MaxFullFrameLuminance = 100.0f;
+    return S_OK;
 }
 
-HRESULT ProxyDXGIOutput::CheckHardwareCompositionSupport(UINT *pFlags) {
-    if (m_isFake) return E_NOTIMPL;
-    return m_pOutput->CheckHardwareCompositionSupport(pFlags);
+HRESULT FakeDXGIOutput::CheckHardwareCompositionSupport(UINT*) {
+    return E_NOTIMPL;
 }
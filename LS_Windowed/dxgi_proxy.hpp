@@ -2,132 +2,191 @@
 #include <d3d11.h>
 #include <dxgi.h>
 #include <dxgi1_6.h>
+#include "dxgi_forwarders.hpp"
+#include "frame_capture.hpp"
+#include "hook_stats.hpp"
+#include "iid_table.hpp"
+#include "present_stats.hpp"
+#include "rcu_cell.hpp"
+#include "vblank_clock.hpp"
+#include "virtual_displays.hpp"
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 // Global flag to track factory lifetime
 extern bool g_FactoryAlive;
 
-// Forward declarations
-class ProxyDXGIFactory;
-class ProxyDXGIAdapter;
-class ProxyDXGIOutput;
+// Makes every adapter rebuild its output list on the next EnumOutputs. Called
+// when a factory reports it is no longer current (display topology changed).
+void InvalidateOutputTopology();
+
+// True if the compile-time IID tables match the SDK's interface ids
+bool CheckIidTables();
+
+// Vertical blank timeline of each virtual display, which its fake output's
+// WaitForVBlank and frame statistics follow
+extern VBlankClock g_VirtualVBlank[kMaxVirtualDisplays];
+
+// Present timing of every live swap chain created through a wrapped factory
+extern PresentRegistry g_SwapChainPresents;
+
+// Per-frame capture file; the swap chain proxies append every present to it
+// while a capture runs
+extern FrameCapture g_FrameCapture;
+
+// Hooks the forwarded calls of real outputs are timed under, the same ones the
+// fake output records. Other methods are not timed.
+template <auto Method>
+inline constexpr HookId kForwardedHook = HookId::Count;
+template <> inline constexpr HookId kForwardedHook<&IDXGIOutput::GetDesc> = HookId::OutputGetDesc;
+template <> inline constexpr HookId kForwardedHook<&IDXGIOutput6::GetDesc1> = HookId::OutputGetDesc1;
+template <> inline constexpr HookId kForwardedHook<&IDXGIOutput::GetDisplayModeList> = HookId::OutputGetDisplayModeList;
+template <> inline constexpr HookId kForwardedHook<&IDXGIOutput1::GetDisplayModeList1> = HookId::OutputGetDisplayModeList1;
+template <> inline constexpr HookId kForwardedHook<&IDXGIOutput::FindClosestMatchingMode> = HookId::OutputFindClosestMatchingMode;
+template <> inline constexpr HookId kForwardedHook<&IDXGIOutput1::FindClosestMatchingMode1> = HookId::OutputFindClosestMatchingMode1;
+template <> inline constexpr HookId kForwardedHook<&IDXGIOutput::WaitForVBlank> = HookId::OutputWaitForVBlank;
+template <> inline constexpr HookId kForwardedHook<&IDXGIOutput::GetFrameStatistics> = HookId::OutputGetFrameStatistics;
+
+struct HookStatsPolicy {
+    template <auto Method>
+    using Scope = HookScope<kForwardedHook<Method>>;
+};
+
+// Runs every forwarded call inside an RcuDomain read section, so whatever
+// Real() returned stays alive until the call is done even if it is swapped out
+struct RcuReadPolicy {
+    template <auto Method>
+    struct Scope {
+        Scope() { RcuDomain::Enter(); }
+        ~Scope() { RcuDomain::Leave(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
 
-class ProxyDXGIFactory : public IDXGIFactory6 {
+class ProxyDXGIFactory final : public DXGIFactoryForwarder<ProxyDXGIFactory> {
     IDXGIFactory6* m_pFactory;
-    ULONG m_refCount;
 
 public:
+    static constexpr const auto& kIids = kFactoryIids;
+
     ProxyDXGIFactory(IDXGIFactory6* pFactory);
-    virtual ~ProxyDXGIFactory();
+    ~ProxyDXGIFactory();
 
-    // IUnknown
-    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override;
-    ULONG STDMETHODCALLTYPE AddRef() override;
-    ULONG STDMETHODCALLTYPE Release() override;
+    IDXGIFactory6* Real() const { return m_pFactory; }
 
-    // IDXGIObject
-    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID Name, UINT DataSize, const void* pData) override;
-    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID Name, const IUnknown* pUnknown) override;
-    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID Name, UINT* pDataSize, void* pData) override;
-    HRESULT STDMETHODCALLTYPE GetParent(REFIID riid, void** ppParent) override;
-
-    // IDXGIFactory
+    // Adapters are wrapped; IsCurrent() == FALSE invalidates the output lists
     HRESULT STDMETHODCALLTYPE EnumAdapters(UINT Adapter, IDXGIAdapter** ppAdapter) override;
-    HRESULT STDMETHODCALLTYPE MakeWindowAssociation(HWND WindowHandle, UINT Flags) override;
-    HRESULT STDMETHODCALLTYPE GetWindowAssociation(HWND* pWindowHandle) override;
-    HRESULT STDMETHODCALLTYPE CreateSwapChain(IUnknown* pDevice, DXGI_SWAP_CHAIN_DESC* pDesc, IDXGISwapChain** ppSwapChain) override;
-    HRESULT STDMETHODCALLTYPE CreateSoftwareAdapter(HMODULE Module, IDXGIAdapter** ppAdapter) override;
-
-    // IDXGIFactory1
     HRESULT STDMETHODCALLTYPE EnumAdapters1(UINT Adapter, IDXGIAdapter1** ppAdapter) override;
     BOOL STDMETHODCALLTYPE IsCurrent() override;
 
-    // IDXGIFactory2
-    BOOL STDMETHODCALLTYPE IsWindowedStereoEnabled() override;
-    HRESULT STDMETHODCALLTYPE CreateSwapChainForHwnd(IUnknown *pDevice, HWND hWnd, const DXGI_SWAP_CHAIN_DESC1 *pDesc, const DXGI_SWAP_CHAIN_FULLSCREEN_DESC *pFullscreenDesc, IDXGIOutput *pRestrictToOutput, IDXGISwapChain1 **ppSwapChain) override;
-    HRESULT STDMETHODCALLTYPE CreateSwapChainForCoreWindow(IUnknown *pDevice, IUnknown *pWindow, const DXGI_SWAP_CHAIN_DESC1 *pDesc, IDXGIOutput *pRestrictToOutput, IDXGISwapChain1 **ppSwapChain) override;
-    HRESULT STDMETHODCALLTYPE GetSharedResourceAdapterLuid(HANDLE hResource, LUID *pLuid) override;
-    
-    HRESULT STDMETHODCALLTYPE RegisterStereoStatusWindow(HWND WindowHandle, UINT wMsg, DWORD *pdwCookie) override;
-    HRESULT STDMETHODCALLTYPE RegisterStereoStatusEvent(HANDLE hEvent, DWORD *pdwCookie) override;
-    void STDMETHODCALLTYPE UnregisterStereoStatus(DWORD dwCookie) override;
-    
-    HRESULT STDMETHODCALLTYPE RegisterOcclusionStatusWindow(HWND WindowHandle, UINT wMsg, DWORD *pdwCookie) override;
-    HRESULT STDMETHODCALLTYPE RegisterOcclusionStatusEvent(HANDLE hEvent, DWORD *pdwCookie) override;
-    void STDMETHODCALLTYPE UnregisterOcclusionStatus(DWORD dwCookie) override;
-    
-    HRESULT STDMETHODCALLTYPE CreateSwapChainForComposition(IUnknown *pDevice, const DXGI_SWAP_CHAIN_DESC1 *pDesc, IDXGIOutput *pRestrictToOutput, IDXGISwapChain1 **ppSwapChain) override;
-
-    // IDXGIFactory3
-    UINT STDMETHODCALLTYPE GetCreationFlags() override;
-
-    // IDXGIFactory4
-    HRESULT STDMETHODCALLTYPE EnumAdapterByLuid(LUID AdapterLuid, REFIID riid, void **ppvAdapter) override;
-    HRESULT STDMETHODCALLTYPE EnumWarpAdapter(REFIID riid, void **ppvAdapter) override;
-
-    // IDXGIFactory5
-    HRESULT STDMETHODCALLTYPE CheckFeatureSupport(DXGI_FEATURE Feature, void *pFeatureSupportData, UINT FeatureSupportDataSize) override;
-
-    // IDXGIFactory6
-    HRESULT STDMETHODCALLTYPE EnumAdapterByGpuPreference(UINT Adapter, DXGI_GPU_PREFERENCE GpuPreference, REFIID riid, void **ppvAdapter) override;
+    // Window swap chains are wrapped to time their presents. CoreWindow and
+    // composition swap chains are forwarded as they are: DirectComposition's
+    // SetContent and the CoreWindow runtime only accept the runtime's own object.
+    HRESULT STDMETHODCALLTYPE CreateSwapChain(IUnknown* pDevice, DXGI_SWAP_CHAIN_DESC* pDesc, IDXGISwapChain** ppSwapChain) override;
+    HRESULT STDMETHODCALLTYPE CreateSwapChainForHwnd(IUnknown* pDevice, HWND hWnd, const DXGI_SWAP_CHAIN_DESC1* pDesc, const DXGI_SWAP_CHAIN_FULLSCREEN_DESC* pFullscreenDesc, IDXGIOutput* pRestrictToOutput, IDXGISwapChain1** ppSwapChain) override;
 };
 
-class ProxyDXGIAdapter : public IDXGIAdapter4 {
-    IDXGIAdapter4* m_pAdapter;
-    ULONG m_refCount;
+class ProxyDXGIAdapter final : public DXGIAdapterForwarder<ProxyDXGIAdapter, RcuReadPolicy> {
+    // Outputs as of one topology generation: interned wrappers for the real
+    // outputs, then the fake output if this adapter injects it. Immutable once
+    // published. Readers hold no lock, only an RcuDomain read section.
+    struct OutputList {
+        uint32_t generation;
+        std::vector<IDXGIOutput*> outputs; // One reference each
+    };
+
+    // A replaced output list or adapter, released once every read section
+    // that may still use it has ended
+    struct Retired {
+        const OutputList* list;
+        IDXGIAdapter4* adapter;
+        uint64_t epoch; // RcuDomain epoch started after it was unpublished
+    };
+
+    std::atomic<IDXGIAdapter4*> m_pAdapter;
     UINT m_adapterIndex;
 
+    std::atomic<const OutputList*> m_outputList{nullptr};
+    std::mutex m_rebuildMutex; // Serialises rebuilds and adapter swaps, guards m_retired
+    uint32_t m_adapterGeneration; // Topology generation m_pAdapter was enumerated in
+    std::vector<Retired> m_retired;
+
+    const OutputList* CurrentOutputs();
+    OutputList* BuildOutputList(uint32_t generation);
+    void RetireLocked(const OutputList* list, IDXGIAdapter4* adapter);
+    static void Free(const Retired& retired);
+
 public:
+    static constexpr const auto& kIids = kAdapterIids;
+
     ProxyDXGIAdapter(IDXGIAdapter4* pAdapter, UINT index);
-    virtual ~ProxyDXGIAdapter();
+    ~ProxyDXGIAdapter();
 
-    // IUnknown
-    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override;
-    ULONG STDMETHODCALLTYPE AddRef() override;
-    ULONG STDMETHODCALLTYPE Release() override;
+    IDXGIAdapter4* Real() const { return m_pAdapter.load(std::memory_order_acquire); }
 
-    // IDXGIObject
-    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID Name, UINT DataSize, const void* pData) override;
-    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID Name, const IUnknown* pUnknown) override;
-    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID Name, UINT* pDataSize, void* pData) override;
-    HRESULT STDMETHODCALLTYPE GetParent(REFIID riid, void** ppParent) override;
+    // Takes over pAdapter (and its reference) if the wrapped adapter predates
+    // the current topology generation. Returns false if the caller keeps it.
+    bool AdoptIfNewer(IDXGIAdapter4* pAdapter);
 
-    // IDXGIAdapter
+    // Other interfaces are asked of the wrapped adapter, inside a read section
+    HRESULT QueryOther(REFIID riid, void** ppvObject);
+
+    // Real outputs are wrapped, the fake outputs appended
     HRESULT STDMETHODCALLTYPE EnumOutputs(UINT Output, IDXGIOutput** ppOutput) override;
-    HRESULT STDMETHODCALLTYPE GetDesc(DXGI_ADAPTER_DESC* pDesc) override;
-    HRESULT STDMETHODCALLTYPE CheckInterfaceSupport(REFGUID InterfaceName, LARGE_INTEGER* pUMDVersion) override;
+};
+
+// A swap chain. Present and Present1 are timed into m_presents, listed in
+// g_SwapChainPresents while the swap chain lives, counted for the virtual
+// display its window belongs to, and into g_FrameCapture while it runs; the
+// rest is forwarded.
+class ProxyDXGISwapChain final : public DXGISwapChainForwarder<ProxyDXGISwapChain> {
+    IDXGISwapChain4* m_pSwapChain;
+    PresentStats m_presents;
+    uint32_t m_captureSource; // Numbers the swap chain's presents in a frame capture
+
+    void Record(const PresentRecord& record);
 
-    // IDXGIAdapter1
-    HRESULT STDMETHODCALLTYPE GetDesc1(DXGI_ADAPTER_DESC1* pDesc) override;
+public:
+    static constexpr const auto& kIids = kSwapChainIids;
+
+    ProxyDXGISwapChain(IDXGISwapChain4* pSwapChain, HWND window);
+    ~ProxyDXGISwapChain();
+
+    IDXGISwapChain4* Real() const { return m_pSwapChain; }
+    const PresentStats& Presents() const { return m_presents; }
+
+    HRESULT STDMETHODCALLTYPE Present(UINT SyncInterval, UINT Flags) override;
+    HRESULT STDMETHODCALLTYPE Present1(UINT SyncInterval, UINT PresentFlags, const DXGI_PRESENT_PARAMETERS* pPresentParameters) override;
+};
+
+// A real output. Everything is forwarded; the hooked methods are timed.
+class ProxyDXGIOutput final : public DXGIOutputForwarder<ProxyDXGIOutput, HookStatsPolicy> {
+    IDXGIOutput6* m_pOutput;
 
-    // IDXGIAdapter2
-    HRESULT STDMETHODCALLTYPE GetDesc2(DXGI_ADAPTER_DESC2* pDesc) override;
+public:
+    static constexpr const auto& kIids = kOutputIids;
 
-    // IDXGIAdapter3
-    HRESULT STDMETHODCALLTYPE RegisterHardwareContentProtectionTeardownStatusEvent(HANDLE hEvent, DWORD *pdwCookie) override;
-    void STDMETHODCALLTYPE UnregisterHardwareContentProtectionTeardownStatus(DWORD dwCookie) override;
-    HRESULT STDMETHODCALLTYPE QueryVideoMemoryInfo(UINT NodeIndex, DXGI_MEMORY_SEGMENT_GROUP MemorySegmentGroup, DXGI_QUERY_VIDEO_MEMORY_INFO *pVideoMemoryInfo) override;
-    HRESULT STDMETHODCALLTYPE SetVideoMemoryReservation(UINT NodeIndex, DXGI_MEMORY_SEGMENT_GROUP MemorySegmentGroup, UINT64 Reservation) override;
-    HRESULT STDMETHODCALLTYPE RegisterVideoMemoryBudgetChangeNotificationEvent(HANDLE hEvent, DWORD *pdwCookie) override;
-    void STDMETHODCALLTYPE UnregisterVideoMemoryBudgetChangeNotification(DWORD dwCookie) override;
+    explicit ProxyDXGIOutput(IDXGIOutput6* pOutput) : m_pOutput(pOutput) {}
+    ~ProxyDXGIOutput() { m_pOutput->Release(); }
 
-    // IDXGIAdapter4
-    HRESULT STDMETHODCALLTYPE GetDesc3(DXGI_ADAPTER_DESC3 *pDesc) override;
+    IDXGIOutput6* Real() const { return m_pOutput; }
 };
 
-class ProxyDXGIOutput : public IDXGIOutput6 {
-    IDXGIOutput6* m_pOutput; // Can be null if it's our fake output
-    ULONG m_refCount;
-    bool m_isFake;
+// The output of a virtual display. Nothing is wrapped: every method answers
+// from g_VirtualDisplays, the fake mode table and the display's g_VirtualVBlank.
+class FakeDXGIOutput final : public ComProxy<FakeDXGIOutput, IDXGIOutput6> {
+    size_t m_virtualDisplay; // Index in g_VirtualDisplays
 
 public:
-    ProxyDXGIOutput(IDXGIOutput6* pOutput, bool isFake = false);
-    virtual ~ProxyDXGIOutput();
+    static constexpr const auto& kIids = kOutputIids;
+
+    explicit FakeDXGIOutput(size_t virtualDisplay);
+    ~FakeDXGIOutput();
 
-    // IUnknown
-    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override;
-    ULONG STDMETHODCALLTYPE AddRef() override;
-    ULONG STDMETHODCALLTYPE Release() override;
+    // Interfaces besides the output's own are not supported
+    HRESULT QueryOther(REFIID riid, void** ppvObject);
 
     // IDXGIObject
     HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID Name, UINT DataSize, const void* pData) override;
@@ -0,0 +1,49 @@
+#include "follow_latency.hpp"
+#include "percentile.hpp"
+#include <algorithm>
+
+void FollowLatency::RecordFollow(uint64_t latencyNs, bool fromEvent) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counts.follows++;
+    if (fromEvent) m_counts.fromEvents++;
+    m_counts.maxNs = std::max(m_counts.maxNs, (double)latencyNs);
+    if (m_samples.size() < kCapacity) {
+        m_samples.push_back(latencyNs);
+    } else {
+        m_samples[m_next] = latencyNs;
+        m_next = (m_next + 1) % kCapacity;
+    }
+}
+
+void FollowLatency::RecordInPlace() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counts.inPlace++;
+}
+
+void FollowLatency::RecordMissed() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counts.missed++;
+}
+
+FollowSummary FollowLatency::Summarize() const {
+    std::vector<uint64_t> sorted;
+    FollowSummary summary;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        summary = m_counts;
+        sorted = m_samples;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    summary.window = sorted.size();
+    summary.p50Ns = Percentile(sorted, 0.50);
+    summary.p90Ns = Percentile(sorted, 0.90);
+    summary.p99Ns = Percentile(sorted, 0.99);
+    return summary;
+}
+
+void FollowLatency::Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counts = {};
+    m_samples.clear();
+    m_next = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+struct FollowSummary {
+    uint64_t follows = 0;    // Overlay moves that followed a target move
+    uint64_t fromEvents = 0; // Of those, timed from the target's move event; the rest from the apply that saw the move
+    uint64_t inPlace = 0;    // Target moves that left the overlay where it belonged (within 2 px)
+    uint64_t missed = 0;     // Target moves not followed: no overlay, or moving it failed
+    size_t window = 0;       // Follows the percentiles cover
+    double p50Ns = 0;
+    double p90Ns = 0;
+    double p99Ns = 0;
+    double maxNs = 0; // Since the last reset
+};
+
+// Move-to-follow latency in Position mode: from a target window moving to its
+// overlay being moved beside it. The layout engine pairs each move of a
+// target with the overlay move that answers it and records the delay here;
+// percentiles cover the latest kCapacity follows. Written on the tracker
+// thread, summarized from any; a mutex is enough at window-move rates.
+class FollowLatency {
+public:
+    static constexpr size_t kCapacity = 1024;
+
+    void RecordFollow(uint64_t latencyNs, bool fromEvent);
+    void RecordInPlace();
+    void RecordMissed();
+
+    FollowSummary Summarize() const;
+    void Reset();
+
+private:
+    mutable std::mutex m_mutex;
+    FollowSummary m_counts; // Counters and max; percentiles filled in by Summarize
+    std::vector<uint64_t> m_samples;
+    size_t m_next = 0; // Ring position once m_samples is full
+};
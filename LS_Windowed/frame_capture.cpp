@@ -0,0 +1,86 @@
+#include "frame_capture.hpp"
+#include "vblank_clock.hpp"
+#include <chrono>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t kRecordOffset = 64; // Header rounded up to a cache line
+
+} // namespace
+
+bool FrameCapture::Start(const std::filesystem::path& path, uint64_t vblankPeriodNs, uint64_t capacity) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    StopLocked();
+    if (m_records) return false; // An append is still writing into the previous mapping
+    static_assert(sizeof(FrameCaptureHeader) <= kRecordOffset, "header overlaps the records");
+    if (!capacity || !m_file.Create(path, kRecordOffset + capacity * sizeof(FrameRecord))) return false;
+
+    m_path = path;
+    m_header = reinterpret_cast<FrameCaptureHeader*>(m_file.Data());
+    m_header->magic = kFrameCaptureMagic;
+    m_header->version = kFrameCaptureVersion;
+    m_header->flags = 0;
+    m_header->steadyBaseNs = VBlankClock::NowNs();
+    m_header->unixBaseNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+    m_header->vblankPeriodNs = vblankPeriodNs;
+    m_header->recordOffset = kRecordOffset;
+    m_header->recordSize = sizeof(FrameRecord);
+    m_header->recordCapacity = capacity;
+    m_header->recordCount = 0;
+    m_header->dropped = 0;
+
+    m_records = reinterpret_cast<FrameRecord*>(m_file.Data() + kRecordOffset);
+    m_capacity = capacity;
+    m_next.store(0, std::memory_order_relaxed);
+    m_active.store(true, std::memory_order_seq_cst);
+    return true;
+}
+
+void FrameCapture::Stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    StopLocked();
+}
+
+void FrameCapture::StopLocked() {
+    if (!m_records) return;
+    m_active.store(false, std::memory_order_seq_cst);
+
+    // An append that saw the capture active finishes within microseconds.
+    // From DllMain at process exit its thread may already be gone; then the
+    // mapping is left to the exit rather than pulled from under it, and a
+    // later Stop() or Start() tries again to release it.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (m_writers.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    bool idle = m_writers.load(std::memory_order_acquire) == 0;
+
+    if (m_header) {
+        m_header->recordCount = Records();
+        m_header->dropped = Dropped();
+        m_header->flags |= kFrameCaptureComplete;
+        m_used = kRecordOffset + m_header->recordCount * sizeof(FrameRecord);
+        m_header = nullptr;
+        m_file.Flush();
+    }
+    if (!idle) return;
+
+    m_records = nullptr;
+    m_file.Close();
+    std::error_code error;
+    std::filesystem::resize_file(m_path, m_used, error); // Best effort; readers go by recordCount
+}
+
+uint64_t FrameCapture::Records() const {
+    uint64_t next = m_next.load(std::memory_order_relaxed);
+    return next < m_capacity ? next : m_capacity;
+}
+
+uint64_t FrameCapture::Dropped() const {
+    uint64_t next = m_next.load(std::memory_order_relaxed);
+    return next > m_capacity ? next - m_capacity : 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include "mapped_file.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+// Frame capture format. A capture is an append-only file of fixed-size
+// records written through a memory mapping, read offline with ls_framecap:
+//   FrameCaptureHeader
+//   records: FrameRecord[recordCapacity] from recordOffset, in the order
+//            they were claimed (roughly, not strictly, time order)
+// A record's kind is stored last, so a record the process was writing when
+// it crashed reads as FrameEventKind::None and is skipped. Stop() shrinks the
+// file to the records written.
+
+constexpr uint32_t kFrameCaptureMagic = 0x4346534C; // "LSFC"
+constexpr uint16_t kFrameCaptureVersion = 2; // 2: 32-bit source, durationNs moved into FramePresent
+
+// Set in FrameCaptureHeader::flags by Stop(); missing after a crash, in which
+// case recordCount is 0 and readers scan every record
+constexpr uint16_t kFrameCaptureComplete = 0x0001;
+
+struct FrameCaptureHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint64_t steadyBaseNs;   // steady clock reading when the capture started...
+    uint64_t unixBaseNs;     // ...and the wall-clock time at that moment
+    uint64_t vblankPeriodNs; // Virtual display refresh period at the start
+    uint32_t recordOffset;
+    uint32_t recordSize;
+    uint64_t recordCapacity;
+    uint64_t recordCount;
+    uint64_t dropped; // Records lost because the file was full
+};
+
+enum class FrameEventKind : uint8_t {
+    None = 0, // Never written, or torn by a crash
+    Present = 1,
+    TargetRect = 2,  // A target window's client rect changed
+    OverlayMove = 3, // An LS overlay was moved next to its target (Position mode)
+};
+
+struct FramePresent {
+    uint64_t vblank;     // Virtual vblank count when the call was made
+    uint32_t durationNs; // Time spent inside the runtime
+    uint8_t syncInterval;
+    uint8_t failed;
+    uint8_t present1;
+    uint8_t reserved;
+};
+
+struct FrameRect {
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+};
+
+struct FrameRecord {
+    uint64_t timeNs; // steady clock
+    FrameEventKind kind;
+    uint8_t reserved;
+    uint16_t flags;  // Present: DXGI_PRESENT_* flags
+    uint32_t source; // Present: swap chain number; layout events: virtual display
+    union {
+        FramePresent present;
+        FrameRect rect;
+    };
+};
+static_assert(sizeof(FrameRecord) == 32, "the capture format fixes the record size");
+
+// Writes one capture at a time. Append() is lock-free and safe from any
+// thread; while no capture runs it costs one atomic increment and load.
+// Start() and Stop() may be called from any thread, Stop() also from DllMain:
+// it waits briefly for appends in flight and never joins a thread.
+class FrameCapture {
+public:
+    static constexpr uint64_t kDefaultCapacity = 1 << 20; // 32 MB; over an hour of presents at 240 fps
+
+    FrameCapture() = default;
+    ~FrameCapture() { Stop(); }
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Creates (or truncates) the file at path; a running capture is stopped
+    // first. Fails while an append is still writing into the previous mapping.
+    bool Start(const std::filesystem::path& path, uint64_t vblankPeriodNs, uint64_t capacity = kDefaultCapacity);
+    void Stop();
+
+    bool IsActive() const { return m_active.load(std::memory_order_relaxed); }
+
+    void Append(const FrameRecord& record) {
+        m_writers.fetch_add(1, std::memory_order_seq_cst);
+        if (m_active.load(std::memory_order_seq_cst)) {
+            uint64_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+            if (index < m_capacity) {
+                FrameRecord& slot = m_records[index];
+                FrameRecord body = record;
+                body.kind = FrameEventKind::None;
+                std::memcpy(&slot, &body, sizeof(slot));
+                // The file is only read once the process is done with it; the
+                // ordering matters only for a crash in the middle of a record
+                std::atomic_signal_fence(std::memory_order_release);
+                slot.kind = record.kind;
+            }
+        }
+        m_writers.fetch_sub(1, std::memory_order_release);
+    }
+
+    // Of the running capture, or of the last one once stopped
+    uint64_t Records() const;
+    uint64_t Dropped() const;
+    const std::filesystem::path& Path() const { return m_path; }
+
+private:
+    void StopLocked();
+
+    std::mutex m_mutex; // Start and Stop
+    MappedFile m_file;
+    std::filesystem::path m_path;
+    FrameCaptureHeader* m_header = nullptr;
+    FrameRecord* m_records = nullptr; // Set while the mapping is open, even after a stop that timed out
+    uint64_t m_used = 0;              // File size the stopped capture is trimmed to
+    uint64_t m_capacity = 0;
+    std::atomic<bool> m_active{false};
+    std::atomic<uint32_t> m_writers{0};
+    std::atomic<uint64_t> m_next{0};
+};
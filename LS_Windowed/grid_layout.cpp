@@ -0,0 +1,125 @@
+#include "grid_layout.hpp"
+#include <cstdlib>
+
+namespace {
+
+// Reads a decimal number and advances text; false if there is none
+bool ReadNumber(const char*& text, int* value) {
+    char* end = nullptr;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || parsed < 0 || parsed > 255) return false;
+    *value = (int)parsed;
+    text = end;
+    return true;
+}
+
+bool Expect(const char*& text, char c) {
+    if (*text != c) return false;
+    text++;
+    return true;
+}
+
+int32_t TrackEdge(int32_t size, int index, int count) {
+    return (int32_t)((int64_t)size * index / count);
+}
+
+} // namespace
+
+GridLayout GridLayout::Uniform(int columns, int rows) {
+    GridLayout layout;
+    layout.columns = (uint8_t)columns;
+    layout.rows = (uint8_t)rows;
+    layout.cellCount = (uint8_t)(columns * rows);
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            layout.cells[row * columns + column] = {(uint8_t)column, (uint8_t)row, 1, 1};
+        }
+    }
+    return layout;
+}
+
+bool GridLayout::operator==(const GridLayout& other) const {
+    if (columns != other.columns || rows != other.rows || cellCount != other.cellCount) return false;
+    for (int i = 0; i < cellCount; i++) {
+        if (!(cells[i] == other.cells[i])) return false;
+    }
+    return true;
+}
+
+bool ParseGridLayout(const char* text, GridLayout* layout) {
+    if (!text) return false;
+    int columns, rows;
+    if (!ReadNumber(text, &columns) || !(Expect(text, 'x') || Expect(text, 'X')) || !ReadNumber(text, &rows)) {
+        return false;
+    }
+    if (columns < 1 || columns > kMaxGridDimension || rows < 1 || rows > kMaxGridDimension) return false;
+    if (!*text) {
+        *layout = GridLayout::Uniform(columns, rows);
+        return true;
+    }
+    if (!Expect(text, ':')) return false;
+
+    GridLayout parsed;
+    parsed.columns = (uint8_t)columns;
+    parsed.rows = (uint8_t)rows;
+    parsed.cellCount = 0;
+    uint32_t occupied = 0; // One bit per track intersection
+    for (;;) {
+        int column, row, columnSpan, rowSpan;
+        if (parsed.cellCount == kMaxGridCells || !ReadNumber(text, &column) || !Expect(text, ',') ||
+            !ReadNumber(text, &row) || !Expect(text, ',') || !ReadNumber(text, &columnSpan) || !Expect(text, ',') ||
+            !ReadNumber(text, &rowSpan)) {
+            return false;
+        }
+        if (columnSpan < 1 || rowSpan < 1 || column + columnSpan > columns || row + rowSpan > rows) return false;
+        for (int r = row; r < row + rowSpan; r++) {
+            for (int c = column; c < column + columnSpan; c++) {
+                uint32_t bit = 1u << (r * kMaxGridDimension + c);
+                if (occupied & bit) return false;
+                occupied |= bit;
+            }
+        }
+        parsed.cells[parsed.cellCount++] = {(uint8_t)column, (uint8_t)row, (uint8_t)columnSpan, (uint8_t)rowSpan};
+        if (!*text) break;
+        if (!Expect(text, ';')) return false;
+    }
+    *layout = parsed;
+    return true;
+}
+
+std::string FormatGridLayout(const GridLayout& layout) {
+    std::string text = std::to_string(layout.columns) + "x" + std::to_string(layout.rows);
+    if (layout == GridLayout::Uniform(layout.columns, layout.rows)) return text;
+    for (int i = 0; i < layout.cellCount; i++) {
+        const GridCell& cell = layout.cells[i];
+        text += i ? ";" : ":";
+        text += std::to_string(cell.column) + "," + std::to_string(cell.row) + "," +
+                std::to_string(cell.columnSpan) + "," + std::to_string(cell.rowSpan);
+    }
+    return text;
+}
+
+GridLayout LegacySplitGrid(int splitType, int* cell) {
+    *cell = splitType == 1 || splitType == 3 ? 1 : 0;
+    return splitType == 2 || splitType == 3 ? GridLayout::Uniform(1, 2) : GridLayout::Uniform(2, 1);
+}
+
+bool GridCellRect(const GridLayout& layout, int cell, int32_t width, int32_t height, LayoutRect* rect) {
+    if (cell < 0 || cell >= layout.cellCount) return false;
+    const GridCell& c = layout.cells[cell];
+    rect->left = TrackEdge(width, c.column, layout.columns);
+    rect->top = TrackEdge(height, c.row, layout.rows);
+    rect->right = TrackEdge(width, c.column + c.columnSpan, layout.columns);
+    rect->bottom = TrackEdge(height, c.row + c.rowSpan, layout.rows);
+    return true;
+}
+
+bool GridTemplate::Update(const GridLayout& layout, int32_t width, int32_t height) {
+    if (Matches(layout, width, height)) return false;
+    m_layout = layout;
+    m_width = width;
+    m_height = height;
+    for (int i = 0; i < layout.cellCount; i++) GridCellRect(layout, i, width, height, &m_cells[i]);
+    m_valid = true;
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "layout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+constexpr int kMaxGridDimension = 4;
+constexpr size_t kMaxGridCells = kMaxGridDimension * kMaxGridDimension;
+
+// A cell of a split grid, in grid units: it covers columns
+// [column, column + columnSpan) and rows [row, row + rowSpan).
+struct GridCell {
+    uint8_t column = 0;
+    uint8_t row = 0;
+    uint8_t columnSpan = 1;
+    uint8_t rowSpan = 1;
+
+    bool operator==(const GridCell& other) const {
+        return column == other.column && row == other.row && columnSpan == other.columnSpan &&
+               rowSpan == other.rowSpan;
+    }
+};
+
+// Split layout: the overlay is divided into columns x rows equal tracks and
+// shows one cell of it. Cells are listed in reading order; by default every
+// track intersection is a cell, custom layouts merge tracks with spans.
+//
+// Text form (config.ini): "CxR" for a uniform grid, or "CxR:c,r,w,h;..." with
+// one column,row,columnSpan,rowSpan group per cell, e.g. "3x2:0,0,2,2;2,0,1,1;2,1,1,1"
+// for one large cell and two small ones beside it.
+struct GridLayout {
+    uint8_t columns = 2;
+    uint8_t rows = 1;
+    uint8_t cellCount = 2;
+    GridCell cells[kMaxGridCells] = {{0, 0, 1, 1}, {1, 0, 1, 1}};
+
+    static GridLayout Uniform(int columns, int rows);
+
+    bool operator==(const GridLayout& other) const;
+    bool operator!=(const GridLayout& other) const { return !(*this == other); }
+};
+
+// Parses the text form; cells must lie inside the grid and not overlap.
+// Returns false (leaving layout untouched) if text is not a valid layout.
+bool ParseGridLayout(const char* text, GridLayout* layout);
+std::string FormatGridLayout(const GridLayout& layout);
+
+// The pre-grid split types (0: Left half, 1: Right, 2: Top, 3: Bottom) as a
+// grid and the cell it shows
+GridLayout LegacySplitGrid(int splitType, int* cell);
+
+// Rect of a cell of a width x height overlay, relative to its upper-left
+// corner. Track edges are rounded down, so neighbouring cells share edges and
+// the cells of a grid tile the overlay exactly. Returns false for a cell index
+// outside the layout.
+bool GridCellRect(const GridLayout& layout, int cell, int32_t width, int32_t height, LayoutRect* rect);
+
+// Every cell rect of a layout for one overlay size, computed once and reused
+// while neither changes.
+class GridTemplate {
+public:
+    // Returns true if the rects were rebuilt
+    bool Update(const GridLayout& layout, int32_t width, int32_t height);
+
+    bool Matches(const GridLayout& layout, int32_t width, int32_t height) const {
+        return m_valid && m_width == width && m_height == height && m_layout == layout;
+    }
+    const LayoutRect* Cell(int cell) const {
+        return cell >= 0 && cell < m_layout.cellCount ? &m_cells[cell] : nullptr;
+    }
+
+private:
+    bool m_valid = false;
+    GridLayout m_layout;
+    int32_t m_width = 0;
+    int32_t m_height = 0;
+    LayoutRect m_cells[kMaxGridCells];
+};
@@ -0,0 +1,135 @@
+#include "hook_stats.hpp"
+#include <chrono>
+#include <mutex>
+
+thread_local HookStats::ThreadBlock* HookStats::t_block = nullptr;
+std::atomic<uint32_t> HookStats::s_epoch{0};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Totals {
+    uint64_t calls = 0;
+    uint64_t buckets[HookStats::kBuckets] = {};
+};
+
+std::atomic<HookStats::ThreadBlock*> g_Blocks{nullptr};
+
+// Guards the baseline and the reset time
+std::mutex g_ResetMutex;
+Totals g_Baseline[kHookCount];
+Clock::time_point g_ResetTime = Clock::now();
+
+// Tick rate calibration: ticks and wall time at load, compared at read time
+const uint64_t g_CalibrationTicks = HookStats::Now();
+const Clock::time_point g_CalibrationTime = Clock::now();
+
+double NsPerTick() {
+    double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - g_CalibrationTime).count();
+    uint64_t elapsedTicks = HookStats::Now() - g_CalibrationTicks;
+    return elapsedTicks ? elapsedNs / (double)elapsedTicks : 1.0;
+}
+
+void SumBlocks(Totals (&out)[kHookCount]) {
+    for (auto& totals : out) totals = Totals();
+    for (HookStats::ThreadBlock* block = g_Blocks.load(std::memory_order_acquire); block; block = block->next) {
+        for (size_t hook = 0; hook < kHookCount; hook++) {
+            const HookStats::Counters& counters = block->hooks[hook];
+            out[hook].calls += counters.calls.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < HookStats::kBuckets; i++) {
+                out[hook].buckets[i] += counters.buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+double Percentile(const uint64_t (&buckets)[HookStats::kBuckets], double p, double nsPerTick) {
+    // Counted from the buckets themselves: calls and buckets are read at
+    // slightly different moments while threads keep recording
+    uint64_t count = 0;
+    for (uint64_t bucket : buckets) count += bucket;
+    if (!count) return 0.0;
+    uint64_t rank = (uint64_t)(p * (double)(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HookStats::kBuckets; i++) {
+        seen += buckets[i];
+        if (seen >= rank) return (double)(2ull << i) * nsPerTick;
+    }
+    return (double)(2ull << (HookStats::kBuckets - 1)) * nsPerTick;
+}
+
+} // namespace
+
+const char* HookName(HookId hook) {
+    switch (hook) {
+    case HookId::EnumDisplayMonitors: return "EnumDisplayMonitors";
+    case HookId::GetMonitorInfoW: return "GetMonitorInfoW";
+    case HookId::CreateDXGIFactory1: return "CreateDXGIFactory1";
+    case HookId::AdapterEnumOutputs: return "Adapter::EnumOutputs";
+    case HookId::OutputGetDesc: return "Output::GetDesc";
+    case HookId::OutputGetDesc1: return "Output::GetDesc1";
+    case HookId::OutputGetDisplayModeList: return "Output::GetDisplayModeList";
+    case HookId::OutputGetDisplayModeList1: return "Output::GetDisplayModeList1";
+    case HookId::OutputFindClosestMatchingMode: return "Output::FindClosestMatchingMode";
+    case HookId::OutputFindClosestMatchingMode1: return "Output::FindClosestMatchingMode1";
+    case HookId::OutputWaitForVBlank: return "Output::WaitForVBlank";
+    case HookId::OutputGetFrameStatistics: return "Output::GetFrameStatistics";
+    case HookId::Count: break;
+    }
+    return "?";
+}
+
+HookStats::ThreadBlock* HookStats::RegisterThread() {
+    ThreadBlock* block = new ThreadBlock();
+    block->epoch.store(s_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    block->next = g_Blocks.load(std::memory_order_relaxed);
+    while (!g_Blocks.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    t_block = block;
+    return block;
+}
+
+void HookStats::ResetMaxima(ThreadBlock* block, uint32_t epoch) {
+    for (Counters& counters : block->hooks) counters.maxTicks.store(0, std::memory_order_relaxed);
+    block->epoch.store(epoch, std::memory_order_relaxed);
+}
+
+void HookStats::Summarize(HookSummary (&out)[kHookCount]) {
+    static Totals current[kHookCount];
+    std::lock_guard<std::mutex> lock(g_ResetMutex);
+    SumBlocks(current);
+
+    double nsPerTick = NsPerTick();
+    double seconds = std::chrono::duration<double>(Clock::now() - g_ResetTime).count();
+    uint32_t epoch = s_epoch.load(std::memory_order_relaxed);
+
+    for (size_t hook = 0; hook < kHookCount; hook++) {
+        Totals window;
+        window.calls = current[hook].calls - g_Baseline[hook].calls;
+        for (size_t i = 0; i < kBuckets; i++) window.buckets[i] = current[hook].buckets[i] - g_Baseline[hook].buckets[i];
+
+        // Maxima are zeroed lazily by each thread on its first call after a
+        // reset; blocks still on an older epoch have not recorded since
+        uint64_t maxTicks = 0;
+        for (ThreadBlock* block = g_Blocks.load(std::memory_order_acquire); block; block = block->next) {
+            if (block->epoch.load(std::memory_order_relaxed) != epoch) continue;
+            uint64_t ticks = block->hooks[hook].maxTicks.load(std::memory_order_relaxed);
+            if (ticks > maxTicks) maxTicks = ticks;
+        }
+
+        HookSummary& summary = out[hook];
+        summary.calls = window.calls;
+        summary.callsPerSecond = seconds > 0.0 ? (double)window.calls / seconds : 0.0;
+        summary.p50Ns = Percentile(window.buckets, 0.50, nsPerTick);
+        summary.p99Ns = Percentile(window.buckets, 0.99, nsPerTick);
+        summary.maxNs = (double)maxTicks * nsPerTick;
+    }
+}
+
+void HookStats::Reset() {
+    std::lock_guard<std::mutex> lock(g_ResetMutex);
+    SumBlocks(g_Baseline);
+    g_ResetTime = Clock::now();
+    s_epoch.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Call counters and latency histograms for the hooked APIs and the DXGI proxy
+// overrides. Each thread records into its own block with plain relaxed stores,
+// so a sample costs a timestamp read and a handful of increments; readers merge
+// the blocks. With LS_HOOK_STATS set to 0 (CMake option LS_WINDOWED_HOOK_STATS)
+// LS_HOOK_TIMER compiles to nothing.
+#ifndef LS_HOOK_STATS
+#define LS_HOOK_STATS 1
+#endif
+
+enum class HookId : uint8_t {
+    EnumDisplayMonitors,
+    GetMonitorInfoW,
+    CreateDXGIFactory1,
+    AdapterEnumOutputs,
+    OutputGetDesc,
+    OutputGetDesc1,
+    OutputGetDisplayModeList,
+    OutputGetDisplayModeList1,
+    OutputFindClosestMatchingMode,
+    OutputFindClosestMatchingMode1,
+    OutputWaitForVBlank,
+    OutputGetFrameStatistics,
+    Count
+};
+
+constexpr size_t kHookCount = (size_t)HookId::Count;
+
+const char* HookName(HookId hook);
+
+struct HookSummary {
+    uint64_t calls = 0;
+    double callsPerSecond = 0.0;
+    double p50Ns = 0.0; // Percentiles are bucket upper bounds (within 2x)
+    double p99Ns = 0.0;
+    double maxNs = 0.0;
+};
+
+class HookStats {
+public:
+    static constexpr size_t kBuckets = 48; // Bucket i counts samples of [2^i, 2^(i+1)) ticks
+
+    struct Counters {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> maxTicks{0};
+        std::atomic<uint64_t> buckets[kBuckets] = {};
+    };
+
+    // One per thread that has recorded a sample. Never freed, so counts from
+    // exited threads stay in the totals.
+    struct ThreadBlock {
+        std::atomic<uint32_t> epoch{0}; // Reset generation the maxima belong to
+        Counters hooks[kHookCount];
+        ThreadBlock* next = nullptr;
+    };
+
+    // Raw timestamp ticks: the TSC where available, nanoseconds otherwise
+    static uint64_t Now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    static void Record(HookId hook, uint64_t ticks) {
+        ThreadBlock* block = t_block ? t_block : RegisterThread();
+        uint32_t epoch = s_epoch.load(std::memory_order_relaxed);
+        if (block->epoch.load(std::memory_order_relaxed) != epoch) ResetMaxima(block, epoch);
+
+        // Only the owning thread writes its block; load + store avoids locked
+        // read-modify-write instructions
+        Counters& counters = block->hooks[(size_t)hook];
+        counters.calls.store(counters.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic<uint64_t>& bucket = counters.buckets[BucketOf(ticks)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (ticks > counters.maxTicks.load(std::memory_order_relaxed)) {
+            counters.maxTicks.store(ticks, std::memory_order_relaxed);
+        }
+    }
+
+    // Merges every thread block, minus the totals at the last Reset()
+    static void Summarize(HookSummary (&out)[kHookCount]);
+
+    // Starts a new measurement window. Thread-safe.
+    static void Reset();
+
+private:
+    static size_t BucketOf(uint64_t ticks) {
+        if (ticks < 2) return 0;
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, ticks);
+#else
+        unsigned index = 63 - (unsigned)__builtin_clzll(ticks);
+#endif
+        return index < kBuckets ? index : kBuckets - 1;
+    }
+
+    static ThreadBlock* RegisterThread();
+    static void ResetMaxima(ThreadBlock* block, uint32_t epoch);
+
+    static thread_local ThreadBlock* t_block;
+    static std::atomic<uint32_t> s_epoch;
+};
+
+// Times the rest of the enclosing scope.
+class HookTimer {
+public:
+    explicit HookTimer(HookId hook) : m_hook(hook), m_start(HookStats::Now()) {}
+    ~HookTimer() { HookStats::Record(m_hook, HookStats::Now() - m_start); }
+    HookTimer(const HookTimer&) = delete;
+    HookTimer& operator=(const HookTimer&) = delete;
+
+private:
+    HookId m_hook;
+    uint64_t m_start;
+};
+
+#if LS_HOOK_STATS
+#define LS_HOOK_TIMER(hook) HookTimer lsHookTimer_(hook)
+#else
+#define LS_HOOK_TIMER(hook) ((void)0)
+#endif
+
+// A HookTimer chosen at compile time, for call policies of the proxy
+// forwarders (com_proxy.hpp). HookId::Count times nothing.
+template <HookId Hook>
+struct HookScope {
+#if LS_HOOK_STATS
+    HookTimer timer{Hook};
+#endif
+};
+
+template <>
+struct HookScope<HookId::Count> {};
@@ -0,0 +1,226 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Interface ids the DXGI proxies recognise, as compile-time constants so the
+// lookup tables below are built by the compiler. Kept free of Windows headers
+// (__uuidof is not usable in constant expressions); dxgi_proxy.cpp checks the
+// values against the SDK's with CheckIidTables().
+
+// A GUID as two words, the way its 16 bytes sit in memory on the
+// little-endian targets Windows runs on
+struct IidKey {
+    uint64_t lo = ~0ull; // Data1, Data2, Data3
+    uint64_t hi = ~0ull; // Data4
+
+    bool operator==(const IidKey& other) const { return lo == other.lo && hi == other.hi; }
+
+    // Built field by field rather than copied, since the defaults above make
+    // IidKey non-trivial; compilers fold it into two 64-bit loads
+    template <class Guid>
+    static IidKey Of(const Guid& guid) {
+        static_assert(sizeof(Guid) == sizeof(IidKey), "GUIDs are 16 bytes");
+        IidKey key;
+        key.lo = (uint64_t)guid.Data1 | (uint64_t)guid.Data2 << 32 | (uint64_t)guid.Data3 << 48;
+        key.hi = 0;
+        for (int i = 0; i < 8; i++) key.hi |= (uint64_t)(uint8_t)guid.Data4[i] << (8 * i);
+        return key;
+    }
+};
+
+constexpr IidKey MakeIid(uint32_t data1, uint16_t data2, uint16_t data3, uint8_t b0, uint8_t b1, uint8_t b2,
+                         uint8_t b3, uint8_t b4, uint8_t b5, uint8_t b6, uint8_t b7) {
+    IidKey key;
+    key.lo = (uint64_t)data1 | (uint64_t)data2 << 32 | (uint64_t)data3 << 48;
+    key.hi = (uint64_t)b0 | (uint64_t)b1 << 8 | (uint64_t)b2 << 16 | (uint64_t)b3 << 24 | (uint64_t)b4 << 32 |
+             (uint64_t)b5 << 40 | (uint64_t)b6 << 48 | (uint64_t)b7 << 56;
+    return key;
+}
+
+enum class DxgiIid : uint8_t {
+    IUnknown,
+    IDXGIObject,
+    IDXGIFactory,
+    IDXGIFactory1,
+    IDXGIFactory2,
+    IDXGIFactory3,
+    IDXGIFactory4,
+    IDXGIFactory5,
+    IDXGIFactory6,
+    IDXGIAdapter,
+    IDXGIAdapter1,
+    IDXGIAdapter2,
+    IDXGIAdapter3,
+    IDXGIAdapter4,
+    IDXGIOutput,
+    IDXGIOutput1,
+    IDXGIOutput2,
+    IDXGIOutput3,
+    IDXGIOutput4,
+    IDXGIOutput5,
+    IDXGIOutput6,
+    IDXGIDeviceSubObject,
+    IDXGISwapChain,
+    IDXGISwapChain1,
+    IDXGISwapChain2,
+    IDXGISwapChain3,
+    IDXGISwapChain4,
+    Count
+};
+
+constexpr size_t kDxgiIidCount = (size_t)DxgiIid::Count;
+
+struct DxgiIidInfo {
+    IidKey key;
+    const char* name;
+};
+
+// Indexed by DxgiIid
+inline constexpr DxgiIidInfo kDxgiIids[kDxgiIidCount] = {
+    {MakeIid(0x00000000, 0x0000, 0x0000, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46), "IUnknown"},
+    {MakeIid(0xaec22fb8, 0x76f3, 0x4639, 0x9b, 0xe0, 0x28, 0xeb, 0x43, 0xa6, 0x7a, 0x2e), "IDXGIObject"},
+    {MakeIid(0x7b7166ec, 0x21c7, 0x44ae, 0xb2, 0x1a, 0xc9, 0xae, 0x32, 0x1a, 0xe3, 0x69), "IDXGIFactory"},
+    {MakeIid(0x770aae78, 0xf26f, 0x4dba, 0xa8, 0x29, 0x25, 0x3c, 0x83, 0xd1, 0xb3, 0x87), "IDXGIFactory1"},
+    {MakeIid(0x50c83a1c, 0xe072, 0x4c48, 0x87, 0xb0, 0x36, 0x30, 0xfa, 0x36, 0xa6, 0xd0), "IDXGIFactory2"},
+    {MakeIid(0x25483823, 0xcd46, 0x4c7d, 0x86, 0xca, 0x47, 0xaa, 0x95, 0xb8, 0x37, 0xbd), "IDXGIFactory3"},
+    {MakeIid(0x1bc6ea02, 0xef36, 0x464f, 0xbf, 0x0c, 0x21, 0xca, 0x39, 0xe5, 0x16, 0x8a), "IDXGIFactory4"},
+    {MakeIid(0x7632e1f5, 0xee65, 0x4dca, 0x87, 0xfd, 0x84, 0xcd, 0x75, 0xf8, 0x83, 0x8d), "IDXGIFactory5"},
+    {MakeIid(0xc1b6694f, 0xff09, 0x44a9, 0xb0, 0x3c, 0x77, 0x90, 0x0a, 0x0a, 0x1d, 0x17), "IDXGIFactory6"},
+    {MakeIid(0x2411e7e1, 0x12ac, 0x4ccf, 0xbd, 0x14, 0x97, 0x98, 0xe8, 0x53, 0x4d, 0xc0), "IDXGIAdapter"},
+    {MakeIid(0x29038f61, 0x3839, 0x4626, 0x91, 0xfd, 0x08, 0x68, 0x79, 0x01, 0x1a, 0x05), "IDXGIAdapter1"},
+    {MakeIid(0x0aa1ae0a, 0xfa0e, 0x4b84, 0x86, 0x44, 0xe0, 0x5f, 0xf8, 0xe5, 0xac, 0xb5), "IDXGIAdapter2"},
+    {MakeIid(0x645967a4, 0x1392, 0x4310, 0xa7, 0x98, 0x80, 0x53, 0xce, 0x3e, 0x93, 0xfd), "IDXGIAdapter3"},
+    {MakeIid(0x3c8d99d1, 0x4fbf, 0x4181, 0xa8, 0x2c, 0xaf, 0x66, 0xbf, 0x7b, 0xd2, 0x4e), "IDXGIAdapter4"},
+    {MakeIid(0xae02eedb, 0xc735, 0x4690, 0x8d, 0x52, 0x5a, 0x8d, 0xc2, 0x02, 0x13, 0xaa), "IDXGIOutput"},
+    {MakeIid(0x00cddea8, 0x939b, 0x4b83, 0xa3, 0x40, 0xa6, 0x85, 0x22, 0x66, 0x66, 0xcc), "IDXGIOutput1"},
+    {MakeIid(0x595e39d1, 0x2724, 0x4663, 0x99, 0xb1, 0xda, 0x96, 0x9d, 0xe2, 0x83, 0x64), "IDXGIOutput2"},
+    {MakeIid(0x8a6bb301, 0x7e7e, 0x41f4, 0xa8, 0xe0, 0x5b, 0x32, 0xf7, 0xf9, 0x9b, 0x18), "IDXGIOutput3"},
+    {MakeIid(0xdc7dca35, 0x2196, 0x414d, 0x9f, 0x53, 0x61, 0x78, 0x84, 0x03, 0x2a, 0x60), "IDXGIOutput4"},
+    {MakeIid(0x80a07424, 0xab52, 0x42eb, 0x83, 0x3c, 0x0c, 0x42, 0xfd, 0x28, 0x2d, 0x98), "IDXGIOutput5"},
+    {MakeIid(0x068346e8, 0xaaec, 0x4b84, 0xad, 0xd7, 0x13, 0x7f, 0x51, 0x3f, 0x77, 0xa1), "IDXGIOutput6"},
+    {MakeIid(0x3d3e0379, 0xf9de, 0x4d58, 0xbb, 0x6c, 0x18, 0xd6, 0x29, 0x92, 0xf1, 0xa6), "IDXGIDeviceSubObject"},
+    {MakeIid(0x310d36a0, 0xd2e7, 0x4c0a, 0xaa, 0x04, 0x6a, 0x9d, 0x23, 0xb8, 0x88, 0x6a), "IDXGISwapChain"},
+    {MakeIid(0x790a45f7, 0x0d42, 0x4876, 0x98, 0x3a, 0x0a, 0x55, 0xcf, 0xe6, 0xf4, 0xaa), "IDXGISwapChain1"},
+    {MakeIid(0xa8be2ac4, 0x199f, 0x4946, 0xb3, 0x31, 0x79, 0x59, 0x9f, 0xb9, 0x8d, 0xe7), "IDXGISwapChain2"},
+    {MakeIid(0x94d99bdb, 0xf1f8, 0x4ab0, 0xb2, 0x36, 0x7d, 0xa0, 0x17, 0x0e, 0xda, 0xb1), "IDXGISwapChain3"},
+    {MakeIid(0x3d585d5a, 0xbd4a, 0x489e, 0xb1, 0xf4, 0x3d, 0xbc, 0xb6, 0x45, 0x2f, 0xfb), "IDXGISwapChain4"},
+};
+
+// Set of interface ids with a perfect hash on Data1, searched for at compile
+// time: a lookup hashes four bytes, reads one slot and verifies the whole id
+// with two 64-bit compares, whatever the size of the set or the outcome.
+template <size_t N>
+class IidSet {
+public:
+    // Slots for a load factor of at most 1/2
+    static constexpr unsigned kBits = [] {
+        unsigned bits = 1;
+        while ((size_t(1) << bits) < 2 * N) bits++;
+        return bits;
+    }();
+    static constexpr size_t kSlots = size_t(1) << kBits;
+    static_assert(kBits <= 6, "the seed search tracks used slots in one 64-bit mask");
+
+    constexpr explicit IidSet(const DxgiIid (&ids)[N]) {
+        for (uint32_t seed = 0x9e3779b1; seed < 0x9e3779b1 + 2 * 100000; seed += 2) {
+            if (!Injective(ids, seed)) continue;
+            m_seed = seed;
+            for (size_t i = 0; i < N; i++) {
+                Slot& slot = m_slots[SlotOf(kDxgiIids[(size_t)ids[i]].key.lo, seed)];
+                slot.key = kDxgiIids[(size_t)ids[i]].key;
+                slot.id = (int)ids[i];
+            }
+            return;
+        }
+    }
+
+    // False if no seed was found; checked with static_assert where sets are defined
+    constexpr bool Valid() const { return m_seed != 0; }
+
+    // Returns the DxgiIid of the id, or -1 if it is not in the set
+    int Find(const IidKey& key) const {
+        const Slot& slot = m_slots[SlotOf(key.lo, m_seed)];
+        return slot.key == key ? slot.id : -1;
+    }
+
+    template <class Guid>
+    bool Contains(const Guid& guid) const {
+        return Find(IidKey::Of(guid)) >= 0;
+    }
+
+private:
+    // Empty slots keep the all-ones key and id -1, so even a match is a miss
+    struct Slot {
+        IidKey key;
+        int id = -1;
+    };
+
+    static constexpr size_t SlotOf(uint64_t lo, uint32_t seed) {
+        return (size_t)((uint32_t)((uint32_t)lo * seed) >> (32 - kBits));
+    }
+
+    static constexpr bool Injective(const DxgiIid (&ids)[N], uint32_t seed) {
+        uint64_t used = 0;
+        for (size_t i = 0; i < N; i++) {
+            uint64_t bit = 1ull << SlotOf(kDxgiIids[(size_t)ids[i]].key.lo, seed);
+            if (used & bit) return false;
+            used |= bit;
+        }
+        return true;
+    }
+
+    uint32_t m_seed = 0;
+    Slot m_slots[kSlots] = {};
+};
+
+// The interfaces each proxy answers for itself, and the factory interfaces
+// CreateDXGIFactory1 results are wrapped for
+inline constexpr DxgiIid kFactoryIidList[] = {
+    DxgiIid::IUnknown,      DxgiIid::IDXGIObject,   DxgiIid::IDXGIFactory,  DxgiIid::IDXGIFactory1,
+    DxgiIid::IDXGIFactory2, DxgiIid::IDXGIFactory3, DxgiIid::IDXGIFactory4, DxgiIid::IDXGIFactory5,
+    DxgiIid::IDXGIFactory6,
+};
+inline constexpr DxgiIid kAdapterIidList[] = {
+    DxgiIid::IUnknown,      DxgiIid::IDXGIObject,   DxgiIid::IDXGIAdapter,  DxgiIid::IDXGIAdapter1,
+    DxgiIid::IDXGIAdapter2, DxgiIid::IDXGIAdapter3, DxgiIid::IDXGIAdapter4,
+};
+inline constexpr DxgiIid kOutputIidList[] = {
+    DxgiIid::IUnknown,     DxgiIid::IDXGIObject,  DxgiIid::IDXGIOutput,  DxgiIid::IDXGIOutput1, DxgiIid::IDXGIOutput2,
+    DxgiIid::IDXGIOutput3, DxgiIid::IDXGIOutput4, DxgiIid::IDXGIOutput5, DxgiIid::IDXGIOutput6,
+};
+inline constexpr DxgiIid kSwapChainIidList[] = {
+    DxgiIid::IUnknown,        DxgiIid::IDXGIObject,     DxgiIid::IDXGIDeviceSubObject, DxgiIid::IDXGISwapChain,
+    DxgiIid::IDXGISwapChain1, DxgiIid::IDXGISwapChain2, DxgiIid::IDXGISwapChain3,      DxgiIid::IDXGISwapChain4,
+};
+inline constexpr DxgiIid kWrappedFactoryIidList[] = {
+    DxgiIid::IDXGIFactory,  DxgiIid::IDXGIFactory1, DxgiIid::IDXGIFactory2, DxgiIid::IDXGIFactory3,
+    DxgiIid::IDXGIFactory4, DxgiIid::IDXGIFactory5, DxgiIid::IDXGIFactory6,
+};
+inline constexpr DxgiIid kAllDxgiIidList[] = {
+    DxgiIid::IUnknown,      DxgiIid::IDXGIObject,   DxgiIid::IDXGIFactory,  DxgiIid::IDXGIFactory1,
+    DxgiIid::IDXGIFactory2, DxgiIid::IDXGIFactory3, DxgiIid::IDXGIFactory4, DxgiIid::IDXGIFactory5,
+    DxgiIid::IDXGIFactory6, DxgiIid::IDXGIAdapter,  DxgiIid::IDXGIAdapter1, DxgiIid::IDXGIAdapter2,
+    DxgiIid::IDXGIAdapter3, DxgiIid::IDXGIAdapter4, DxgiIid::IDXGIOutput,   DxgiIid::IDXGIOutput1,
+    DxgiIid::IDXGIOutput2,  DxgiIid::IDXGIOutput3,  DxgiIid::IDXGIOutput4,  DxgiIid::IDXGIOutput5,
+    DxgiIid::IDXGIOutput6,  DxgiIid::IDXGIDeviceSubObject, DxgiIid::IDXGISwapChain, DxgiIid::IDXGISwapChain1,
+    DxgiIid::IDXGISwapChain2, DxgiIid::IDXGISwapChain3, DxgiIid::IDXGISwapChain4,
+};
+
+inline constexpr IidSet<sizeof(kFactoryIidList) / sizeof(DxgiIid)> kFactoryIids(kFactoryIidList);
+inline constexpr IidSet<sizeof(kAdapterIidList) / sizeof(DxgiIid)> kAdapterIids(kAdapterIidList);
+inline constexpr IidSet<sizeof(kOutputIidList) / sizeof(DxgiIid)> kOutputIids(kOutputIidList);
+inline constexpr IidSet<sizeof(kSwapChainIidList) / sizeof(DxgiIid)> kSwapChainIids(kSwapChainIidList);
+inline constexpr IidSet<sizeof(kWrappedFactoryIidList) / sizeof(DxgiIid)> kWrappedFactoryIids(kWrappedFactoryIidList);
+inline constexpr IidSet<kDxgiIidCount> kAllDxgiIids(kAllDxgiIidList);
+
+static_assert(kFactoryIids.Valid() && kAdapterIids.Valid() && kOutputIids.Valid() && kSwapChainIids.Valid() &&
+                  kWrappedFactoryIids.Valid() &&
+                  kAllDxgiIids.Valid(),
+              "no perfect hash seed found for an IID set");
+
+// Name of a known DXGI interface id, or nullptr
+template <class Guid>
+const char* DxgiIidName(const Guid& guid) {
+    int id = kAllDxgiIids.Find(IidKey::Of(guid));
+    return id >= 0 ? kDxgiIids[id].name : nullptr;
+}
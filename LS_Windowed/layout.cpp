@@ -0,0 +1,29 @@
+#include "layout.hpp"
+
+LayoutRect PositionBesideTarget(const LayoutRect& targetWindow, const LayoutRect& targetClient, int side) {
+    int32_t lsWidth = targetClient.Width();
+    int32_t lsHeight = targetClient.Height();
+    if (lsWidth <= 0 || lsHeight <= 0) return targetClient;
+
+    LayoutRect result;
+    int32_t gap = 0;
+
+    if (side == 0) { // Left
+        result.left = targetWindow.left - lsWidth - gap;
+        result.top = targetClient.top;
+    } else if (side == 1) { // Right
+        result.left = targetWindow.right + gap;
+        result.top = targetClient.top;
+    } else if (side == 2) { // Top
+        int32_t centerX = targetWindow.left + targetWindow.Width() / 2;
+        result.left = centerX - lsWidth / 2;
+        result.top = targetWindow.top - lsHeight - gap;
+    } else { // Bottom
+        int32_t centerX = targetWindow.left + targetWindow.Width() / 2;
+        result.left = centerX - lsWidth / 2;
+        result.top = targetWindow.bottom + gap;
+    }
+    result.right = result.left + lsWidth;
+    result.bottom = result.top + lsHeight;
+    return result;
+}
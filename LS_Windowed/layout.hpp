@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+// Pure placement math shared by the addon and the host benchmarks. Kept free
+// of user32 so it can be measured and exercised off Windows.
+
+// Same layout as RECT (four 32-bit LONGs).
+struct LayoutRect {
+    int32_t left = 0;
+    int32_t top = 0;
+    int32_t right = 0;
+    int32_t bottom = 0;
+
+    int32_t Width() const { return right - left; }
+    int32_t Height() const { return bottom - top; }
+    bool operator==(const LayoutRect& other) const {
+        return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+    }
+    bool operator!=(const LayoutRect& other) const { return !(*this == other); }
+};
+
+// Places a window the size of targetClient next to targetWindow on the given
+// side (0: Left, 1: Right, 2: Top, 3: Bottom). Left/Right align with the client
+// area top so the title bar is skipped; Top/Bottom are centred. Returns
+// targetClient unchanged if it is empty.
+LayoutRect PositionBesideTarget(const LayoutRect& targetWindow, const LayoutRect& targetClient, int side);
@@ -0,0 +1,315 @@
+#include "layout_engine.hpp"
+#include <cstdlib>
+
+namespace {
+
+size_t ClampTargetCount(int count) {
+    if (count < 1) return 1;
+    return (size_t)count > kMaxLayoutTargets ? kMaxLayoutTargets : (size_t)count;
+}
+
+uint32_t SlotBit(size_t slot) { return 1u << slot; }
+
+} // namespace
+
+LayoutEngine::LayoutEngine(IWindowSystem& windows, PublishFn publish, EventFn events)
+    : m_windows(windows), m_publish(std::move(publish)), m_events(std::move(events)) {}
+
+int LayoutEngine::SlotOf(WindowHandle window) const {
+    if (!window) return -1;
+    for (size_t i = 0; i < kMaxLayoutTargets; i++) {
+        if (m_targets[i].geometry.targetWindow == window) return (int)i;
+    }
+    return -1;
+}
+
+size_t LayoutEngine::TargetCount() const {
+    size_t count = 0;
+    for (const Target& target : m_targets) count += target.geometry.targetWindow != 0;
+    return count;
+}
+
+void LayoutEngine::Apply(const LayoutSettings& settings) {
+    size_t count = ClampTargetCount(settings.targetCount);
+    uint32_t all = SlotBit(count) - 1;
+
+    uint32_t slots = all;
+    if (m_applied && m_sawEvents && settings == m_lastSettings) slots = m_dirty & all;
+    m_applied = true;
+    m_sawEvents = false;
+    m_dirty = 0;
+    m_lastSettings = settings;
+
+    // Slots beyond a lowered count stop tracking
+    for (size_t i = count; i < kMaxLayoutTargets; i++) {
+        if (!m_targets[i].geometry.targetWindow) continue;
+        m_targets[i].geometry.targetWindow = 0;
+        m_changed |= SlotBit(i);
+    }
+
+    slots |= TrackForeground(count);
+    for (size_t i = 0; i < count; i++) {
+        if (slots & SlotBit(i)) RefreshTarget(i, settings);
+    }
+
+    FindOverlays(slots);
+    for (size_t i = 0; i < count; i++) {
+        Target& target = m_targets[i];
+        if (target.overlay && target.overlay != target.geometry.lsWindow) {
+            target.geometry.lsWindow = target.overlay;
+            m_changed |= SlotBit(i);
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!(slots & SlotBit(i)) || !m_targets[i].geometry.targetWindow) continue;
+        ApplyWindowRegion(i, settings);
+        UpdateWindowPositions(i, settings);
+    }
+    PublishChanged();
+}
+
+bool LayoutEngine::IsRelevant(const WindowEvent& event) {
+    bool relevant = false;
+    if (event.type == WindowEventType::Foreground) {
+        relevant = true;
+    } else if (event.type == WindowEventType::DisplayChange) {
+        m_dirty = SlotBit(kMaxLayoutTargets) - 1; // Every target may sit on a moved monitor
+        relevant = true;
+    } else {
+        for (size_t i = 0; i < kMaxLayoutTargets; i++) {
+            Target& target = m_targets[i];
+            if (event.window && (event.window == target.geometry.targetWindow || event.window == target.overlay)) {
+                m_dirty |= SlotBit(i);
+                relevant = true;
+                bool moved = event.type == WindowEventType::MoveSize && event.window == target.geometry.targetWindow;
+                if (moved && (!target.hasMoveEvent || event.time < target.moveEvent)) {
+                    target.hasMoveEvent = true;
+                    target.moveEvent = event.time;
+                }
+            }
+        }
+        if (!relevant && m_windows.IsOwnedByProcess(event.window)) {
+            // A new or moved LS window may be the overlay of any target
+            m_dirty = SlotBit(kMaxLayoutTargets) - 1;
+            relevant = true;
+        }
+    }
+    m_sawEvents |= relevant;
+    return relevant;
+}
+
+void LayoutEngine::PublishChanged() {
+    for (size_t i = 0; m_changed; i++) {
+        if (!(m_changed & SlotBit(i))) continue;
+        m_changed &= ~SlotBit(i);
+        targetStats.publishes++;
+        if (m_publish) m_publish(i, m_targets[i].geometry);
+    }
+}
+
+LayoutRect LayoutEngine::CalculatePositionedRect(WindowHandle target, const LayoutRect& targetClient, int side) {
+    LayoutRect targetWindow;
+    if (!m_windows.Exists(target) || !m_windows.WindowRect(target, &targetWindow)) return targetClient;
+    return PositionBesideTarget(targetWindow, targetClient, side);
+}
+
+// Makes the foreground window a target if it is not one already. Returns the
+// slot to refresh when the foreground changed, or 0.
+uint32_t LayoutEngine::TrackForeground(size_t count) {
+    WindowHandle foreground = m_windows.Foreground();
+    if (!foreground || m_windows.IsOwnedByProcess(foreground)) return 0; // Nothing, or it's us (LS)
+
+    int slot = SlotOf(foreground);
+    if (slot >= 0 && (size_t)slot < count && foreground == m_lastForeground) return 0;
+    m_lastForeground = foreground;
+    if (slot < 0) {
+        // It's another app. Assume it's a target: take a free slot, or the
+        // least recently focused one.
+        LayoutRect client;
+        if (!m_windows.ClientRect(foreground, &client) || client.Width() <= 0 || client.Height() <= 0) return 0;
+
+        slot = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (!m_targets[i].geometry.targetWindow) {
+                slot = (int)i;
+                break;
+            }
+            if (m_targets[i].lastFocus < m_targets[slot].lastFocus) slot = (int)i;
+        }
+        if (m_targets[slot].geometry.targetWindow) targetStats.evicted++;
+        m_targets[slot].geometry.targetWindow = foreground;
+        m_changed |= SlotBit(slot);
+        targetStats.registered++;
+    }
+    m_targets[slot].lastFocus = ++m_focusClock;
+    return SlotBit(slot);
+}
+
+void LayoutEngine::RefreshTarget(size_t slot, const LayoutSettings& settings) {
+    Target& target = m_targets[slot];
+    LayoutGeometry& geometry = target.geometry;
+    bool hasMoveEvent = target.hasMoveEvent;
+    target.hasMoveEvent = false;
+    if (!geometry.targetWindow) return;
+    if (!m_windows.Exists(geometry.targetWindow)) {
+        // Keep reporting the last rect; the slot is free for the next target
+        geometry.targetWindow = 0;
+        m_changed |= SlotBit(slot);
+        targetStats.expired++;
+        return;
+    }
+
+    LayoutRect client;
+    if (!m_windows.ClientRect(geometry.targetWindow, &client) || client.Width() <= 0 || client.Height() <= 0) return;
+    targetStats.refreshes++;
+
+    LayoutRect lsRect = geometry.lsRect;
+    // Initialize lsRect if it's empty; in Position mode place it next to the
+    // target right away so the initial placement is correct
+    if (settings.positionMode) {
+        lsRect = CalculatePositionedRect(geometry.targetWindow, client, settings.positionSide);
+    } else if (lsRect.right == 0) {
+        lsRect = client;
+    }
+    if (client != geometry.targetRect && m_events) m_events(LayoutEventType::TargetMoved, slot, client);
+    if (settings.positionMode && lsRect != geometry.lsRect && !target.following) {
+        // Without an event (polling, or a refresh for another reason) the
+        // move is timed from now, which leaves out how long it went unseen
+        target.following = true;
+        target.followFromEvent = hasMoveEvent;
+        target.followSince = hasMoveEvent ? target.moveEvent : m_windows.Now();
+    }
+    if (client != geometry.targetRect || lsRect != geometry.lsRect) {
+        geometry.targetRect = client;
+        geometry.lsRect = lsRect;
+        m_changed |= SlotBit(slot);
+    }
+}
+
+bool LayoutEngine::IsOverlayCandidate(WindowHandle window, LayoutRect* rect) {
+    if (!m_windows.IsOwnedByProcess(window) || !m_windows.IsVisible(window)) return false;
+    return m_windows.WindowRect(window, rect);
+}
+
+// Revalidates the cached overlays of the given slots, then finds the missing
+// ones with a single z-order scan shared by all of them.
+void LayoutEngine::FindOverlays(uint32_t slots) {
+    uint32_t missing = 0;
+    for (size_t i = 0; i < kMaxLayoutTargets; i++) {
+        Target& target = m_targets[i];
+        if (!(slots & SlotBit(i)) || !target.geometry.targetWindow) continue;
+        if (target.overlay) {
+            // Still ours, visible and either untouched since we last saw it or
+            // already at the layout position: keep using it.
+            LayoutRect rect;
+            if (m_windows.Exists(target.overlay) && IsOverlayCandidate(target.overlay, &rect) &&
+                (rect == target.overlayRect || rect == target.geometry.targetRect || rect == target.geometry.lsRect)) {
+                target.overlayRect = rect;
+                overlayStats.cacheHits++;
+                continue;
+            }
+            overlayStats.invalidations++;
+            target.overlay = 0;
+        }
+        missing |= SlotBit(i);
+    }
+    if (!missing) return;
+
+    struct Scan {
+        LayoutEngine* self;
+        uint32_t missing;
+    } scan{this, missing};
+    overlayStats.fullScans++;
+    m_windows.ForEachWindow(
+        [](WindowHandle window, void* context) {
+            Scan& scan = *(Scan*)context;
+            LayoutEngine* self = scan.self;
+            LayoutRect rect;
+            if (!self->IsOverlayCandidate(window, &rect)) return true;
+            for (size_t i = 0; i < kMaxLayoutTargets; i++) {
+                if (self->m_targets[i].overlay == window) return true; // Already bound to another target
+            }
+            for (size_t i = 0; i < kMaxLayoutTargets; i++) {
+                Target& target = self->m_targets[i];
+                if (!(scan.missing & SlotBit(i))) continue;
+                if (rect == target.geometry.targetRect || rect == target.geometry.lsRect) {
+                    target.overlay = window;
+                    target.overlayRect = rect;
+                    scan.missing &= ~SlotBit(i);
+                    break;
+                }
+            }
+            return scan.missing != 0;
+        },
+        &scan);
+}
+
+void LayoutEngine::ApplyWindowRegion(size_t slot, const LayoutSettings& settings) {
+    Target& target = m_targets[slot];
+    if (!target.overlay) return;
+
+    AppliedRegion wanted;
+    wanted.overlay = target.overlay;
+    wanted.valid = true;
+    if (settings.splitMode && settings.splitGrid.cellCount) {
+        const LayoutRect& targetRect = target.geometry.targetRect;
+        if (target.regionTemplate.Update(settings.splitGrid, targetRect.Width(), targetRect.Height())) {
+            regionStats.templateBuilds++;
+        }
+        int cell = (settings.splitCell + (int)slot) % settings.splitGrid.cellCount;
+        const LayoutRect* region = target.regionTemplate.Cell(cell < 0 ? 0 : cell);
+        if (region) {
+            wanted.clipped = true;
+            wanted.region = *region;
+        }
+    }
+    if (wanted == target.appliedRegion) {
+        regionStats.skipped++;
+        return;
+    }
+
+    if (m_windows.SetRegion(target.overlay, wanted.clipped ? &wanted.region : nullptr)) {
+        target.appliedRegion = wanted;
+        regionStats.applied++;
+    }
+}
+
+void LayoutEngine::UpdateWindowPositions(size_t slot, const LayoutSettings& settings) {
+    Target& target = m_targets[slot];
+    LayoutGeometry& geometry = target.geometry;
+    bool following = target.following;
+    target.following = false;
+    if (!settings.positionMode) {
+        if (geometry.lsRect != geometry.targetRect) {
+            geometry.lsRect = geometry.targetRect;
+            m_changed |= SlotBit(slot);
+        }
+        return;
+    }
+
+    // Move LS Window (Overlay)
+    bool inPlace = false;
+    if (target.overlay && m_windows.Exists(target.overlay)) {
+        LayoutRect current;
+        m_windows.WindowRect(target.overlay, &current);
+        if (abs(current.left - geometry.lsRect.left) > 2 || abs(current.top - geometry.lsRect.top) > 2) {
+            if (m_windows.Move(target.overlay, geometry.lsRect)) {
+                target.overlayRect = geometry.lsRect;
+                if (following) {
+                    auto latency = m_windows.Now() - target.followSince;
+                    followLatency.RecordFollow(
+                        (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count(),
+                        target.followFromEvent);
+                    following = false;
+                }
+                if (m_events) m_events(LayoutEventType::OverlayMoved, slot, geometry.lsRect);
+            }
+        } else {
+            inPlace = true;
+        }
+    }
+    if (following) {
+        if (inPlace) followLatency.RecordInPlace();
+        else followLatency.RecordMissed();
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include "follow_latency.hpp"
+#include "grid_layout.hpp"
+#include "layout.hpp"
+#include "window_events.hpp"
+#include "window_system.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Most target windows tracked at once; each owns one slot (virtual display).
+constexpr size_t kMaxLayoutTargets = 4;
+
+// The user-facing layout options the engine applies.
+struct LayoutSettings {
+    bool splitMode = false;
+    GridLayout splitGrid; // Default: left and right halves
+    int splitCell = 0;    // Cell shown by the first target; target i shows cell splitCell + i
+    bool positionMode = false;
+    int positionSide = 1; // 0: Left, 1: Right, 2: Top, 3: Bottom
+    int targetCount = 1;  // Target windows tracked at once, 1 to kMaxLayoutTargets
+
+    bool operator==(const LayoutSettings& other) const {
+        return splitMode == other.splitMode && splitGrid == other.splitGrid && splitCell == other.splitCell &&
+               positionMode == other.positionMode &&
+               positionSide == other.positionSide && targetCount == other.targetCount;
+    }
+    bool operator!=(const LayoutSettings& other) const { return !(*this == other); }
+};
+
+// What the hooks report for one virtual monitor.
+struct LayoutGeometry {
+    LayoutRect targetRect; // Client area of the target window in screen coordinates
+    LayoutRect lsRect;     // Where the LS window is placed (differs in Position mode)
+    WindowHandle targetWindow = 0;
+    WindowHandle lsWindow = 0; // The slot's overlay, once found; kept after it is lost
+};
+
+// Layout changes reported to the engine's event callback as they are made
+enum class LayoutEventType : uint8_t {
+    TargetMoved,  // A target's client rect changed; rect is the new one
+    OverlayMoved, // An overlay was moved beside its target (Position mode); rect is where
+};
+
+struct OverlayStats {
+    std::atomic<uint64_t> fullScans{0};
+    std::atomic<uint64_t> cacheHits{0};
+    std::atomic<uint64_t> invalidations{0};
+};
+
+struct RegionStats {
+    std::atomic<uint64_t> applied{0};
+    std::atomic<uint64_t> skipped{0};
+    std::atomic<uint64_t> templateBuilds{0}; // Grid cell rects computed for a new size or layout
+};
+
+struct TargetStats {
+    std::atomic<uint64_t> registered{0}; // Windows that became a target
+    std::atomic<uint64_t> evicted{0};    // Targets replaced because every slot was taken
+    std::atomic<uint64_t> expired{0};    // Targets whose window went away
+    std::atomic<uint64_t> refreshes{0};  // Per-target geometry refreshes
+    std::atomic<uint64_t> publishes{0};
+};
+
+// Tracks up to targetCount game windows at once and keeps an LS overlay
+// clipped or placed next to each. A window becomes a target when it comes to
+// the foreground and keeps its slot until it is destroyed or, with every slot
+// taken, it is the least recently focused target when a new one arrives; so
+// switching between tracked clients does not move anything. Each slot has its
+// own overlay, found by matching the overlay's rect against the slot's.
+//
+// Events mark the targets they touch and an apply refreshes only those, so a
+// tick costs the same however many targets are tracked; an apply without
+// event information (a poll tick, an explicit request, changed settings)
+// refreshes all of them. Geometry changes are published once per slot at the
+// end of the apply.
+//
+// Not thread-safe: Apply and IsRelevant run on the tracker thread only; the
+// stats may be read from anywhere.
+class LayoutEngine {
+public:
+    using PublishFn = std::function<void(size_t slot, const LayoutGeometry&)>;
+    using EventFn = std::function<void(LayoutEventType type, size_t slot, const LayoutRect& rect)>;
+
+    // publish is called whenever the geometry the hooks see changes; events,
+    // for diagnostics, on each target move and overlay move
+    explicit LayoutEngine(IWindowSystem& windows, PublishFn publish = nullptr, EventFn events = nullptr);
+
+    void Apply(const LayoutSettings& settings);
+
+    // Filters out events for windows that cannot affect the layout. Foreground
+    // changes always count; moves, shows and destroys only for target windows
+    // or for windows owned by this process (the LS overlays).
+    bool IsRelevant(const WindowEvent& event);
+
+    const LayoutGeometry& Geometry(size_t slot = 0) const { return m_targets[slot].geometry; }
+    WindowHandle Overlay(size_t slot = 0) const { return m_targets[slot].overlay; }
+
+    // Slot tracking window as its target, or -1
+    int SlotOf(WindowHandle window) const;
+    size_t TargetCount() const;
+
+    OverlayStats overlayStats;
+    RegionStats regionStats;
+    TargetStats targetStats;
+    FollowLatency followLatency; // Position mode only
+
+private:
+    // Region currently applied to the overlay. SetRegion forces a redraw and a
+    // DWM recomposition, so it is only issued when this changes.
+    struct AppliedRegion {
+        WindowHandle overlay = 0;
+        bool valid = false;   // Nothing applied yet
+        bool clipped = false; // false: no region (whole window visible)
+        LayoutRect region;
+
+        bool operator==(const AppliedRegion& other) const {
+            return overlay == other.overlay && valid == other.valid && clipped == other.clipped &&
+                   region == other.region;
+        }
+    };
+
+    struct Target {
+        LayoutGeometry geometry{{0, 0, 1920, 1080}, {0, 0, 1920, 1080}, 0};
+        uint64_t lastFocus = 0; // m_focusClock when it was last in the foreground
+
+        // Overlay (LS output window) discovery. The handle is cached and
+        // revalidated each apply; a scan only happens when the cached window
+        // is gone or no longer where we expect it.
+        WindowHandle overlay = 0;
+        LayoutRect overlayRect; // Last known rect of overlay
+        AppliedRegion appliedRegion;
+        GridTemplate regionTemplate; // Split cells for the current target size
+
+        // Move-to-follow timing. moveEvent: the earliest move event of the
+        // target since its last refresh. followSince: when the target was
+        // first seen somewhere the overlay has not followed it to yet,
+        // resolved by the UpdateWindowPositions of the same apply.
+        bool hasMoveEvent = false;
+        std::chrono::steady_clock::time_point moveEvent;
+        bool following = false;
+        bool followFromEvent = false;
+        std::chrono::steady_clock::time_point followSince;
+    };
+
+    uint32_t TrackForeground(size_t count);
+    void RefreshTarget(size_t slot, const LayoutSettings& settings);
+    LayoutRect CalculatePositionedRect(WindowHandle target, const LayoutRect& targetClient, int side);
+    bool IsOverlayCandidate(WindowHandle window, LayoutRect* rect);
+    void FindOverlays(uint32_t slots);
+    void ApplyWindowRegion(size_t slot, const LayoutSettings& settings);
+    void UpdateWindowPositions(size_t slot, const LayoutSettings& settings);
+    void PublishChanged();
+
+    IWindowSystem& m_windows;
+    PublishFn m_publish;
+    EventFn m_events;
+    Target m_targets[kMaxLayoutTargets];
+    uint64_t m_focusClock = 0;
+    WindowHandle m_lastForeground = 0;
+
+    bool m_sawEvents = false; // IsRelevant accepted an event since the last apply
+    uint32_t m_dirty = 0;     // Slots those events touched
+    uint32_t m_changed = 0;   // Slots to publish at the end of the current apply
+    bool m_applied = false;
+    LayoutSettings m_lastSettings;
+};
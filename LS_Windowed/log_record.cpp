@@ -0,0 +1,175 @@
+#include "log_record.hpp"
+#include <cctype>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct DecodedArg {
+    LogArgTag tag;
+    int64_t i64 = 0;
+    uint64_t u64 = 0;
+    double f64 = 0.0;
+    const char* text = nullptr;
+    uint16_t textLength = 0;
+};
+
+std::vector<DecodedArg> DecodeArgs(const uint8_t* data, size_t size) {
+    std::vector<DecodedArg> args;
+    const uint8_t* cursor = data;
+    const uint8_t* end = data + size;
+    while (cursor < end) {
+        DecodedArg arg;
+        arg.tag = (LogArgTag)*cursor++;
+        size_t remaining = (size_t)(end - cursor);
+        switch (arg.tag) {
+        case LogArgTag::I32: {
+            int32_t v;
+            if (remaining < sizeof(v)) return args;
+            memcpy(&v, cursor, sizeof(v));
+            cursor += sizeof(v);
+            arg.i64 = v;
+            arg.u64 = (uint64_t)(uint32_t)v;
+            arg.f64 = v;
+            break;
+        }
+        case LogArgTag::U32: {
+            uint32_t v;
+            if (remaining < sizeof(v)) return args;
+            memcpy(&v, cursor, sizeof(v));
+            cursor += sizeof(v);
+            arg.i64 = (int64_t)v;
+            arg.u64 = v;
+            arg.f64 = v;
+            break;
+        }
+        case LogArgTag::I64:
+        case LogArgTag::U64:
+        case LogArgTag::Ptr: {
+            uint64_t v;
+            if (remaining < sizeof(v)) return args;
+            memcpy(&v, cursor, sizeof(v));
+            cursor += sizeof(v);
+            arg.u64 = v;
+            arg.i64 = (int64_t)v;
+            arg.f64 = arg.tag == LogArgTag::I64 ? (double)(int64_t)v : (double)v;
+            break;
+        }
+        case LogArgTag::F64: {
+            double v;
+            if (remaining < sizeof(v)) return args;
+            memcpy(&v, cursor, sizeof(v));
+            cursor += sizeof(v);
+            arg.f64 = v;
+            arg.i64 = (int64_t)v;
+            arg.u64 = (uint64_t)arg.i64;
+            break;
+        }
+        case LogArgTag::Str: {
+            uint16_t length;
+            if (remaining < sizeof(length)) return args;
+            memcpy(&length, cursor, sizeof(length));
+            cursor += sizeof(length);
+            if ((size_t)(end - cursor) < length) return args;
+            arg.text = reinterpret_cast<const char*>(cursor);
+            arg.textLength = length;
+            cursor += length;
+            break;
+        }
+        default:
+            return args; // Unknown tag; the rest cannot be parsed
+        }
+        args.push_back(arg);
+    }
+    return args;
+}
+
+} // namespace
+
+const char* LogLevelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace: return "TRACE";
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info: return "INFO";
+    case LogLevel::Warn: return "WARN";
+    case LogLevel::Error: return "ERROR";
+    }
+    return "?";
+}
+
+std::string RenderLogMessage(const char* fmt, const uint8_t* args, size_t size) {
+    std::vector<DecodedArg> decoded = DecodeArgs(args, size);
+    size_t next = 0;
+    std::string out;
+    char buffer[512];
+
+    for (const char* p = fmt; *p; p++) {
+        if (*p != '%') {
+            out.push_back(*p);
+            continue;
+        }
+        if (p[1] == '%') {
+            out.push_back('%');
+            p++;
+            continue;
+        }
+
+        // Keep flags, width and precision; drop the length modifier and
+        // substitute one that matches the stored argument
+        std::string spec = "%";
+        const char* q = p + 1;
+        while (*q && strchr("-+ #0", *q)) spec.push_back(*q++);
+        while (*q && (isdigit((unsigned char)*q) || *q == '.')) spec.push_back(*q++);
+        while (*q && strchr("hljztL", *q)) q++;
+        char conversion = *q;
+        if (!conversion) break;
+        p = q;
+
+        if (next >= decoded.size()) {
+            out += "<missing>";
+            continue;
+        }
+        const DecodedArg& arg = decoded[next++];
+        switch (conversion) {
+        case 'd':
+        case 'i':
+            snprintf(buffer, sizeof(buffer), (spec + "lld").c_str(), (long long)arg.i64);
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            snprintf(buffer, sizeof(buffer), (spec + "ll" + conversion).c_str(), (unsigned long long)arg.u64);
+            break;
+        case 'c':
+            snprintf(buffer, sizeof(buffer), (spec + "c").c_str(), (int)arg.i64);
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            snprintf(buffer, sizeof(buffer), (spec + conversion).c_str(), arg.f64);
+            break;
+        case 'p':
+            snprintf(buffer, sizeof(buffer), "0x%016llX", (unsigned long long)arg.u64);
+            break;
+        case 's':
+            if (arg.tag == LogArgTag::Str) {
+                std::string text(arg.text, arg.textLength);
+                snprintf(buffer, sizeof(buffer), (spec + "s").c_str(), text.c_str());
+            } else {
+                snprintf(buffer, sizeof(buffer), "<bad %%s arg>");
+            }
+            break;
+        default:
+            snprintf(buffer, sizeof(buffer), "<bad conversion %%%c>", conversion);
+            break;
+        }
+        out += buffer;
+    }
+    return out;
+}
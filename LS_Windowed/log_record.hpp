@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Binary log format. Messages are stored as a format-string id plus the raw
+// arguments; formatting happens only when the log is decoded.
+//
+// The file has a fixed size and is written through a memory mapping:
+//   LogFileHeader
+//   format region: FormatDef records, append-only, formatBytes in use
+//   record ring:   Message records; logical offsets [ringTail, ringHead) hold
+//                  complete records, older ones are overwritten
+// Each record is: u8 kind, u16 body length, body
+//   FormatDef: u16 id, u8 level, format string bytes
+//   Message:   LogMessageHeader, arguments (u8 tag + value each)
+//   Pad:       fills the rest of the ring so no record wraps around its end;
+//              fewer than 3 bytes left at the end are skipped without one
+
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+};
+
+const char* LogLevelName(LogLevel level);
+
+enum class LogRecordKind : uint8_t {
+    FormatDef = 1,
+    Message = 2,
+    Pad = 3,
+};
+
+enum class LogArgTag : uint8_t {
+    I32 = 1,
+    U32,
+    I64,
+    U64,
+    F64,
+    Ptr,
+    Str, // u16 length + bytes
+};
+
+constexpr uint32_t kLogFileMagic = 0x4C42534C; // "LSBL"
+constexpr uint16_t kLogFileVersion = 2;
+constexpr size_t kLogRecordHeaderSize = 3;
+
+// Set in LogFileHeader::flags by Logger::Close; missing after a crash
+constexpr uint16_t kLogFileCleanShutdown = 0x0001;
+
+struct LogFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint64_t steadyBaseNs; // steady clock reading when the file was created...
+    uint64_t unixBaseNs;   // ...and the wall-clock time at that moment
+    uint32_t formatOffset;
+    uint32_t formatCapacity;
+    uint32_t formatBytes;
+    uint32_t ringOffset;
+    uint64_t ringCapacity;
+    uint64_t ringHead; // Logical offsets; the physical position is offset % ringCapacity
+    uint64_t ringTail;
+};
+
+// Set in LogMessageHeader::flags when arguments did not fit in the record
+constexpr uint8_t kLogFlagTruncated = 0x01;
+
+struct LogMessageHeader {
+    uint16_t formatId;
+    LogLevel level;
+    uint8_t flags;
+    uint32_t threadId;
+    uint64_t timeNs; // steady clock
+};
+
+// Encodes one message into a caller-provided buffer (a logger ring slot).
+class LogRecordWriter {
+public:
+    LogRecordWriter(uint8_t* buffer, size_t capacity)
+        : m_header(reinterpret_cast<LogMessageHeader*>(buffer)), m_cursor(buffer + sizeof(LogMessageHeader)),
+          m_end(buffer + capacity), m_begin(buffer) {}
+
+    void Begin(uint16_t formatId, LogLevel level, uint32_t threadId, uint64_t timeNs) {
+        m_header->formatId = formatId;
+        m_header->level = level;
+        m_header->flags = 0;
+        m_header->threadId = threadId;
+        m_header->timeNs = timeNs;
+    }
+
+    template <class T>
+    void Arg(const T& value) {
+        if constexpr (std::is_array_v<T>) {
+            Arg<const std::remove_extent_t<T>*>(value);
+        } else if constexpr (std::is_enum_v<T>) {
+            Arg(static_cast<std::underlying_type_t<T>>(value));
+        } else if constexpr (std::is_same_v<T, bool>) {
+            Put(LogArgTag::I32, (int32_t)value);
+        } else if constexpr (std::is_integral_v<T>) {
+            if constexpr (sizeof(T) <= 4) {
+                if constexpr (std::is_signed_v<T>) Put(LogArgTag::I32, (int32_t)value);
+                else Put(LogArgTag::U32, (uint32_t)value);
+            } else {
+                if constexpr (std::is_signed_v<T>) Put(LogArgTag::I64, (int64_t)value);
+                else Put(LogArgTag::U64, (uint64_t)value);
+            }
+        } else if constexpr (std::is_floating_point_v<T>) {
+            Put(LogArgTag::F64, (double)value);
+        } else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+            PutString(value ? value : "(null)", value ? strlen(value) : 6);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            PutString(value.data(), value.size());
+        } else if constexpr (std::is_pointer_v<T>) {
+            Put(LogArgTag::Ptr, (uint64_t)(uintptr_t)value);
+        } else {
+            static_assert(sizeof(T) == 0, "Unsupported log argument type");
+        }
+    }
+
+    size_t Size() const { return (size_t)(m_cursor - m_begin); }
+
+private:
+    template <class V>
+    void Put(LogArgTag tag, V value) {
+        if ((size_t)(m_end - m_cursor) < 1 + sizeof(V)) {
+            m_header->flags |= kLogFlagTruncated;
+            m_cursor = m_end;
+            return;
+        }
+        *m_cursor++ = (uint8_t)tag;
+        memcpy(m_cursor, &value, sizeof(V));
+        m_cursor += sizeof(V);
+    }
+
+    void PutString(const char* text, size_t length) {
+        size_t room = (size_t)(m_end - m_cursor);
+        if (room < 3) {
+            m_header->flags |= kLogFlagTruncated;
+            m_cursor = m_end;
+            return;
+        }
+        if (length > room - 3) {
+            length = room - 3;
+            m_header->flags |= kLogFlagTruncated;
+        }
+        uint16_t length16 = (uint16_t)length;
+        *m_cursor++ = (uint8_t)LogArgTag::Str;
+        memcpy(m_cursor, &length16, sizeof(length16));
+        memcpy(m_cursor + sizeof(length16), text, length);
+        m_cursor += sizeof(length16) + length;
+    }
+
+    LogMessageHeader* m_header;
+    uint8_t* m_cursor;
+    uint8_t* m_end;
+    uint8_t* m_begin;
+};
+
+// Renders a printf-style format string with encoded arguments. Conversions are
+// re-typed to match the stored value, so "%d" with a 64-bit argument is fine.
+std::string RenderLogMessage(const char* fmt, const uint8_t* args, size_t size);
@@ -1,35 +1,355 @@
 #include "logger.hpp"
-#include <iostream>
+#include "mapped_file.hpp"
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
-std::ofstream Logger::logFile;
-std::mutex Logger::logMutex;
+namespace {
 
-void Logger::Init(const std::wstring& logPath) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    logFile.open(logPath, std::ios::out | std::ios::trunc);
-    if (logFile.is_open()) {
-        logFile << "LS_Windowed Log Initialized" << std::endl;
+constexpr size_t kSlotMask = Logger::kSlotCount - 1;
+static_assert((Logger::kSlotCount & kSlotMask) == 0, "kSlotCount must be a power of two");
+
+// Bounded MPMC queue (Vyukov). A slot's sequence is relative to the lap of the
+// position using it, so the zero-initialised array is already a valid empty
+// ring and logging works before Init():
+//   sequence == lap      -> free for the producer at this position
+//   sequence == lap + 1  -> holds a message for the consumer
+Logger::Slot g_Slots[Logger::kSlotCount];
+std::atomic<size_t> g_EnqueuePos{0};
+std::atomic<size_t> g_DequeuePos{0};
+std::atomic<uint64_t> g_Dropped{0};
+std::atomic<bool> g_WriterRunning{false};
+LoggerOptions g_Options;
+
+// Format strings by id (0 is unused). Written once under g_RegistryMutex,
+// read lock-free by the consumer.
+std::mutex g_RegistryMutex;
+std::atomic<const char*> g_Formats[Logger::kMaxFormats];
+LogLevel g_FormatLevels[Logger::kMaxFormats];
+uint16_t g_FormatCount = 0;
+
+// Serialises consumers (writer thread and Close) and file access
+std::mutex g_FileMutex;
+MappedFile g_LogFile;
+LogFileHeader* g_Header = nullptr; // Points into the mapping while it is open
+std::vector<bool> g_FormatWritten; // Format ids already defined in the current file
+
+std::mutex g_WakeMutex;
+std::condition_variable g_WakeCv;
+std::atomic<bool> g_StopRequested{false}; // Also set without g_WakeMutex by Close()
+uint32_t g_WriterGeneration = 0;
+std::thread g_Writer;
+
+size_t LapOf(size_t position) { return position & ~kSlotMask; }
+
+void WriteRecord(uint8_t* dest, LogRecordKind kind, const void* first, size_t firstSize, const void* second,
+                 size_t secondSize) {
+    uint16_t length = (uint16_t)(firstSize + secondSize);
+    dest[0] = (uint8_t)kind;
+    memcpy(dest + 1, &length, sizeof(length));
+    memcpy(dest + kLogRecordHeaderSize, first, firstSize);
+    if (secondSize) memcpy(dest + kLogRecordHeaderSize + firstSize, second, secondSize);
+}
+
+// Size of the record starting at a logical ring offset, including any padding
+// that follows it up to the end of the ring
+uint64_t RingStepAt(uint64_t offset) {
+    uint64_t capacity = g_Header->ringCapacity;
+    uint64_t physical = offset % capacity;
+    uint64_t remaining = capacity - physical;
+    if (remaining < kLogRecordHeaderSize) return remaining;
+
+    const uint8_t* record = g_LogFile.Data() + g_Header->ringOffset + physical;
+    if ((LogRecordKind)record[0] == LogRecordKind::Pad) return remaining;
+    uint16_t length;
+    memcpy(&length, record + 1, sizeof(length));
+    return kLogRecordHeaderSize + length;
+}
+
+// The header fields are only read after a crash, but the compiler must not
+// move their update ahead of the record bytes they describe.
+void CommitOrder() { std::atomic_signal_fence(std::memory_order_release); }
+
+void AppendFormatLocked(const void* def, size_t defSize, const char* fmt, size_t fmtSize) {
+    size_t size = kLogRecordHeaderSize + defSize + fmtSize;
+    if (g_Header->formatBytes + size > g_Header->formatCapacity) return;
+    WriteRecord(g_LogFile.Data() + g_Header->formatOffset + g_Header->formatBytes, LogRecordKind::FormatDef, def,
+                defSize, fmt, fmtSize);
+    CommitOrder();
+    g_Header->formatBytes += (uint32_t)size;
+}
+
+void AppendRingLocked(const uint8_t* data, size_t length) {
+    uint64_t capacity = g_Header->ringCapacity;
+    uint64_t size = kLogRecordHeaderSize + length;
+    uint64_t head = g_Header->ringHead;
+    uint64_t remaining = capacity - head % capacity;
+    uint64_t padding = remaining < size ? remaining : 0;
+
+    // Retire the oldest records this write is about to overwrite
+    uint64_t newHead = head + padding + size;
+    uint64_t tail = g_Header->ringTail;
+    while (newHead - tail > capacity) tail += RingStepAt(tail);
+    g_Header->ringTail = tail;
+    CommitOrder();
+
+    uint8_t* ring = g_LogFile.Data() + g_Header->ringOffset;
+    if (padding) {
+        if (padding >= kLogRecordHeaderSize) ring[head % capacity] = (uint8_t)LogRecordKind::Pad;
+        head += padding;
+    }
+    WriteRecord(ring + head % capacity, LogRecordKind::Message, data, length, nullptr, 0);
+    CommitOrder();
+    g_Header->ringHead = head + size;
+}
+
+// Appends one encoded message to the log file, preceded by its format definition
+// the first time the id appears in this file. g_FileMutex must be held.
+void AppendMessageLocked(const uint8_t* data, size_t length) {
+    LogMessageHeader header;
+    memcpy(&header, data, sizeof(header));
+    const char* fmt = header.formatId < Logger::kMaxFormats
+                          ? g_Formats[header.formatId].load(std::memory_order_acquire)
+                          : nullptr;
+    if (!fmt) return;
+
+    if (g_Header) {
+        if (!g_FormatWritten[header.formatId]) {
+            g_FormatWritten[header.formatId] = true;
+            uint8_t def[3];
+            memcpy(def, &header.formatId, sizeof(header.formatId));
+            def[2] = (uint8_t)g_FormatLevels[header.formatId];
+            AppendFormatLocked(def, sizeof(def), fmt, strnlen(fmt, 1024));
+        }
+        AppendRingLocked(data, length);
+    }
+
+#ifdef _WIN32
+    // Rendering text is only worth it when someone is watching the debug console
+    if (IsDebuggerPresent()) {
+        std::string line = RenderLogMessage(fmt, data + sizeof(header), length - sizeof(header));
+        line.push_back('\n');
+        OutputDebugStringA(line.c_str());
+    }
+#endif
+}
+
+// Moves every published message into the log file. g_FileMutex must be held.
+// Records land in the mapping directly; nothing is written with a syscall.
+void DrainLocked() {
+    for (;;) {
+        size_t position = g_DequeuePos.load(std::memory_order_relaxed);
+        Logger::Slot& slot = g_Slots[position & kSlotMask];
+        if (slot.sequence.load(std::memory_order_acquire) != LapOf(position) + 1) break;
+
+        AppendMessageLocked(slot.data, slot.length);
+
+        slot.sequence.store(LapOf(position) + Logger::kSlotCount, std::memory_order_release);
+        g_DequeuePos.store(position + 1, std::memory_order_relaxed);
+    }
+}
+
+// Shifts name.ext -> name.1.ext -> ... -> name.keep.ext, dropping the oldest
+void RotateLogFiles(const std::filesystem::path& path, int keep) {
+    auto numbered = [&](int index) {
+        std::filesystem::path rotated = path;
+        rotated.replace_filename(path.stem().string() + "." + std::to_string(index) + path.extension().string());
+        return rotated;
+    };
+
+    std::error_code error;
+    if (keep <= 0 || !std::filesystem::exists(path, error)) return;
+    std::filesystem::remove(numbered(keep), error);
+    for (int index = keep - 1; index >= 1; index--) {
+        std::filesystem::rename(numbered(index), numbered(index + 1), error);
     }
+    std::filesystem::rename(path, numbered(1), error);
+}
+
+void WriterLoop(uint32_t generation) {
+    std::unique_lock<std::mutex> wakeLock(g_WakeMutex);
+    while (!g_StopRequested && generation == g_WriterGeneration) {
+        g_WakeCv.wait_for(wakeLock, g_Options.flushInterval);
+        if (g_StopRequested || generation != g_WriterGeneration) break; // Shutdown or Close drains the rest
+
+        wakeLock.unlock();
+        {
+            std::lock_guard<std::mutex> lock(g_FileMutex);
+            DrainLocked();
+        }
+        wakeLock.lock();
+    }
+}
+
+} // namespace
+
+void Logger::Init(const std::wstring& logPath, LoggerOptions options) {
+    {
+        std::lock_guard<std::mutex> lock(g_FileMutex);
+        g_Options = options;
+        g_FormatWritten.assign(kMaxFormats, false);
+        g_Header = nullptr;
+
+        std::filesystem::path path(logPath);
+        RotateLogFiles(path, options.keepFiles);
+        size_t fileSize = options.fileSize < kFormatRegionSize * 2 ? kFormatRegionSize * 2 : options.fileSize;
+        if (g_LogFile.Create(path, fileSize)) {
+            g_Header = reinterpret_cast<LogFileHeader*>(g_LogFile.Data());
+            *g_Header = {};
+            g_Header->steadyBaseNs = NowNs();
+            g_Header->unixBaseNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::system_clock::now().time_since_epoch())
+                                       .count();
+            g_Header->formatOffset = (uint32_t)sizeof(LogFileHeader);
+            g_Header->formatCapacity = (uint32_t)kFormatRegionSize;
+            g_Header->ringOffset = g_Header->formatOffset + g_Header->formatCapacity;
+            g_Header->ringCapacity = fileSize - g_Header->ringOffset;
+            g_Header->version = kLogFileVersion;
+            CommitOrder();
+            g_Header->magic = kLogFileMagic;
+        }
+    }
+
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(g_WakeMutex);
+        g_StopRequested = false;
+        generation = ++g_WriterGeneration;
+    }
+    g_Dropped = 0;
+    g_WriterRunning = true;
+    g_Writer = std::thread(WriterLoop, generation);
+}
+
+uint16_t Logger::RegisterSite(LogSite& site, LogLevel level, const char* fmt) {
+    std::lock_guard<std::mutex> lock(g_RegistryMutex);
+    uint16_t id = site.id.load(std::memory_order_relaxed);
+    if (id) return id; // Another thread got here first
+    if (g_FormatCount + 1u >= kMaxFormats) return 0;
+
+    id = ++g_FormatCount;
+    g_FormatLevels[id] = level;
+    g_Formats[id].store(fmt, std::memory_order_release);
+    site.id.store(id, std::memory_order_release);
+    return id;
+}
+
+uint32_t Logger::CurrentThreadId() {
+#ifdef _WIN32
+    static thread_local uint32_t id = GetCurrentThreadId();
+#else
+    static std::atomic<uint32_t> nextId{1};
+    static thread_local uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+#endif
+    return id;
+}
+
+uint64_t Logger::NowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+Logger::Slot* Logger::Acquire() {
+    size_t position = g_EnqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = g_Slots[position & kSlotMask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)LapOf(position);
+        if (diff == 0) {
+            if (g_EnqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.position = position;
+                return &slot;
+            }
+        } else if (diff < 0) {
+            // Ring is full
+            if (g_Options.overflowPolicy == LogOverflowPolicy::Block && g_WriterRunning) {
+                g_WakeCv.notify_one();
+                std::this_thread::yield();
+                position = g_EnqueuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            g_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            position = g_EnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::Publish(Slot* slot) {
+    slot->sequence.store(LapOf(slot->position) + 1, std::memory_order_release);
+
+    // Wake the writer early once the ring is half full instead of waiting for
+    // the flush interval
+    size_t queued = slot->position - g_DequeuePos.load(std::memory_order_relaxed);
+    if (queued == kSlotCount / 2) g_WakeCv.notify_one();
 }
 
 void Logger::Log(const std::string& message) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    if (logFile.is_open()) {
-        logFile << message << std::endl;
-        logFile.flush();
+    LS_LOG_AT(LogLevel::Info, "%s", message);
+}
+
+void Logger::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(g_WakeMutex);
+        g_StopRequested = true;
     }
-    // Also print to debug console
-    OutputDebugStringA((message + "\n").c_str());
+    g_WakeCv.notify_all();
+    g_WriterRunning = false;
+    if (g_Writer.joinable()) g_Writer.join();
+
+    std::lock_guard<std::mutex> lock(g_FileMutex);
+    DrainLocked();
 }
 
-void Logger::Close() {
-    std::lock_guard<std::mutex> lock(logMutex);
-    if (logFile.is_open()) {
-        logFile.close();
+void Logger::Close(bool processExit) {
+    // Close runs from DllMain under the loader lock, where waiting for a thread
+    // or a lock another thread may never release can deadlock. A writer that
+    // Shutdown() did not join exits by itself once it sees the stop request
+    // (within one flush interval, even if this wake-up is missed).
+    g_StopRequested = true;
+    g_WriterRunning = false;
+    g_WakeCv.notify_all();
+    if (g_Writer.joinable()) g_Writer.detach();
+
+    // At process exit every other thread is already gone, possibly killed
+    // while holding g_FileMutex; nothing else can touch the file, so it is
+    // finished without the lock. On an unload the writer is normally joined
+    // by Shutdown() already; if it is still draining, the file is left to it.
+    std::unique_lock<std::mutex> lock(g_FileMutex, std::defer_lock);
+    if (!processExit && !lock.try_lock()) return;
+    DrainLocked();
+    if (g_Header) {
+        uint64_t dropped = g_Dropped.load();
+        if (dropped) {
+            static LogSite site;
+            uint16_t id = site.id.load(std::memory_order_acquire);
+            if (id || (id = RegisterSite(site, LogLevel::Warn, "%llu log messages dropped (ring buffer full)"))) {
+                alignas(8) uint8_t record[64];
+                LogRecordWriter writer(record, sizeof(record));
+                writer.Begin(id, LogLevel::Warn, CurrentThreadId(), NowNs());
+                writer.Arg(dropped);
+                AppendMessageLocked(record, writer.Size());
+            }
+        }
+        g_Header->flags |= kLogFileCleanShutdown;
+        g_Header = nullptr;
+        g_LogFile.Flush();
+        g_LogFile.Close();
     }
 }
 
+uint64_t Logger::DroppedMessages() {
+    return g_Dropped.load(std::memory_order_relaxed);
+}
+
 void Log(const std::string& message) {
     Logger::Log(message);
 }
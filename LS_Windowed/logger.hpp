@@ -1,23 +1,115 @@
 #pragma once
+#include "log_record.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <fstream>
-#include <mutex>
+#include <type_traits>
 
+// Lowest level compiled in; LOG_* calls below it expand to nothing. Set through
+// the LS_WINDOWED_LOG_LEVEL CMake cache variable (0 = trace ... 4 = error).
+#ifndef LS_LOG_MIN_LEVEL
+#define LS_LOG_MIN_LEVEL 1
+#endif
+
+// What Log() does when the ring buffer is full.
+enum class LogOverflowPolicy {
+    Drop,  // Discard the message and count it; never blocks the caller
+    Block, // Wait for the writer thread to make room
+};
+
+struct LoggerOptions {
+    LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Drop;
+    std::chrono::milliseconds flushInterval{50}; // Longest a message waits before hitting the file
+    size_t fileSize = 4 << 20;                   // Fixed size of the log file; oldest records are overwritten
+    int keepFiles = 4;                           // Previous sessions kept as name.1.ext ... name.N.ext
+};
+
+// One per LOG_* call site. The format string is registered on first use and
+// afterwards only its id is stored with each message.
+struct LogSite {
+    std::atomic<uint16_t> id{0};
+};
+
+// Log messages are encoded as binary records (format id + raw arguments) into a
+// slot of a lock-free multi-producer ring buffer. A background writer thread
+// copies them into a circular, memory-mapped log file, which keeps the newest
+// records even if the process crashes; use ls_logdecode to read it.
 class Logger {
 public:
-    static void Init(const std::wstring& logPath);
+    static constexpr size_t kSlotCount = 1024; // Must be a power of two
+    static constexpr size_t kMaxRecord = 240;
+    static constexpr size_t kMaxFormats = 4096;
+    static constexpr size_t kFormatRegionSize = 64 << 10;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        size_t position;
+        uint32_t length;
+        alignas(8) uint8_t data[kMaxRecord];
+    };
+
+    static void Init(const std::wstring& logPath, LoggerOptions options = {});
     static void Log(const std::string& message);
-    static void Close();
+    // Stops and joins the writer thread and flushes everything queued so far.
+    // The file stays open; messages logged afterwards are written by Close().
+    // Not from DllMain: it waits for the writer.
+    static void Shutdown();
+    // Flushes what is queued and closes the file without waiting for anything,
+    // so it is safe under the loader lock. processExit: the process is exiting
+    // (DllMain's lpReserved is set) and no lock is taken at all.
+    static void Close(bool processExit = false);
+
+    template <class... Args>
+    static void Write(LogSite& site, LogLevel level, const char* fmt, const Args&... args) {
+        uint16_t id = site.id.load(std::memory_order_acquire);
+        if (!id && !(id = RegisterSite(site, level, fmt))) return;
+        Slot* slot = Acquire();
+        if (!slot) return;
+        LogRecordWriter writer(slot->data, sizeof(slot->data));
+        writer.Begin(id, level, CurrentThreadId(), NowNs());
+        (writer.Arg(args), ...);
+        slot->length = (uint32_t)writer.Size();
+        Publish(slot);
+    }
+
+    static uint64_t DroppedMessages();
 
 private:
-    static std::ofstream logFile;
-    static std::mutex logMutex;
+    static uint16_t RegisterSite(LogSite& site, LogLevel level, const char* fmt);
+    static uint32_t CurrentThreadId();
+    static uint64_t NowNs();
+    static Slot* Acquire();
+    static void Publish(Slot* slot);
 };
 
 void Log(const std::string& message);
-template<typename... Args>
-void Log(const char* fmt, Args... args) {
-    char buffer[1024];
-    snprintf(buffer, sizeof(buffer), fmt, args...);
-    Log(std::string(buffer));
-}
+
+#define LS_LOG_AT(level, ...)                                                                                          \
+    do {                                                                                                               \
+        static LogSite lsLogSite_;                                                                                     \
+        Logger::Write(lsLogSite_, level, __VA_ARGS__);                                                                 \
+    } while (0)
+
+#if LS_LOG_MIN_LEVEL <= 0
+#define LOG_TRACE(...) LS_LOG_AT(LogLevel::Trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) ((void)0)
+#endif
+#if LS_LOG_MIN_LEVEL <= 1
+#define LOG_DEBUG(...) LS_LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+#if LS_LOG_MIN_LEVEL <= 2
+#define LOG_INFO(...) LS_LOG_AT(LogLevel::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if LS_LOG_MIN_LEVEL <= 3
+#define LOG_WARN(...) LS_LOG_AT(LogLevel::Warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#define LOG_ERROR(...) LS_LOG_AT(LogLevel::Error, __VA_ARGS__)
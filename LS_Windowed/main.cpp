@@ -1,9 +1,20 @@
+#include "config_sync.hpp"
 #include "dxgi_proxy.hpp"
+#include "grid_layout.hpp"
+#include "hook_stats.hpp"
+#include "layout_engine.hpp"
 #include "logger.hpp"
+#include "rcu_cell.hpp"
+#include "target_tracker.hpp"
+#include "virtual_displays.hpp"
+#include "win32_event_source.hpp"
+#include "win32_window_system.hpp"
 #include <MinHook.h>
 #include <d3d11.h>
 #include <dxgi.h>
 #include <dxgi1_2.h>
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -13,122 +24,37 @@
 #include "../../../LosslessProxy/src/addon_api.hpp"
 #include "imgui.h"
 
-#include <mutex>
-
 // Global variables
 ImGuiContext* g_ImGuiContext = nullptr;
-std::mutex g_StateMutex;
 
 // Settings
 struct Settings {
   bool SplitMode = false;
-  int SplitType = 0; // 0: Left, 1: Right, 2: Top, 3: Bottom
+  GridLayout SplitGrid; // Left and right halves by default
+  int SplitCell = 0;
   bool PositionMode = false;
   int PositionSide = 1; // 0: Left, 1: Right, 2: Top, 3: Bottom
+  int VBlankRate = 0;   // Virtual display refresh in Hz; 0 follows the real display
+  int VirtualDisplays = 1;
 };
 
-Settings g_Settings;
-
-// Fake Monitor Handle
-const HMONITOR FAKE_VIRTUAL_MONITOR = (HMONITOR)0xBADF00D;
-const wchar_t *FAKE_MONITOR_NAME = L"\\\\.\\DISPLAY_WINDOWED";
-const wchar_t *FAKE_MONITOR_DEVICE = L"Windowed Mode";
-
-// Target Window Info
-RECT g_TargetRect = {0, 0, 1920, 1080}; // Default
-RECT g_LSRect = {0, 0, 1920, 1080}; // Position for LS window
-HWND g_hTargetWindow = nullptr;
-
-RECT CalculatePositionedRect(HWND hTarget, RECT rcTargetClient) {
-  RECT result = rcTargetClient; // Default fallback
-
-  if (!hTarget || !IsWindow(hTarget))
-    return result;
-
-  RECT targetWindowRect;
-  if (!GetWindowRect(hTarget, &targetWindowRect))
-    return result;
-
-  int lsWidth = rcTargetClient.right - rcTargetClient.left;
-  int lsHeight = rcTargetClient.bottom - rcTargetClient.top;
-
-  if (lsWidth <= 0 || lsHeight <= 0)
-    return result;
-
-  int targetWidth = targetWindowRect.right - targetWindowRect.left;
-  int targetHeight = targetWindowRect.bottom - targetWindowRect.top;
-
-  RECT newLSRect = {0, 0, lsWidth, lsHeight};
-  int gap = 0;
-
-  // Position LS relative to Target.
-  if (g_Settings.PositionSide == 0) { // Left
-    newLSRect.left = targetWindowRect.left - lsWidth - gap;
-    // Align with client area top to account for title bar
-    newLSRect.top = rcTargetClient.top;
-  } else if (g_Settings.PositionSide == 1) { // Right
-    newLSRect.left = targetWindowRect.right + gap;
-    // Align with client area top to account for title bar
-    newLSRect.top = rcTargetClient.top;
-  } else if (g_Settings.PositionSide == 2) { // Top
-    int centerX = targetWindowRect.left + targetWidth / 2;
-    newLSRect.left = centerX - lsWidth / 2;
-    newLSRect.top = targetWindowRect.top - lsHeight - gap;
-  } else { // Bottom
-    int centerX = targetWindowRect.left + targetWidth / 2;
-    newLSRect.left = centerX - lsWidth / 2;
-    newLSRect.top = targetWindowRect.bottom + gap;
-  }
-  newLSRect.right = newLSRect.left + lsWidth;
-  newLSRect.bottom = newLSRect.top + lsHeight;
+// Written by the UI thread, read by the watcher and the hooks. Changes are
+// published as whole snapshots so no reader sees a half-applied edit.
+RcuCell<Settings> g_Settings;
 
-  return newLSRect;
-}
+// Fake monitors, with the geometry of the target windows as last applied by
+// the layout engine on the watcher thread, published for the hooks.
+VirtualDisplays g_VirtualDisplays({{0, 0, 1920, 1080}, {0, 0, 1920, 1080}, nullptr, nullptr});
 
-void UpdateTargetRect() {
-  HWND hForeground = GetForegroundWindow();
-  if (!hForeground)
-    return;
+static_assert(kMaxVirtualDisplays == kMaxLayoutTargets,
+              "each tracked target drives one virtual display");
 
-  DWORD pid;
-  GetWindowThreadProcessId(hForeground, &pid);
-  if (pid == GetCurrentProcessId())
-    return; // It's us (LS)
-
-  // It's another app. Assume it's the target.
-  // Use GetClientRect + ClientToScreen to get the content area, excluding title
-  // bar/borders
-  RECT rcClient;
-  if (GetClientRect(hForeground, &rcClient)) {
-    POINT tl = {rcClient.left, rcClient.top};
-    POINT br = {rcClient.right, rcClient.bottom};
-
-    ClientToScreen(hForeground, &tl);
-    ClientToScreen(hForeground, &br);
-
-    RECT rcScreen = {tl.x, tl.y, br.x, br.y};
-
-    // Ensure valid rect
-    if (rcScreen.right > rcScreen.left && rcScreen.bottom > rcScreen.top) {
-      
-      RECT positionedRect = rcScreen;
-      if (g_Settings.PositionMode) {
-          positionedRect = CalculatePositionedRect(hForeground, rcScreen);
-      }
-
-      std::lock_guard<std::mutex> lock(g_StateMutex);
-      g_TargetRect = rcScreen;
-      g_hTargetWindow = hForeground;
-      
-      // Initialize g_LSRect if it's empty or we are not in position mode yet
-      // Also update it if we are in PositionMode to ensure correct initial placement
-      if (g_Settings.PositionMode) {
-          g_LSRect = positionedRect;
-      } else if (g_LSRect.right == 0) {
-          g_LSRect = g_TargetRect;
-      }
-    }
-  }
+// Each tracked target drives the virtual display of its layout slot
+void PublishTargetGeometry(size_t slot, const LayoutGeometry &geometry) {
+  g_VirtualDisplays.Publish(slot, {ToRECT(geometry.targetRect),
+                                   ToRECT(geometry.lsRect),
+                                   (HWND)geometry.targetWindow,
+                                   (HWND)geometry.lsWindow});
 }
 
 // Function pointers for original functions
@@ -146,20 +72,8 @@ void InitHooks();
 void RemoveHooks();
 
 std::string IIDToString(REFIID riid) {
-  if (riid == __uuidof(IDXGIFactory))
-    return "IDXGIFactory";
-  if (riid == __uuidof(IDXGIFactory1))
-    return "IDXGIFactory1";
-  if (riid == __uuidof(IDXGIFactory2))
-    return "IDXGIFactory2";
-  if (riid == __uuidof(IDXGIFactory3))
-    return "IDXGIFactory3";
-  if (riid == __uuidof(IDXGIFactory4))
-    return "IDXGIFactory4";
-  if (riid == __uuidof(IDXGIFactory5))
-    return "IDXGIFactory5";
-  if (riid == __uuidof(IDXGIFactory6))
-    return "IDXGIFactory6";
+  if (const char *name = DxgiIidName(riid))
+    return name;
 
   OLECHAR *guidString;
   if (StringFromCLSID(riid, &guidString) == S_OK) {
@@ -173,165 +87,120 @@ std::string IIDToString(REFIID riid) {
 
 // Global flag to track if we should inject fake monitor
 static bool g_FactoryAlive = false;
-bool g_Running = true;
-
-HWND g_FoundOverlay = nullptr;
-BOOL CALLBACK FindOverlayProc(HWND hwnd, LPARAM lParam) {
-  DWORD pid;
-  GetWindowThreadProcessId(hwnd, &pid);
-  if (pid == GetCurrentProcessId()) {
-    if (!IsWindowVisible(hwnd))
-      return TRUE;
-
-    RECT rc;
-    GetWindowRect(hwnd, &rc);
-
-    // Check match with g_TargetRect OR g_LSRect
-    // We need to lock because we access g_TargetRect/g_LSRect
-    // But we can't lock inside callback easily if EnumWindows is called with lock held.
-    // EnumWindows is called from ApplyWindowRegion which is called from WatcherThread.
-    // WatcherThread should hold the lock or copy the rects before calling EnumWindows.
-    // For now, let's assume we pass the rects via lParam or use globals carefully.
-    // Since this runs in WatcherThread, and UpdateTargetRect runs in Hook thread, we need to be careful.
-    // But FindOverlayProc is called synchronously by EnumWindows.
-    
-    // Let's use the rects passed via lParam to be safe and avoid locking here if possible, 
-    // or just access globals assuming the caller (ApplyWindowRegion) took a snapshot?
-    // No, ApplyWindowRegion calls EnumWindows.
-    
-    // Better: Check if it matches EITHER g_TargetRect OR g_LSRect.
-    // Note: g_TargetRect and g_LSRect might be modified by other thread.
-    // But we are just reading. Torn reads are possible but unlikely to cause crash, just miss.
-    
-    bool matchTarget = (rc.left == g_TargetRect.left && rc.top == g_TargetRect.top &&
-        rc.right == g_TargetRect.right && rc.bottom == g_TargetRect.bottom);
-        
-    bool matchLS = (rc.left == g_LSRect.left && rc.top == g_LSRect.top &&
-        rc.right == g_LSRect.right && rc.bottom == g_LSRect.bottom);
-
-    if (matchTarget || matchLS) {
-      g_FoundOverlay = hwnd;
-      return FALSE;
-    }
-  }
-  return TRUE;
-}
 
-void ApplyWindowRegion() {
-  // Snapshot needed state
-  HWND targetWindow;
-  {
-      std::lock_guard<std::mutex> lock(g_StateMutex);
-      targetWindow = g_hTargetWindow;
-  }
-
-  if (!targetWindow)
+// Layout changes go into the frame capture, next to the presents they may
+// disturb
+void RecordLayoutEvent(LayoutEventType type, size_t slot,
+                       const LayoutRect &rect) {
+  if (!g_FrameCapture.IsActive())
     return;
+  FrameRecord record = {};
+  record.timeNs = VBlankClock::NowNs();
+  record.kind = type == LayoutEventType::TargetMoved
+                    ? FrameEventKind::TargetRect
+                    : FrameEventKind::OverlayMove;
+  record.source = (uint32_t)slot;
+  record.rect = {rect.left, rect.top, rect.right, rect.bottom};
+  g_FrameCapture.Append(record);
+}
 
-  g_FoundOverlay = nullptr;
-  EnumWindows(FindOverlayProc, 0);
-
-  if (g_FoundOverlay) {
-    if (g_Settings.SplitMode) {
-      // Need current rects
-      RECT targetRect;
-      {
-          std::lock_guard<std::mutex> lock(g_StateMutex);
-          targetRect = g_TargetRect;
-      }
-      
-      int w = targetRect.right - targetRect.left;
-      int h = targetRect.bottom - targetRect.top;
-      HRGN hrgn = nullptr;
-
-
-      // Note: SetWindowRgn coordinates are relative to the window's upper-left
-      // corner (0,0)
-      switch (g_Settings.SplitType) {
-      case 0: // Left
-        hrgn = CreateRectRgn(0, 0, w / 2, h);
-        break;
-      case 1: // Right
-        hrgn = CreateRectRgn(w / 2, 0, w, h);
-        break;
-      case 2: // Top
-        hrgn = CreateRectRgn(0, 0, w, h / 2);
-        break;
-      case 3: // Bottom
-        hrgn = CreateRectRgn(0, h / 2, w, h);
-        break;
-      }
+Win32WindowSystem g_WindowSystem;
+LayoutEngine g_Layout(g_WindowSystem, PublishTargetGeometry, RecordLayoutEvent);
+
+LayoutSettings ToLayoutSettings(const Settings &current) {
+  LayoutSettings settings;
+  settings.splitMode = current.SplitMode;
+  settings.splitGrid = current.SplitGrid;
+  settings.splitCell = current.SplitCell;
+  settings.positionMode = current.PositionMode;
+  settings.positionSide = current.PositionSide;
+  settings.targetCount = current.VirtualDisplays;
+  return settings;
+}
 
-      if (hrgn) {
-        SetWindowRgn(g_FoundOverlay, hrgn, TRUE);
-      }
-    } else {
-      // Reset region
-      SetWindowRgn(g_FoundOverlay, NULL, TRUE);
+// Runs on the watcher thread, the only producer of the target geometry. The
+// layout settings are only rebuilt when a new snapshot has been published.
+// Adapter wrappers are shared by every factory, so a factory created after a
+// hotplug would otherwise be served the interned outputs of the old topology
+Win32WindowEventSource g_EventSource(InvalidateOutputTopology);
+
+// Moves are only hooked in the tracked targets' processes and in this one (the
+// LS overlays); re-hooked whenever a slot's target changes
+static void WatchTargetMoves() {
+  static bool first = true;
+  static WindowHandle watched[kMaxLayoutTargets] = {};
+  bool changed = first;
+  for (size_t i = 0; i < kMaxLayoutTargets; i++) {
+    WindowHandle target = g_Layout.Geometry(i).targetWindow;
+    changed |= target != watched[i];
+    watched[i] = target;
+  }
+  if (!changed) return;
+  first = false;
+
+  std::vector<uint32_t> processes = {(uint32_t)GetCurrentProcessId()};
+  for (WindowHandle target : watched) {
+    DWORD process = 0;
+    if (!target || !GetWindowThreadProcessId((HWND)target, &process)) continue;
+    if (std::find(processes.begin(), processes.end(), process) == processes.end()) {
+      processes.push_back(process);
     }
   }
+  g_EventSource.WatchMoves(processes);
 }
 
-void UpdateWindowPositions() {
-  if (!g_Settings.PositionMode) {
-      std::lock_guard<std::mutex> lock(g_StateMutex);
-      g_LSRect = g_TargetRect;
-      return;
-  }
-  
-  HWND targetWindow;
-  RECT targetRect;
-  {
-      std::lock_guard<std::mutex> lock(g_StateMutex);
-      targetWindow = g_hTargetWindow;
-      targetRect = g_TargetRect;
+void ApplyTrackedState() {
+  static uint64_t generation = 0;
+  static LayoutSettings settings;
+  if (g_Settings.Generation() != generation) {
+    auto snapshot = g_Settings.Read();
+    settings = ToLayoutSettings(*snapshot);
+    generation = snapshot.Generation();
   }
+  g_Layout.Apply(settings);
+  WatchTargetMoves();
+}
 
-  if (!targetWindow || !IsWindow(targetWindow)) return;
-
-  RECT newLSRect = CalculatePositionedRect(targetWindow, targetRect);
+bool IsRelevantWindowEvent(const WindowEvent &event) {
+  return g_Layout.IsRelevant(event);
+}
 
-  {
-      std::lock_guard<std::mutex> lock(g_StateMutex);
-      g_LSRect = newLSRect;
-  }
+TargetTracker g_Tracker(g_EventSource, ApplyTrackedState, IsRelevantWindowEvent);
 
-  // Move LS Window (Overlay)
-  if (g_FoundOverlay && IsWindow(g_FoundOverlay)) {
-      RECT currentOverlayRect;
-      GetWindowRect(g_FoundOverlay, &currentOverlayRect);
-      int width = newLSRect.right - newLSRect.left;
-      int height = newLSRect.bottom - newLSRect.top;
-      if (abs(currentOverlayRect.left - newLSRect.left) > 2 || abs(currentOverlayRect.top - newLSRect.top) > 2) {
-          SetWindowPos(g_FoundOverlay, NULL, newLSRect.left, newLSRect.top, width, height, SWP_NOZORDER | SWP_NOACTIVATE);
-      }
-  }
+DWORD WINAPI WatcherThread(LPVOID lpParam) {
+  g_Tracker.Run();
+  return 0;
 }
 
-DWORD WINAPI WatcherThread(LPVOID lpParam) {
-  while (g_Running) {
-    ApplyWindowRegion();
-    UpdateWindowPositions();
-    Sleep(200);
+// Kept separate from the detour: a function using __try cannot also hold
+// objects with destructors (the hook timer).
+static BOOL InvokeMonitorEnumProc(MONITORENUMPROC lpfnEnum, HMONITOR monitor,
+                                  HDC hdc, LPARAM dwData) {
+  __try {
+    return lpfnEnum(monitor, hdc, nullptr, dwData);
+  } __except (EXCEPTION_EXECUTE_HANDLER) {
+    LOG_ERROR("[LS_Windowed] EXCEPTION in callback! Code: 0x%08X",
+              GetExceptionCode());
+    return FALSE;
   }
-  return 0;
 }
 
 // Hook functions
 BOOL WINAPI Detour_EnumDisplayMonitors(HDC hdc, LPCRECT lprcClip,
                                        MONITORENUMPROC lpfnEnum,
                                        LPARAM dwData) {
+  LS_HOOK_TIMER(HookId::EnumDisplayMonitors);
+
   // Call original first
   BOOL result = fpEnumDisplayMonitors(hdc, lprcClip, lpfnEnum, dwData);
 
-  // Now ALWAYS inject our fake Virtual monitor
+  // Now ALWAYS inject our fake Virtual monitors, stopping if the callback does
   if (result) {
-    __try {
-      BOOL callbackResult =
-          lpfnEnum(FAKE_VIRTUAL_MONITOR, hdc, nullptr, dwData);
-    } __except (EXCEPTION_EXECUTE_HANDLER) {
-      Log("[LS_Windowed] EXCEPTION in callback! Code: 0x%08X",
-          GetExceptionCode());
+    size_t displays = g_VirtualDisplays.Count();
+    for (size_t i = 0; i < displays; i++) {
+      if (!InvokeMonitorEnumProc(lpfnEnum, VirtualDisplays::Monitor(i), hdc,
+                                 dwData))
+        break;
     }
   }
 
@@ -339,18 +208,18 @@ BOOL WINAPI Detour_EnumDisplayMonitors(HDC hdc, LPCRECT lprcClip,
 }
 
 BOOL WINAPI Detour_GetMonitorInfoW(HMONITOR hMonitor, LPMONITORINFO lpmi) {
-  if (hMonitor == FAKE_VIRTUAL_MONITOR) {
+  LS_HOOK_TIMER(HookId::GetMonitorInfoW);
+
+  int display = g_VirtualDisplays.IndexOf(hMonitor);
+  if (display >= 0) {
     if (!lpmi)
       return FALSE;
 
-    UpdateTargetRect();
-
-    if (g_Settings.PositionMode) {
-        std::lock_guard<std::mutex> lock(g_StateMutex);
-        lpmi->rcMonitor = g_LSRect;
+    TargetGeometry geometry = g_VirtualDisplays.Geometry(display);
+    if (g_Settings.Read()->PositionMode) {
+        lpmi->rcMonitor = geometry.lsRect;
     } else {
-        std::lock_guard<std::mutex> lock(g_StateMutex);
-        lpmi->rcMonitor = g_TargetRect;
+        lpmi->rcMonitor = geometry.targetRect;
     }
     lpmi->rcWork = lpmi->rcMonitor;
     lpmi->dwFlags = 0; // Not primary
@@ -358,7 +227,8 @@ BOOL WINAPI Detour_GetMonitorInfoW(HMONITOR hMonitor, LPMONITORINFO lpmi) {
     // Handle MONITORINFOEXW if size allows
     if (lpmi->cbSize >= sizeof(MONITORINFOEXW)) {
       LPMONITORINFOEXW lpmiex = (LPMONITORINFOEXW)lpmi;
-      wcsncpy_s(lpmiex->szDevice, FAKE_MONITOR_NAME, CCHDEVICENAME);
+      wcsncpy_s(lpmiex->szDevice, g_VirtualDisplays.MonitorName(display),
+                CCHDEVICENAME);
     }
 
     return TRUE;
@@ -368,17 +238,11 @@ BOOL WINAPI Detour_GetMonitorInfoW(HMONITOR hMonitor, LPMONITORINFO lpmi) {
 }
 
 HRESULT WINAPI Detour_CreateDXGIFactory1(REFIID riid, void **ppFactory) {
+  LS_HOOK_TIMER(HookId::CreateDXGIFactory1);
+
   HRESULT hr = fpCreateDXGIFactory1(riid, ppFactory);
   if (SUCCEEDED(hr) && ppFactory && *ppFactory) {
-    bool shouldWrap = false;
-    if (riid == __uuidof(IDXGIFactory) || riid == __uuidof(IDXGIFactory1) ||
-        riid == __uuidof(IDXGIFactory2) || riid == __uuidof(IDXGIFactory3) ||
-        riid == __uuidof(IDXGIFactory4) || riid == __uuidof(IDXGIFactory5) ||
-        riid == __uuidof(IDXGIFactory6)) {
-      shouldWrap = true;
-    }
-
-    if (shouldWrap) {
+    if (kWrappedFactoryIids.Contains(riid)) {
       IUnknown *pUnk = (IUnknown *)*ppFactory;
       IDXGIFactory6 *pRealFactory6 = nullptr;
 
@@ -389,20 +253,20 @@ HRESULT WINAPI Detour_CreateDXGIFactory1(REFIID riid, void **ppFactory) {
                                          (void **)&pRealFactory6))) {
         *ppFactory = new ProxyDXGIFactory(pRealFactory6);
         pUnk->Release(); // Release original, we returned the proxy
-        Log("[LS_Windowed] Factory wrapped successfully (IDXGIFactory6).");
+        LOG_INFO("[LS_Windowed] Factory wrapped successfully (IDXGIFactory6).");
       } else {
         // Fallback to Factory2 if 6 is not available (older windows?)
         IDXGIFactory2 *pRealFactory2 = nullptr;
         if (SUCCEEDED(pUnk->QueryInterface(__uuidof(IDXGIFactory2),
                                            (void **)&pRealFactory2))) {
-          Log("[LS_Windowed] Warning: IDXGIFactory6 not supported, trying "
-              "IDXGIFactory2 path.");
+          LOG_WARN("[LS_Windowed] Warning: IDXGIFactory6 not supported, trying "
+                   "IDXGIFactory2 path.");
           *ppFactory = new ProxyDXGIFactory(
               (IDXGIFactory6 *)
                   pRealFactory2); // DANGEROUS CAST if we use 6 methods
           pUnk->Release();
         } else {
-          Log("[LS_Windowed] Failed to QI for IDXGIFactory2/6. Cannot wrap.");
+          LOG_ERROR("[LS_Windowed] Failed to QI for IDXGIFactory2/6. Cannot wrap.");
         }
       }
     }
@@ -412,37 +276,199 @@ HRESULT WINAPI Detour_CreateDXGIFactory1(REFIID riid, void **ppFactory) {
 
 // --- Config Helper ---
 
-extern "C" __declspec(dllexport) void AddonInitialize(IHost* host, ImGuiContext* ctx, void* alloc_func, void* free_func, void* user_data);
+void ApplyVBlankRate(const Settings& settings) {
+    for (VBlankClock& clock : g_VirtualVBlank) {
+        clock.SetPeriodOverride(settings.VBlankRate > 0 ? 1000000000ull / settings.VBlankRate : 0);
+    }
+}
+
+// Clamps settings.VirtualDisplays to the supported range
+void ApplyVirtualDisplayCount(Settings& settings) {
+    if (g_VirtualDisplays.SetCount((size_t)(settings.VirtualDisplays > 0 ? settings.VirtualDisplays : 1))) {
+        InvalidateOutputTopology(); // Re-enumerate the fake DXGI outputs
+    }
+    settings.VirtualDisplays = (int)g_VirtualDisplays.Count();
+}
 
 void LoadSettings(const std::wstring& path) {
-    g_Settings.SplitMode = GetPrivateProfileIntW(L"Settings", L"SplitMode", 0, path.c_str());
-    g_Settings.SplitType = GetPrivateProfileIntW(L"Settings", L"SplitType", 0, path.c_str());
-    g_Settings.PositionMode = GetPrivateProfileIntW(L"Settings", L"PositionMode", 0, path.c_str());
-    g_Settings.PositionSide = GetPrivateProfileIntW(L"Settings", L"PositionSide", 1, path.c_str());
+    Settings settings;
+    settings.SplitMode = GetPrivateProfileIntW(L"Settings", L"SplitMode", 0, path.c_str());
+    // SplitGrid replaces the four fixed split types; configs without it keep their SplitType
+    wchar_t grid[128] = {};
+    GetPrivateProfileStringW(L"Settings", L"SplitGrid", L"", grid, 128, path.c_str());
+    std::string gridText(grid, grid + wcslen(grid));
+    if (ParseGridLayout(gridText.c_str(), &settings.SplitGrid)) {
+        settings.SplitCell = GetPrivateProfileIntW(L"Settings", L"SplitCell", 0, path.c_str());
+    } else {
+        int splitType = GetPrivateProfileIntW(L"Settings", L"SplitType", 0, path.c_str());
+        settings.SplitGrid = LegacySplitGrid(splitType, &settings.SplitCell);
+    }
+    if (settings.SplitCell < 0 || settings.SplitCell >= settings.SplitGrid.cellCount) settings.SplitCell = 0;
+    settings.PositionMode = GetPrivateProfileIntW(L"Settings", L"PositionMode", 0, path.c_str());
+    settings.PositionSide = GetPrivateProfileIntW(L"Settings", L"PositionSide", 1, path.c_str());
+    settings.VBlankRate = GetPrivateProfileIntW(L"Settings", L"VBlankRate", 0, path.c_str());
+    settings.VirtualDisplays = GetPrivateProfileIntW(L"Settings", L"VirtualDisplays", 1, path.c_str());
+    ApplyVBlankRate(settings);
+    ApplyVirtualDisplayCount(settings);
+    g_Settings.Publish(settings);
+}
+
+// Called by g_ConfigSync on its thread with a copy of config.ini to fill. The
+// whole [Settings] section is written in one call, so the copy is rewritten
+// once per flush rather than once per key. Entries the addon does not own (the
+// legacy SplitType, keys added by hand) are read back and kept.
+bool SaveSettings(const std::filesystem::path& path) {
+    static const wchar_t* const kOwnedKeys[] = {L"SplitMode",    L"SplitGrid",  L"SplitCell",      L"PositionMode",
+                                                L"PositionSide", L"VBlankRate", L"VirtualDisplays"};
+    std::wstring file = path.wstring();
+
+    // Section format: key=value entries, each NUL-terminated, then a final NUL
+    std::vector<wchar_t> existing(4096);
+    DWORD length;
+    while ((length = GetPrivateProfileSectionW(L"Settings", existing.data(), (DWORD)existing.size(), file.c_str())) ==
+           existing.size() - 2) {
+        existing.resize(existing.size() * 2); // Truncated
+    }
+    std::wstring section;
+    for (const wchar_t* entry = existing.data(); entry < existing.data() + length && *entry;
+         entry += wcslen(entry) + 1) {
+        const wchar_t* equals = wcschr(entry, L'=');
+        size_t keyLength = equals ? (size_t)(equals - entry) : wcslen(entry);
+        while (keyLength && entry[keyLength - 1] == L' ') keyLength--;
+        bool owned = std::any_of(std::begin(kOwnedKeys), std::end(kOwnedKeys), [&](const wchar_t* key) {
+            return wcslen(key) == keyLength && _wcsnicmp(key, entry, keyLength) == 0;
+        });
+        if (owned) continue;
+        section += entry;
+        section += L'\0';
+    }
+
+    auto settings = g_Settings.Read();
+    std::string grid = FormatGridLayout(settings->SplitGrid);
+    auto add = [&](const wchar_t* key, const std::wstring& value) {
+        section += key;
+        section += L'=';
+        section += value;
+        section += L'\0';
+    };
+    add(L"SplitMode", std::to_wstring(settings->SplitMode));
+    add(L"SplitGrid", std::wstring(grid.begin(), grid.end()));
+    add(L"SplitCell", std::to_wstring(settings->SplitCell));
+    add(L"PositionMode", std::to_wstring(settings->PositionMode));
+    add(L"PositionSide", std::to_wstring(settings->PositionSide));
+    add(L"VBlankRate", std::to_wstring(settings->VBlankRate));
+    add(L"VirtualDisplays", std::to_wstring(settings->VirtualDisplays));
+    section += L'\0';
+    return WritePrivateProfileSectionW(L"Settings", section.c_str(), file.c_str()) != FALSE;
 }
 
-void SaveSettings() {
-    HMODULE hModule = NULL;
-    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCWSTR)&AddonInitialize, &hModule);
-    wchar_t path[MAX_PATH];
-    GetModuleFileNameW(hModule, path, MAX_PATH);
-    wchar_t* lastSlash = wcsrchr(path, L'\\');
-    if (lastSlash) *(lastSlash + 1) = L'\0';
-    std::wstring configPath = std::wstring(path) + L"config.ini";
-
-    WritePrivateProfileStringW(L"Settings", L"SplitMode", std::to_wstring(g_Settings.SplitMode).c_str(), configPath.c_str());
-    WritePrivateProfileStringW(L"Settings", L"SplitType", std::to_wstring(g_Settings.SplitType).c_str(), configPath.c_str());
-    WritePrivateProfileStringW(L"Settings", L"PositionMode", std::to_wstring(g_Settings.PositionMode).c_str(), configPath.c_str());
-    WritePrivateProfileStringW(L"Settings", L"PositionSide", std::to_wstring(g_Settings.PositionSide).c_str(), configPath.c_str());
+// Applies the fields that differ between before and edited to current
+void MergeSettingsEdits(Settings& current, const Settings& before, const Settings& edited) {
+    if (edited.SplitMode != before.SplitMode) current.SplitMode = edited.SplitMode;
+    if (edited.SplitGrid != before.SplitGrid) current.SplitGrid = edited.SplitGrid;
+    if (edited.SplitCell != before.SplitCell) current.SplitCell = edited.SplitCell;
+    if (current.SplitCell >= current.SplitGrid.cellCount) current.SplitCell = 0;
+    if (edited.PositionMode != before.PositionMode) current.PositionMode = edited.PositionMode;
+    if (edited.PositionSide != before.PositionSide) current.PositionSide = edited.PositionSide;
+    if (edited.VBlankRate != before.VBlankRate) current.VBlankRate = edited.VBlankRate;
+    if (edited.VirtualDisplays != before.VirtualDisplays) current.VirtualDisplays = edited.VirtualDisplays;
+}
+
+std::filesystem::path g_ConfigPath;
+
+// Runs on the config thread after config.ini was edited outside the addon
+void ReloadSettings() {
+    LoadSettings(g_ConfigPath.wstring());
+    LOG_INFO("[LS_Windowed] config.ini changed on disk, settings reloaded");
+    g_Tracker.RequestUpdate();
+}
+
+ConfigSync g_ConfigSync(SaveSettings, ReloadSettings);
+
+DWORD WINAPI ConfigThread(LPVOID lpParam) {
+    g_ConfigSync.Run();
+    return 0;
 }
 
 extern "C" __declspec(dllexport) void AddonInitialize(IHost* host, ImGuiContext* ctx, void* alloc_func, void* free_func, void* user_data) {
     g_ImGuiContext = ctx;
-    Log("[LS_Windowed] AddonInitialize called");
+    LOG_INFO("[LS_Windowed] AddonInitialize called");
 }
 
 extern "C" __declspec(dllexport) void AddonShutdown() {
-    Log("[LS_Windowed] AddonShutdown called");
+    LOG_INFO("[LS_Windowed] AddonShutdown called");
+
+    g_ConfigSync.Flush();
+    ConfigSyncStats config = g_ConfigSync.GetStats();
+    LOG_INFO("[LS_Windowed] Config: %llu changes, %llu writes (%llu failed), %llu external reloads",
+             (unsigned long long)config.changes, (unsigned long long)config.writes,
+             (unsigned long long)config.failedWrites, (unsigned long long)config.reloads);
+
+    TrackerStats stats = g_Tracker.GetStats();
+    auto now = std::chrono::steady_clock::now();
+    LOG_INFO("[LS_Windowed] Tracker (%s): %llu wake-ups (%.1f/min), %llu leading to an apply (%.1f/min), "
+             "%llu applies, %llu/%llu events ignored, avg latency %.0f us, max %.0f us",
+             stats.eventDriven ? "event-driven" : "polling", (unsigned long long)stats.wakeups,
+             stats.WakeupsPerMinute(now), (unsigned long long)stats.applyingWakeups,
+             stats.ApplyingWakeupsPerMinute(now), (unsigned long long)stats.applies,
+             (unsigned long long)stats.ignoredEvents, (unsigned long long)stats.events,
+             stats.AverageLatencyUs(), stats.latencyMaxUs);
+    LOG_INFO("[LS_Windowed] Overlay lookups: %llu full scans, %llu cache hits, %llu invalidations",
+             (unsigned long long)g_Layout.overlayStats.fullScans.load(),
+             (unsigned long long)g_Layout.overlayStats.cacheHits.load(),
+             (unsigned long long)g_Layout.overlayStats.invalidations.load());
+    LOG_INFO("[LS_Windowed] Window regions: %llu applied, %llu skipped (unchanged)",
+             (unsigned long long)g_Layout.regionStats.applied.load(),
+             (unsigned long long)g_Layout.regionStats.skipped.load());
+    LOG_INFO("[LS_Windowed] Targets: %llu registered, %llu evicted, %llu expired, %llu refreshes, %llu publishes",
+             (unsigned long long)g_Layout.targetStats.registered.load(),
+             (unsigned long long)g_Layout.targetStats.evicted.load(),
+             (unsigned long long)g_Layout.targetStats.expired.load(),
+             (unsigned long long)g_Layout.targetStats.refreshes.load(),
+             (unsigned long long)g_Layout.targetStats.publishes.load());
+    FollowSummary follow = g_Layout.followLatency.Summarize();
+    if (follow.follows || follow.missed) {
+        LOG_INFO("[LS_Windowed] Move-to-follow: %llu follows (%llu timed from move events), p50 %.2f ms, "
+                 "p90 %.2f ms, p99 %.2f ms, max %.2f ms; %llu already in place, %llu missed",
+                 (unsigned long long)follow.follows, (unsigned long long)follow.fromEvents, follow.p50Ns / 1e6,
+                 follow.p90Ns / 1e6, follow.p99Ns / 1e6, follow.maxNs / 1e6, (unsigned long long)follow.inPlace,
+                 (unsigned long long)follow.missed);
+    }
+
+    for (size_t i = 0; i < kMaxVirtualDisplays; i++) {
+        VBlankStats vblank = g_VirtualVBlank[i].Stats();
+        if (!vblank.waits) continue;
+        LOG_INFO("[LS_Windowed] Virtual display %d vblank: %llu waits, %llu missed, lateness mean %.1f us, "
+                 "stddev %.1f us, p99 %.0f us, max %.1f us",
+                 (int)i + 1, (unsigned long long)vblank.waits, (unsigned long long)vblank.missed,
+                 vblank.meanLatenessNs / 1000.0, vblank.stddevNs / 1000.0, vblank.p99Ns / 1000.0,
+                 vblank.maxNs / 1000.0);
+    }
+
+    g_SwapChainPresents.ForEach([](const PresentStats& presents) {
+        PresentSummary summary = presents.Summarize();
+        LOG_INFO("[LS_Windowed] Swap chain of window %p: %llu presents (%llu failed); last %zu frames: %.1f fps, "
+                 "frame time p50 %.2f ms, p99 %.2f ms, max %.2f ms, present p99 %.0f us",
+                 (void*)(uintptr_t)presents.Window(), (unsigned long long)summary.presents,
+                 (unsigned long long)summary.failed, summary.window, summary.framesPerSecond,
+                 summary.frameP50Ns / 1e6, summary.frameP99Ns / 1e6, summary.frameMaxNs / 1e6,
+                 summary.costP99Ns / 1e3);
+    });
+
+#if LS_HOOK_STATS
+    HookSummary hooks[kHookCount];
+    HookStats::Summarize(hooks);
+    for (size_t i = 0; i < kHookCount; i++) {
+        if (!hooks[i].calls) continue;
+        LOG_INFO("[LS_Windowed] Hook %s: %llu calls (%.1f/s), p50 %.0f ns, p99 %.0f ns, max %.0f ns",
+                 HookName((HookId)i), (unsigned long long)hooks[i].calls, hooks[i].callsPerSecond, hooks[i].p50Ns,
+                 hooks[i].p99Ns, hooks[i].maxNs);
+    }
+#endif
+
+    // Outside the loader lock, unlike DLL_PROCESS_DETACH: the only place the
+    // writer thread can be joined
+    Logger::Shutdown();
 }
 
 extern "C" __declspec(dllexport) void AddonRenderSettings() {
@@ -452,27 +478,51 @@ extern "C" __declspec(dllexport) void AddonRenderSettings() {
     ImGui::TextWrapped("Windowed Mode Addon allows you to force windowed mode and split screen.");
     ImGui::Separator();
 
-    bool splitMode = g_Settings.SplitMode;
-    bool positionMode = g_Settings.PositionMode;
+    // Edits go to a private copy, merged into the latest snapshot at the end
+    const Settings frameStart = *g_Settings.Read();
+    Settings settings = frameStart;
+    bool splitMode = settings.SplitMode;
+    bool positionMode = settings.PositionMode;
     bool changed = false;
 
     // Disable Split Mode if Position Mode is active
     if (positionMode) ImGui::BeginDisabled();
     if (ImGui::Checkbox("Enable Split Mode", &splitMode)) {
-        g_Settings.SplitMode = splitMode;
-        Log("[LS_Windowed] SplitMode changed to %d", splitMode);
+        settings.SplitMode = splitMode;
+        LOG_INFO("[LS_Windowed] SplitMode changed to %d", splitMode);
         changed = true;
     }
     if (positionMode) ImGui::EndDisabled();
 
     if (splitMode) {
-        const char* splitTypes[] = { "Left", "Right", "Top", "Bottom" };
-        int currentSplitType = g_Settings.SplitType;
-        if (ImGui::Combo("Split Type", &currentSplitType, splitTypes, 4)) {
-            g_Settings.SplitType = currentSplitType;
-            Log("[LS_Windowed] SplitType changed to %d", currentSplitType);
+        // Presets; any other layout set in config.ini shows up as Custom
+        static const char* gridNames[] = { "Left / Right", "Top / Bottom", "2x2", "3x1", "1x3", "3x3", "Large + 2", "Custom" };
+        static const char* gridSpecs[] = { "2x1", "1x2", "2x2", "3x1", "1x3", "3x3", "3x2:0,0,2,2;2,0,1,1;2,1,1,1" };
+        constexpr int presetCount = sizeof(gridSpecs) / sizeof(gridSpecs[0]);
+        int currentGrid = presetCount;
+        for (int i = 0; i < presetCount; i++) {
+            GridLayout preset;
+            if (ParseGridLayout(gridSpecs[i], &preset) && preset == settings.SplitGrid) currentGrid = i;
+        }
+        if (ImGui::Combo("Split Grid", &currentGrid, gridNames, presetCount + 1) && currentGrid < presetCount) {
+            ParseGridLayout(gridSpecs[currentGrid], &settings.SplitGrid);
+            if (settings.SplitCell >= settings.SplitGrid.cellCount) settings.SplitCell = 0;
+            LOG_INFO("[LS_Windowed] SplitGrid changed to %s", gridSpecs[currentGrid]);
+            changed = true;
+        }
+        if (currentGrid == presetCount) {
+            ImGui::TextDisabled("Custom grid from config.ini: %s", FormatGridLayout(settings.SplitGrid).c_str());
+        }
+
+        int visibleCell = settings.SplitCell + 1;
+        if (ImGui::SliderInt("Visible Cell", &visibleCell, 1, settings.SplitGrid.cellCount)) {
+            settings.SplitCell = visibleCell - 1;
+            LOG_INFO("[LS_Windowed] SplitCell changed to %d", settings.SplitCell);
             changed = true;
         }
+        if (settings.VirtualDisplays > 1) {
+            ImGui::TextDisabled("Further displays show the following cells.");
+        }
     }
 
     ImGui::Separator();
@@ -480,24 +530,186 @@ extern "C" __declspec(dllexport) void AddonRenderSettings() {
     // Disable Position Mode if Split Mode is active
     if (splitMode) ImGui::BeginDisabled();
     if (ImGui::Checkbox("Enable Window Positioning", &positionMode)) {
-        g_Settings.PositionMode = positionMode;
-        Log("[LS_Windowed] PositionMode changed to %d", positionMode);
+        settings.PositionMode = positionMode;
+        LOG_INFO("[LS_Windowed] PositionMode changed to %d", positionMode);
         changed = true;
     }
     if (splitMode) ImGui::EndDisabled();
 
     if (positionMode) {
         const char* posTypes[] = { "Left", "Right", "Top", "Bottom" };
-        int currentPosSide = g_Settings.PositionSide;
+        int currentPosSide = settings.PositionSide;
         if (ImGui::Combo("Position Side", &currentPosSide, posTypes, 4)) {
-            g_Settings.PositionSide = currentPosSide;
-            Log("[LS_Windowed] PositionSide changed to %d", currentPosSide);
+            settings.PositionSide = currentPosSide;
+            LOG_INFO("[LS_Windowed] PositionSide changed to %d", currentPosSide);
             changed = true;
         }
         ImGui::TextWrapped("Positions the virtual window relative to the target window.");
     }
 
-    if (changed) SaveSettings();
+    ImGui::Separator();
+
+    int virtualDisplays = settings.VirtualDisplays;
+    if (ImGui::SliderInt("Virtual Displays", &virtualDisplays, 1, (int)kMaxVirtualDisplays)) {
+        settings.VirtualDisplays = virtualDisplays;
+        ApplyVirtualDisplayCount(settings);
+        LOG_INFO("[LS_Windowed] VirtualDisplays changed to %d", settings.VirtualDisplays);
+        changed = true;
+    }
+    ImGui::TextDisabled("Each display follows its own game window; focus a window to assign it.");
+
+    int vblankRate = settings.VBlankRate;
+    if (ImGui::InputInt("Virtual Refresh Rate (Hz)", &vblankRate, 1, 10)) {
+        settings.VBlankRate = vblankRate < 0 ? 0 : (vblankRate > 1000 ? 1000 : vblankRate);
+        LOG_INFO("[LS_Windowed] VBlankRate changed to %d", settings.VBlankRate);
+        ApplyVBlankRate(settings);
+        changed = true;
+    }
+    ImGui::TextDisabled("0 follows the refresh rate of the real display.");
+
+    if (ImGui::CollapsingHeader("Diagnostics")) {
+        ImGui::Text("Overlay lookups: %llu full scans, %llu cache hits, %llu invalidations",
+                    (unsigned long long)g_Layout.overlayStats.fullScans.load(),
+                    (unsigned long long)g_Layout.overlayStats.cacheHits.load(),
+                    (unsigned long long)g_Layout.overlayStats.invalidations.load());
+        ImGui::Text("Window regions: %llu applied, %llu skipped",
+                    (unsigned long long)g_Layout.regionStats.applied.load(),
+                    (unsigned long long)g_Layout.regionStats.skipped.load());
+
+        ImGui::Text("Targets: %llu registered, %llu evicted, %llu expired",
+                    (unsigned long long)g_Layout.targetStats.registered.load(),
+                    (unsigned long long)g_Layout.targetStats.evicted.load(),
+                    (unsigned long long)g_Layout.targetStats.expired.load());
+        FollowSummary follow = g_Layout.followLatency.Summarize();
+        ImGui::Text("Move-to-follow: %llu follows, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms",
+                    (unsigned long long)follow.follows, follow.p50Ns / 1e6, follow.p90Ns / 1e6, follow.p99Ns / 1e6,
+                    follow.maxNs / 1e6);
+        ImGui::Text("  %llu timed from move events, %llu already in place, %llu missed",
+                    (unsigned long long)follow.fromEvents, (unsigned long long)follow.inPlace,
+                    (unsigned long long)follow.missed);
+        if (ImGui::Button("Reset Follow Statistics")) {
+            g_Layout.followLatency.Reset();
+        }
+        ImGui::Text("Settings: generation %llu, %llu old snapshots awaiting readers",
+                    (unsigned long long)g_Settings.Generation(), (unsigned long long)g_Settings.PendingReclaim());
+        ConfigSyncStats config = g_ConfigSync.GetStats();
+        ImGui::Text("config.ini: %llu changes, %llu writes, %llu failed, %llu external reloads",
+                    (unsigned long long)config.changes, (unsigned long long)config.writes,
+                    (unsigned long long)config.failedWrites, (unsigned long long)config.reloads);
+        for (size_t i = 0; i < g_VirtualDisplays.Count(); i++) {
+            TargetGeometry geometry = g_VirtualDisplays.Geometry(i);
+            RECT rect = geometry.targetRect;
+            ImGui::Text("Virtual display %d: %ldx%ld at (%ld, %ld), window %p", (int)i + 1,
+                        (long)(rect.right - rect.left), (long)(rect.bottom - rect.top), (long)rect.left,
+                        (long)rect.top, (void*)geometry.targetWindow);
+        }
+
+        for (size_t i = 0; i < g_VirtualDisplays.Count(); i++) {
+            const VBlankClock& clock = g_VirtualVBlank[i];
+            VBlankStats vblank = clock.Stats();
+            ImGui::Text("Display %d vblank: %.2f Hz, vblank #%llu, %llu waits, %llu missed", (int)i + 1,
+                        1e9 / (double)clock.Period(),
+                        (unsigned long long)clock.LastVBlank(VBlankClock::NowNs()).count,
+                        (unsigned long long)vblank.waits, (unsigned long long)vblank.missed);
+            ImGui::Text("  Wake-up lateness: mean %.1f us, stddev %.1f us, p50 %.0f us, p99 %.0f us, max %.1f us",
+                        vblank.meanLatenessNs / 1000.0, vblank.stddevNs / 1000.0, vblank.p50Ns / 1000.0,
+                        vblank.p99Ns / 1000.0, vblank.maxNs / 1000.0);
+            ImGui::Text("  Final spin budget: %.0f us", vblank.spinNs / 1000.0);
+        }
+        if (ImGui::Button("Reset VBlank Statistics")) {
+            for (VBlankClock& clock : g_VirtualVBlank) clock.ResetStats();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Present Timing")) {
+        int swapChains = 0;
+        g_SwapChainPresents.ForEach([&](const PresentStats& presents) {
+            PresentSummary summary = presents.Summarize();
+            ImGui::Text("Swap chain %d, window %p: %llu presents (%llu failed), %.1f fps, sync interval %u",
+                        ++swapChains, (void*)(uintptr_t)presents.Window(), (unsigned long long)summary.presents,
+                        (unsigned long long)summary.failed, summary.framesPerSecond,
+                        (unsigned)summary.last.syncInterval);
+            ImGui::Text("  Frame time: p50 %.2f ms, p99 %.2f ms, max %.2f ms", summary.frameP50Ns / 1e6,
+                        summary.frameP99Ns / 1e6, summary.frameMaxNs / 1e6);
+            ImGui::Text("  Present call: p50 %.0f us, p99 %.0f us, max %.0f us", summary.costP50Ns / 1e3,
+                        summary.costP99Ns / 1e3, summary.costMaxNs / 1e3);
+        });
+        if (swapChains) {
+            ImGui::TextDisabled("Over the last %d presents of each swap chain.", (int)PresentStats::kCapacity);
+        } else {
+            ImGui::TextDisabled("No swap chain has been created since the addon loaded.");
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Frame Capture")) {
+        if (g_FrameCapture.IsActive()) {
+            ImGui::Text("Capturing: %llu records, %llu dropped (file full)",
+                        (unsigned long long)g_FrameCapture.Records(), (unsigned long long)g_FrameCapture.Dropped());
+            if (ImGui::Button("Stop Capture")) {
+                g_FrameCapture.Stop();
+                LOG_INFO("[LS_Windowed] Frame capture stopped: %llu records, %llu dropped",
+                         (unsigned long long)g_FrameCapture.Records(), (unsigned long long)g_FrameCapture.Dropped());
+            }
+        } else {
+            if (ImGui::Button("Start Capture")) {
+                std::filesystem::path capturePath = g_ConfigPath.parent_path() / "LS_Windowed.framecap";
+                if (g_FrameCapture.Start(capturePath, g_VirtualVBlank[0].Period())) {
+                    LOG_INFO("[LS_Windowed] Frame capture started");
+                } else {
+                    LOG_ERROR("[LS_Windowed] Cannot create LS_Windowed.framecap");
+                }
+            }
+            if (g_FrameCapture.Records()) {
+                ImGui::SameLine();
+                ImGui::Text("Last capture: %llu records", (unsigned long long)g_FrameCapture.Records());
+            }
+        }
+        ImGui::TextDisabled("Records presents and layout changes to LS_Windowed.framecap; read it with ls_framecap.");
+    }
+
+#if LS_HOOK_STATS
+    if (ImGui::CollapsingHeader("Hook Statistics")) {
+        HookSummary hooks[kHookCount];
+        HookStats::Summarize(hooks);
+        if (ImGui::BeginTable("HookStats", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Hook");
+            ImGui::TableSetupColumn("Calls");
+            ImGui::TableSetupColumn("Calls/s");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p99");
+            ImGui::TableSetupColumn("Max");
+            ImGui::TableHeadersRow();
+            for (size_t i = 0; i < kHookCount; i++) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(HookName((HookId)i));
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)hooks[i].calls);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", hooks[i].callsPerSecond);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f us", hooks[i].p50Ns / 1000.0);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f us", hooks[i].p99Ns / 1000.0);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f us", hooks[i].maxNs / 1000.0);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TextDisabled("Percentiles are histogram bucket bounds (within 2x).");
+        if (ImGui::Button("Reset Statistics")) {
+            HookStats::Reset();
+        }
+    }
+#endif
+
+    if (changed) {
+        // Only the fields edited this frame are applied, to the latest
+        // snapshot: a reload of config.ini that landed mid-frame survives
+        g_Settings.Update([&](Settings& current) { MergeSettingsEdits(current, frameStart, settings); });
+        g_ConfigSync.MarkDirty(); // Written off this thread once the edits settle
+        g_Tracker.RequestUpdate();
+    }
 }
 
 extern "C" __declspec(dllexport) uint32_t GetAddonCapabilities() {
@@ -524,31 +736,39 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call,
     GetModuleFileNameW(hModule, buffer, MAX_PATH);
     std::filesystem::path dllPath(buffer);
     std::wstring logPath =
-        (dllPath.parent_path() / "LS_Windowed.log").wstring();
+        (dllPath.parent_path() / "LS_Windowed.binlog").wstring();
     Logger::Init(logPath);
 
-    LoadSettings((dllPath.parent_path() / "config.ini").wstring());
+    g_ConfigPath = dllPath.parent_path() / "config.ini";
+    LoadSettings(g_ConfigPath.wstring());
+    g_ConfigSync.Open(g_ConfigPath);
 
-    Log("[LS_Windowed] DLL_PROCESS_ATTACH");
+    LOG_INFO("[LS_Windowed] DLL_PROCESS_ATTACH");
 
     CreateThread(nullptr, 0, (LPTHREAD_START_ROUTINE)InitHooks, nullptr, 0,
                  nullptr);
     CreateThread(nullptr, 0, WatcherThread, nullptr, 0, nullptr);
+    CreateThread(nullptr, 0, ConfigThread, nullptr, 0, nullptr);
   } break;
   case DLL_PROCESS_DETACH:
-    g_Running = false;
-    Log("[LS_Windowed] DLL_PROCESS_DETACH");
+    g_Tracker.Stop();
+    g_ConfigSync.Stop();
+    g_FrameCapture.Stop();
+    LOG_INFO("[LS_Windowed] DLL_PROCESS_DETACH");
     RemoveHooks();
-    Logger::Close();
+    Logger::Close(lpReserved != nullptr);
     break;
   }
   return TRUE;
 }
 
 void InitHooks() {
-  Log("[LS_Windowed] Initializing hooks...");
+  LOG_INFO("[LS_Windowed] Initializing hooks...");
+  if (!CheckIidTables())
+    LOG_ERROR("[LS_Windowed] IID tables disagree with the SDK headers; "
+              "QueryInterface on the proxies is unreliable.");
   if (MH_Initialize() != MH_OK) {
-    Log("[LS_Windowed] Failed to initialize MinHook.");
+    LOG_ERROR("[LS_Windowed] Failed to initialize MinHook.");
     return;
   }
 
@@ -556,29 +776,29 @@ void InitHooks() {
   if (MH_CreateHookApi(L"user32.dll", "EnumDisplayMonitors",
                        &Detour_EnumDisplayMonitors,
                        (LPVOID *)&fpEnumDisplayMonitors) != MH_OK) {
-    Log("[LS_Windowed] Failed to hook EnumDisplayMonitors.");
+    LOG_ERROR("[LS_Windowed] Failed to hook EnumDisplayMonitors.");
   }
 
   if (MH_CreateHookApi(L"user32.dll", "GetMonitorInfoW",
                        &Detour_GetMonitorInfoW,
                        (LPVOID *)&fpGetMonitorInfoW) != MH_OK) {
-    Log("[LS_Windowed] Failed to hook GetMonitorInfoW.");
+    LOG_ERROR("[LS_Windowed] Failed to hook GetMonitorInfoW.");
   }
 
   // Hook DXGI
   if (MH_CreateHookApi(L"dxgi.dll", "CreateDXGIFactory1",
                        &Detour_CreateDXGIFactory1,
                        (LPVOID *)&fpCreateDXGIFactory1) != MH_OK) {
-    Log("[LS_Windowed] Failed to hook CreateDXGIFactory1.");
+    LOG_ERROR("[LS_Windowed] Failed to hook CreateDXGIFactory1.");
   }
 
   // Enable hooks
   if (MH_EnableHook(MH_ALL_HOOKS) != MH_OK) {
-    Log("[LS_Windowed] Failed to enable hooks.");
+    LOG_ERROR("[LS_Windowed] Failed to enable hooks.");
     return;
   }
 
-  Log("[LS_Windowed] Hooks initialized.");
+  LOG_INFO("[LS_Windowed] Hooks initialized.");
 }
 
 void RemoveHooks() {
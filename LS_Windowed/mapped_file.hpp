@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// A file of fixed size mapped read/write into memory. Stores into the mapping
+// reach the page cache immediately, so they survive the process crashing.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Creates (or truncates) the file at path, sizes it and maps it
+    bool Create(const std::filesystem::path& path, size_t size);
+    void Flush(); // Writes dirty pages back to disk
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
@@ -0,0 +1,113 @@
+#include "mode_table.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Resolutions commonly listed by real monitors below their native size
+constexpr ModeSize kCommonSizes[] = {
+    {640, 480},   {800, 600},   {1024, 768},  {1280, 720},  {1280, 800},  {1280, 1024},
+    {1366, 768},  {1440, 900},  {1600, 900},  {1680, 1050}, {1920, 1080}, {1920, 1200},
+    {2560, 1080}, {2560, 1440}, {3440, 1440}, {3840, 2160},
+};
+
+// Rates closer than this are the same mode (e.g. 60000/1000 and 60/1)
+constexpr double kSameRateHz = 0.001;
+
+bool RateLess(const ModeRate& a, const ModeRate& b) { return a.Hz() < b.Hz(); }
+
+// Sorts by Hz and drops duplicates and unspecified rates
+void NormalizeRates(std::vector<ModeRate>& rates) {
+    rates.erase(std::remove_if(rates.begin(), rates.end(), [](const ModeRate& rate) { return !rate.IsSpecified(); }),
+                rates.end());
+    std::sort(rates.begin(), rates.end(), RateLess);
+    rates.erase(std::unique(rates.begin(), rates.end(),
+                            [](const ModeRate& a, const ModeRate& b) { return std::fabs(a.Hz() - b.Hz()) < kSameRateHz; }),
+                rates.end());
+}
+
+uint64_t Area(const ModeSize& size) { return (uint64_t)size.width * size.height; }
+
+bool AreaLess(const ModeSize& a, const ModeSize& b) {
+    return Area(a) != Area(b) ? Area(a) < Area(b) : a.width < b.width;
+}
+
+uint64_t AreaDistance(const ModeSize& a, const ModeSize& b) {
+    return Area(a) > Area(b) ? Area(a) - Area(b) : Area(b) - Area(a);
+}
+
+} // namespace
+
+ModeTable::ModeTable(ModeSize native, std::vector<ModeRate> rates) : m_native(native), m_rates(std::move(rates)) {
+    NormalizeRates(m_rates);
+    if (m_rates.empty()) m_rates.push_back({60, 1});
+    // Keep the highest rates if the host reports more than we list
+    if (m_rates.size() > kMaxRates) m_rates.erase(m_rates.begin(), m_rates.end() - kMaxRates);
+
+    if (native.width && native.height) {
+        for (const ModeSize& size : kCommonSizes) {
+            if (size.width <= native.width && size.height <= native.height && !(size == native)) {
+                m_sizes.push_back(size);
+            }
+        }
+        m_sizes.push_back(native);
+        std::sort(m_sizes.begin(), m_sizes.end());
+        m_byArea = m_sizes;
+        std::sort(m_byArea.begin(), m_byArea.end(), AreaLess);
+    }
+}
+
+DisplayMode ModeTable::ModeAt(size_t index) const {
+    return {m_sizes[index / m_rates.size()], m_rates[index % m_rates.size()]};
+}
+
+DisplayMode ModeTable::FindClosest(ModeSize size, ModeRate refresh) const {
+    if (m_sizes.empty()) return {m_native, m_rates.back()};
+
+    ModeSize chosen = m_native;
+    if (size.width && size.height) {
+        // The nearest size is the first one not below the request or the one before it
+        auto it = std::lower_bound(m_byArea.begin(), m_byArea.end(), size, AreaLess);
+        if (it == m_byArea.end()) {
+            chosen = m_byArea.back();
+        } else {
+            chosen = *it;
+            if (it != m_byArea.begin() && AreaDistance(*(it - 1), size) < AreaDistance(*it, size)) chosen = *(it - 1);
+        }
+    }
+
+    if (!refresh.IsSpecified()) return {chosen, m_rates.back()};
+    auto rate = std::lower_bound(m_rates.begin(), m_rates.end(), refresh, RateLess);
+    if (rate == m_rates.end()) return {chosen, m_rates.back()};
+    if (rate != m_rates.begin() && refresh.Hz() - (rate - 1)->Hz() < rate->Hz() - refresh.Hz()) --rate;
+    return {chosen, *rate};
+}
+
+std::shared_ptr<const ModeTable> ModeTableCache::Get(ModeSize native) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_table || m_ratesChanged || !(m_table->Native() == native)) {
+        m_table = std::make_shared<const ModeTable>(native, m_hostRates);
+        m_ratesChanged = false;
+        m_rebuilds++;
+    }
+    return m_table;
+}
+
+void ModeTableCache::SetHostRates(uint64_t source, const std::vector<ModeRate>& rates) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (source == m_hostSource) return;
+    m_hostSource = source;
+    std::vector<ModeRate> normalized = rates;
+    NormalizeRates(normalized);
+    if (normalized.size() != m_hostRates.size() ||
+        !std::equal(normalized.begin(), normalized.end(), m_hostRates.begin(),
+                    [](const ModeRate& a, const ModeRate& b) { return std::fabs(a.Hz() - b.Hz()) < kSameRateHz; })) {
+        m_hostRates = std::move(normalized);
+        m_ratesChanged = true;
+    }
+}
+
+uint64_t ModeTableCache::Rebuilds() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rebuilds;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Display modes reported for the virtual monitor. Kept free of DXGI types so
+// it builds and benchmarks off Windows; dxgi_proxy.cpp converts.
+
+// Refresh rate as DXGI reports it (e.g. 60000/1001, 143856/1000)
+struct ModeRate {
+    uint32_t numerator = 0;
+    uint32_t denominator = 0;
+
+    bool IsSpecified() const { return numerator != 0 && denominator != 0; }
+    double Hz() const { return IsSpecified() ? (double)numerator / denominator : 0.0; }
+};
+
+struct ModeSize {
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    bool operator<(const ModeSize& other) const {
+        return width != other.width ? width < other.width : height < other.height;
+    }
+    bool operator==(const ModeSize& other) const { return width == other.width && height == other.height; }
+};
+
+struct DisplayMode {
+    ModeSize size;
+    ModeRate refresh;
+};
+
+// Every size the virtual monitor offers at every refresh rate of its host output. The
+// native size is the target's; common smaller resolutions that fit inside it
+// are listed too, like a real monitor does. Immutable once built. Modes are
+// ordered like DXGI lists them: by width, height, then refresh rate.
+class ModeTable {
+public:
+    static constexpr size_t kMaxRates = 16;
+
+    // rates need not be sorted or unique; an empty list means 60 Hz
+    ModeTable(ModeSize native, std::vector<ModeRate> rates);
+
+    ModeSize Native() const { return m_native; }
+    size_t ModeCount() const { return m_sizes.size() * m_rates.size(); }
+    DisplayMode ModeAt(size_t index) const;
+
+    // Nearest mode by binary search: the size with the closest pixel count,
+    // then the closest refresh rate. A zero width/height matches the native
+    // size; an unspecified refresh rate matches the highest one.
+    DisplayMode FindClosest(ModeSize size, ModeRate refresh) const;
+
+private:
+    ModeSize m_native;
+    std::vector<ModeSize> m_sizes;  // Ascending, the order modes are listed in
+    std::vector<ModeSize> m_byArea; // Same sizes by pixel count, for matching
+    std::vector<ModeRate> m_rates; // Ascending by Hz, shared by every size
+};
+
+// Hands out the mode table for the current target size, rebuilding it only
+// when the size or the host output changes. Thread-safe.
+class ModeTableCache {
+public:
+    std::shared_ptr<const ModeTable> Get(ModeSize native);
+
+    // Takes the refresh rates of the real output the virtual display is mapped
+    // to. source identifies that output's rate list (0 for none): calls with
+    // the current source return without touching rates.
+    void SetHostRates(uint64_t source, const std::vector<ModeRate>& rates);
+
+    uint64_t Rebuilds() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::shared_ptr<const ModeTable> m_table;
+    uint64_t m_hostSource = 0;
+    std::vector<ModeRate> m_hostRates;
+    bool m_ratesChanged = false;
+    uint64_t m_rebuilds = 0;
+};
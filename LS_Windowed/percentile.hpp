@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Nearest rank on sorted values; T() for an empty sample
+template <class T>
+T Percentile(const std::vector<T>& sorted, double p) {
+    if (sorted.empty()) return T();
+    return sorted[(size_t)(p * (double)(sorted.size() - 1) + 0.5)];
+}
@@ -0,0 +1,70 @@
+#include "present_stats.hpp"
+#include "percentile.hpp"
+#include <algorithm>
+
+void PresentStats::Snapshot(std::vector<PresentRecord>& out) const {
+    out.clear();
+    uint64_t end = m_next.load(std::memory_order_acquire);
+    uint64_t begin = end > kCapacity ? end - kCapacity : 0;
+    for (uint64_t index = begin; index < end; index++) {
+        const Slot& slot = m_slots[index % kCapacity];
+        if (slot.sequence.load(std::memory_order_acquire) != index * 2 + 2) continue;
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; i++) words[i] = slot.words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != index * 2 + 2) continue;
+
+        PresentRecord record;
+        std::memcpy(&record, words, sizeof(record));
+        out.push_back(record);
+    }
+}
+
+PresentSummary PresentStats::Summarize() const {
+    PresentSummary summary;
+    std::vector<PresentRecord> records;
+    Snapshot(records);
+    summary.presents = Count();
+    summary.failed = m_failed.load(std::memory_order_relaxed);
+    if (records.empty()) return summary;
+    summary.last = records.back();
+
+    // Frame times only between shown frames: test presents and failed calls
+    // put nothing on screen. A record skipped because it was being rewritten
+    // merges two intervals into one; rare enough not to matter.
+    std::vector<uint64_t> frames, costs;
+    frames.reserve(records.size());
+    costs.reserve(records.size());
+    const PresentRecord* previous = nullptr;
+    const PresentRecord* first = nullptr;
+    for (const PresentRecord& record : records) {
+        if (record.failed || (record.flags & kPresentTestFlag)) continue;
+        costs.push_back(record.durationNs);
+        if (previous && record.startNs > previous->startNs) frames.push_back(record.startNs - previous->startNs);
+        if (!first) first = &record;
+        previous = &record;
+    }
+    summary.window = costs.size();
+    if (frames.empty()) return summary;
+
+    summary.framesPerSecond = (double)frames.size() * 1e9 / (double)(previous->startNs - first->startNs);
+    std::sort(frames.begin(), frames.end());
+    std::sort(costs.begin(), costs.end());
+    summary.frameP50Ns = Percentile(frames, 0.50);
+    summary.frameP99Ns = Percentile(frames, 0.99);
+    summary.frameMaxNs = (double)frames.back();
+    summary.costP50Ns = Percentile(costs, 0.50);
+    summary.costP99Ns = Percentile(costs, 0.99);
+    summary.costMaxNs = (double)costs.back();
+    return summary;
+}
+
+void PresentRegistry::Add(const PresentStats* stats) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_live.push_back(stats);
+}
+
+void PresentRegistry::Remove(const PresentStats* stats) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_live.erase(std::remove(m_live.begin(), m_live.end(), stats), m_live.end());
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// DXGI_PRESENT_TEST: the call only checks for occlusion and shows no frame
+constexpr uint32_t kPresentTestFlag = 0x00000001;
+
+// One Present or Present1 call on a swap chain
+struct PresentRecord {
+    uint64_t startNs = 0;    // steady_clock time the call was made
+    uint32_t durationNs = 0; // Time spent inside the runtime
+    uint32_t flags = 0;      // DXGI_PRESENT_* flags
+    uint8_t syncInterval = 0;
+    bool present1 = false;
+    bool failed = false;
+};
+
+struct PresentSummary {
+    uint64_t presents = 0; // Since the swap chain was created
+    uint64_t failed = 0;
+    size_t window = 0; // Frames the figures below cover
+    double framesPerSecond = 0;
+    // Time between the starts of consecutive shown frames
+    double frameP50Ns = 0;
+    double frameP99Ns = 0;
+    double frameMaxNs = 0;
+    // Time the presenting thread spent inside Present
+    double costP50Ns = 0;
+    double costP99Ns = 0;
+    double costMaxNs = 0;
+    PresentRecord last; // Latest present, test presents included
+};
+
+// The latest kCapacity presents of one swap chain. Record() is lock-free and
+// safe from several threads; each slot is a small sequence lock, so readers
+// skip slots being rewritten instead of waiting. Summarize() may run on any
+// thread at any time.
+class PresentStats {
+public:
+    static constexpr size_t kCapacity = 512;
+
+    explicit PresentStats(uint64_t window = 0) : m_window(window) {}
+
+    void Record(const PresentRecord& record) {
+        uint64_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (record.failed) m_failed.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = m_slots[index % kCapacity];
+
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &record, sizeof(record));
+        slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; i++) slot.words[i].store(words[i], std::memory_order_relaxed);
+        slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    }
+
+    // Copies the retained records into out, oldest first. Records being
+    // written or already overwritten are left out.
+    void Snapshot(std::vector<PresentRecord>& out) const;
+
+    PresentSummary Summarize() const;
+
+    uint64_t Count() const { return m_next.load(std::memory_order_relaxed); }
+
+    // Whatever identifies the swap chain to a person: its window handle
+    uint64_t Window() const { return m_window; }
+
+private:
+    static constexpr size_t kWords = (sizeof(PresentRecord) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<uint64_t> sequence{0}; // 2n + 2 once record n is complete
+        std::atomic<uint64_t> words[kWords] = {};
+    };
+
+    uint64_t m_window;
+    std::atomic<uint64_t> m_next{0};
+    std::atomic<uint64_t> m_failed{0};
+    Slot m_slots[kCapacity];
+};
+
+// The PresentStats of every live swap chain proxy, for the settings UI.
+// Swap chains come and go rarely, so a mutex is enough.
+class PresentRegistry {
+public:
+    void Add(const PresentStats* stats);
+    void Remove(const PresentStats* stats);
+
+    // Calls fn(const PresentStats&) for each; swap chains cannot be destroyed
+    // while it runs
+    template <class Fn>
+    void ForEach(Fn&& fn) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const PresentStats* stats : m_live) fn(*stats);
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<const PresentStats*> m_live;
+};
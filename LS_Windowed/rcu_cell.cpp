@@ -0,0 +1,62 @@
+#include "rcu_cell.hpp"
+
+thread_local RcuDomain::ReaderSlot* RcuDomain::t_slot = nullptr;
+std::atomic<uint64_t> RcuDomain::s_epoch{1};
+
+namespace {
+
+constexpr size_t kPooledSlots = 64;
+
+std::atomic<RcuDomain::ReaderSlot*> g_Slots{nullptr};
+std::atomic<size_t> g_SlotCount{0};
+RcuDomain::ReaderSlot g_SlotPool[kPooledSlots];
+
+} // namespace
+
+// Hands the thread's slot back when the thread exits
+struct RcuDomain::ThreadExit {
+    ~ThreadExit() {
+        ReaderSlot* slot = std::exchange(t_slot, nullptr);
+        if (!slot) return;
+        slot->depth = 0;
+        slot->epoch.store(0, std::memory_order_release);
+        slot->owned.store(false, std::memory_order_release);
+    }
+};
+
+RcuDomain::ReaderSlot* RcuDomain::RegisterThread() {
+    // A slot freed by an exited thread first, then the pool, then the heap
+    ReaderSlot* slot = nullptr;
+    for (ReaderSlot* free = g_Slots.load(std::memory_order_acquire); free && !slot; free = free->next) {
+        bool owned = false;
+        if (!free->owned.load(std::memory_order_relaxed) &&
+            free->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+            slot = free;
+        }
+    }
+    if (!slot) {
+        size_t index = g_SlotCount.fetch_add(1, std::memory_order_relaxed);
+        slot = index < kPooledSlots ? &g_SlotPool[index] : new ReaderSlot();
+        slot->owned.store(true, std::memory_order_relaxed);
+        ReaderSlot* head = g_Slots.load(std::memory_order_relaxed);
+        do {
+            slot->next = head;
+        } while (!g_Slots.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+    }
+    static thread_local ThreadExit t_exit;
+    t_slot = slot;
+    return slot;
+}
+
+size_t RcuDomain::SlotCount() {
+    return g_SlotCount.load(std::memory_order_relaxed);
+}
+
+uint64_t RcuDomain::OldestReader() {
+    uint64_t oldest = UINT64_MAX;
+    for (ReaderSlot* slot = g_Slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+        uint64_t epoch = slot->epoch.load(std::memory_order_seq_cst);
+        if (epoch && epoch < oldest) oldest = epoch;
+    }
+    return oldest;
+}
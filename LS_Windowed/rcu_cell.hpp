@@ -0,0 +1,161 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Epoch-based read-side critical sections for RcuCell. Each reading thread owns
+// a slot, claimed on its first read and handed back when the thread exits,
+// holding the epoch its outermost read began in, or 0 while idle. Slots stay
+// linked for good and are reused, so their number is bounded by the most
+// threads reading at once; the first ones come from a static pool, so a
+// thread's first read normally allocates nothing.
+// A value unpublished before Advance() returned epoch E can be freed once
+// OldestReader() >= E: every reader still inside started after it was gone.
+class RcuDomain {
+public:
+    struct ReaderSlot {
+        std::atomic<uint64_t> epoch{0};
+        uint32_t depth = 0; // Nested reads on the owning thread
+        std::atomic<bool> owned{false};
+        ReaderSlot* next = nullptr;
+    };
+
+    static void Enter() {
+        ReaderSlot* slot = t_slot ? t_slot : RegisterThread();
+        if (slot->depth++ == 0) slot->epoch.store(s_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+
+    static void Leave() {
+        ReaderSlot* slot = t_slot;
+        if (--slot->depth == 0) slot->epoch.store(0, std::memory_order_release);
+    }
+
+    // Starts a new epoch and returns it
+    static uint64_t Advance() { return s_epoch.fetch_add(1, std::memory_order_seq_cst) + 1; }
+
+    // Epoch of the oldest read in progress, or UINT64_MAX if there is none
+    static uint64_t OldestReader();
+
+    // Slots created so far, owned or free
+    static size_t SlotCount();
+
+private:
+    struct ThreadExit;
+
+    static ReaderSlot* RegisterThread();
+
+    static thread_local ReaderSlot* t_slot;
+    static std::atomic<uint64_t> s_epoch;
+};
+
+// Holds an immutable value that many threads read while one at a time replaces
+// it. Read() costs one atomic load plus two stores to a thread-local slot and
+// never blocks; every reader sees one whole published value. Publish() swaps in
+// a new copy and frees the copies no reader can still hold. Each publish bumps
+// the generation, so a reader that cached something derived from the value can
+// tell it is stale with a single load.
+template <class T>
+class RcuCell {
+    struct Node {
+        T value;
+        uint64_t generation;
+    };
+
+public:
+    // Keeps the value it points to alive for its own lifetime
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept : m_node(std::exchange(other.m_node, nullptr)) {}
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+        ~Snapshot() {
+            if (m_node) RcuDomain::Leave();
+        }
+
+        const T& operator*() const { return m_node->value; }
+        const T* operator->() const { return &m_node->value; }
+        uint64_t Generation() const { return m_node->generation; }
+
+    private:
+        friend class RcuCell;
+        explicit Snapshot(const Node* node) : m_node(node) {}
+        const Node* m_node;
+    };
+
+    explicit RcuCell(const T& initial = T()) : m_current(new Node{initial, 1}) {}
+
+    // No reader may still be running
+    ~RcuCell() {
+        delete m_current.load(std::memory_order_relaxed);
+        for (const Retired& retired : m_retired) delete retired.node;
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    Snapshot Read() const {
+        RcuDomain::Enter();
+        return Snapshot(m_current.load(std::memory_order_seq_cst));
+    }
+
+    // Generation of the latest value; starts at 1
+    uint64_t Generation() const { return m_generation.load(std::memory_order_acquire); }
+
+    // Thread-safe; returns the new generation
+    uint64_t Publish(const T& value) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        return PublishLocked(value);
+    }
+
+    // Publishes a copy of the latest value changed by mutate(T&), atomically
+    // with respect to other writers
+    template <class Fn>
+    uint64_t Update(Fn&& mutate) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        T value = m_current.load(std::memory_order_relaxed)->value;
+        mutate(value);
+        return PublishLocked(value);
+    }
+
+    // Old values still waiting for their readers to finish
+    size_t PendingReclaim() const {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        return m_retired.size();
+    }
+
+private:
+    struct Retired {
+        const Node* node;
+        uint64_t epoch;
+    };
+
+    uint64_t PublishLocked(const T& value) {
+        uint64_t generation = m_generation.load(std::memory_order_relaxed) + 1;
+        const Node* old = m_current.exchange(new Node{value, generation}, std::memory_order_seq_cst);
+        m_generation.store(generation, std::memory_order_release);
+        m_retired.push_back({old, RcuDomain::Advance()});
+        Reclaim();
+        return generation;
+    }
+
+    void Reclaim() {
+        uint64_t oldest = RcuDomain::OldestReader();
+        size_t kept = 0;
+        for (const Retired& retired : m_retired) {
+            if (retired.epoch <= oldest) {
+                delete retired.node;
+            } else {
+                m_retired[kept++] = retired;
+            }
+        }
+        m_retired.resize(kept);
+    }
+
+    std::atomic<const Node*> m_current;
+    std::atomic<uint64_t> m_generation{1};
+    mutable std::mutex m_writeMutex;
+    std::vector<Retired> m_retired;
+};
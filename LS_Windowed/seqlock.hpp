@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// Single-writer sequence lock for small trivially copyable values. Readers never
+// block the writer and take no locks; they retry if they raced with a Store().
+// The payload is kept in relaxed atomic words so concurrent access is well
+// defined.
+template <class T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload must be trivially copyable");
+
+public:
+    explicit SeqLock(const T& initial = T()) {
+        Store(initial);
+        m_sequence.store(0, std::memory_order_relaxed);
+    }
+
+    // Must only be called from one thread at a time.
+    void Store(const T& value) {
+        uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; i++) {
+            m_words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Returns a consistent copy. version (optional) receives the number of
+    // Store() calls that produced it, 0 meaning the initial value.
+    T Load(uint32_t* version = nullptr) const {
+        uint64_t buffer[kWords];
+        uint32_t sequence;
+        for (;;) {
+            sequence = m_sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < kWords; i++) {
+                buffer[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == sequence) break;
+        }
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        if (version) *version = sequence / 2;
+        return value;
+    }
+
+    uint32_t Version() const { return m_sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> m_sequence{0};
+    std::atomic<uint64_t> m_words[kWords];
+};
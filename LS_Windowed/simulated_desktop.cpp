@@ -0,0 +1,138 @@
+#include "simulated_desktop.hpp"
+#include <algorithm>
+
+int SimulatedDesktop::AddMonitor(const LayoutRect& rect) {
+    m_monitors.push_back(rect);
+    return (int)m_monitors.size() - 1;
+}
+
+WindowHandle SimulatedDesktop::AddWindow(const LayoutRect& rect, bool ownProcess, LayoutRect frame) {
+    WindowHandle handle = kFirstHandle + m_windows.size() * kHandleStride;
+    Window window;
+    window.rect = rect;
+    window.frame = frame;
+    window.ownProcess = ownProcess;
+    m_windows.push_back(window);
+    m_zOrder.insert(m_zOrder.begin(), handle);
+    Emit(WindowEventType::Show, handle);
+    return handle;
+}
+
+void SimulatedDesktop::DestroyWindow(WindowHandle window) {
+    Window* target = FindMutable(window);
+    if (!target) return;
+    target->alive = false;
+    m_zOrder.erase(std::find(m_zOrder.begin(), m_zOrder.end(), window));
+    if (m_foreground == window) m_foreground = 0;
+    Emit(WindowEventType::Destroy, window);
+}
+
+void SimulatedDesktop::ShowWindow(WindowHandle window, bool visible) {
+    Window* target = FindMutable(window);
+    if (!target || target->visible == visible) return;
+    target->visible = visible;
+    if (visible) Emit(WindowEventType::Show, window);
+}
+
+void SimulatedDesktop::SetForeground(WindowHandle window) {
+    if (!Find(window) || m_foreground == window) return;
+    m_foreground = window;
+    Raise(window);
+    Emit(WindowEventType::Foreground, window);
+}
+
+void SimulatedDesktop::PlaceWindow(WindowHandle window, const LayoutRect& rect) {
+    Window* target = FindMutable(window);
+    if (!target) return;
+    target->rect = rect;
+    Emit(WindowEventType::MoveSize, window);
+}
+
+void SimulatedDesktop::OffsetWindow(WindowHandle window, int32_t dx, int32_t dy) {
+    const Window* target = Find(window);
+    if (!target) return;
+    LayoutRect rect = target->rect;
+    PlaceWindow(window, {rect.left + dx, rect.top + dy, rect.right + dx, rect.bottom + dy});
+}
+
+void SimulatedDesktop::MaximizeWindow(WindowHandle window, int monitor) {
+    const Window* target = Find(window);
+    if (!target || monitor < 0 || monitor >= (int)m_monitors.size()) return;
+    const LayoutRect& area = m_monitors[monitor];
+    const LayoutRect& frame = target->frame;
+    PlaceWindow(window, {area.left - frame.left, area.top - frame.top, area.right + frame.right,
+                         area.bottom + frame.bottom});
+}
+
+const SimulatedDesktop::Window* SimulatedDesktop::Find(WindowHandle window) const {
+    if (window < kFirstHandle || (window - kFirstHandle) % kHandleStride) return nullptr;
+    size_t index = (window - kFirstHandle) / kHandleStride;
+    if (index >= m_windows.size() || !m_windows[index].alive) return nullptr;
+    return &m_windows[index];
+}
+
+SimulatedDesktop::Window* SimulatedDesktop::FindMutable(WindowHandle window) {
+    return const_cast<Window*>(Find(window));
+}
+
+void SimulatedDesktop::Raise(WindowHandle window) {
+    auto it = std::find(m_zOrder.begin(), m_zOrder.end(), window);
+    if (it != m_zOrder.end()) std::rotate(m_zOrder.begin(), it, it + 1);
+}
+
+void SimulatedDesktop::Emit(WindowEventType type, WindowHandle window) {
+    if (m_sink) m_sink({type, window, m_now});
+}
+
+bool SimulatedDesktop::IsVisible(WindowHandle window) {
+    const Window* target = Find(window);
+    return target && target->visible;
+}
+
+bool SimulatedDesktop::IsOwnedByProcess(WindowHandle window) {
+    const Window* target = Find(window);
+    return target && target->ownProcess;
+}
+
+bool SimulatedDesktop::WindowRect(WindowHandle window, LayoutRect* rect) {
+    const Window* target = Find(window);
+    if (!target) return false;
+    *rect = target->rect;
+    return true;
+}
+
+bool SimulatedDesktop::ClientRect(WindowHandle window, LayoutRect* rect) {
+    const Window* target = Find(window);
+    if (!target) return false;
+    const LayoutRect& frame = target->frame;
+    *rect = {target->rect.left + frame.left, target->rect.top + frame.top, target->rect.right - frame.right,
+             target->rect.bottom - frame.bottom};
+    // Like GetClientRect, a window smaller than its frame has an empty client area
+    if (rect->right < rect->left) rect->right = rect->left;
+    if (rect->bottom < rect->top) rect->bottom = rect->top;
+    return true;
+}
+
+void SimulatedDesktop::ForEachWindow(EnumProc proc, void* context) {
+    for (WindowHandle window : m_zOrder) {
+        if (!proc(window, context)) return;
+    }
+}
+
+bool SimulatedDesktop::SetRegion(WindowHandle window, const LayoutRect* region) {
+    Window* target = FindMutable(window);
+    if (!target) return false;
+    target->hasRegion = region != nullptr;
+    target->region = region ? *region : LayoutRect{};
+    target->regionChanges++;
+    return true;
+}
+
+bool SimulatedDesktop::Move(WindowHandle window, const LayoutRect& rect) {
+    Window* target = FindMutable(window);
+    if (!target) return false;
+    target->rect = rect;
+    target->moves++;
+    Emit(WindowEventType::MoveSize, window); // SetWindowPos raises a location change too
+    return true;
+}
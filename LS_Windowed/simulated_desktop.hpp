@@ -0,0 +1,80 @@
+#pragma once
+#include "window_events.hpp"
+#include "window_system.hpp"
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// In-memory desktop for driving the layout engine off Windows: top-level
+// windows with a z-order, monitors, a foreground window and a virtual clock
+// that only moves when Advance() is called, so scripted runs are reproducible.
+// Not thread-safe; the script and the engine must run on the same thread.
+class SimulatedDesktop : public IWindowSystem {
+public:
+    using Clock = std::chrono::steady_clock;
+    using EventFn = std::function<void(const WindowEvent&)>;
+
+    struct Window {
+        LayoutRect rect;           // Window rect including the frame
+        LayoutRect frame;          // Non-client insets: left, top (title bar), right, bottom
+        bool alive = true;
+        bool visible = true;
+        bool ownProcess = false;   // Reported by IsOwnedByProcess (the LS overlay)
+        bool hasRegion = false;
+        LayoutRect region;
+        uint64_t regionChanges = 0; // SetRegion calls that succeeded
+        uint64_t moves = 0;         // Move calls that succeeded
+    };
+
+    static constexpr LayoutRect kDefaultFrame{8, 31, 8, 8};
+
+    // Receives the events the real desktop would raise through WinEvent
+    // hooks, stamped with the virtual clock
+    void SetEventSink(EventFn sink) { m_sink = std::move(sink); }
+
+    int AddMonitor(const LayoutRect& rect);
+    const std::vector<LayoutRect>& Monitors() const { return m_monitors; }
+
+    // New windows are shown on top of the z-order but not activated
+    WindowHandle AddWindow(const LayoutRect& rect, bool ownProcess = false, LayoutRect frame = kDefaultFrame);
+    void DestroyWindow(WindowHandle window);
+    void ShowWindow(WindowHandle window, bool visible);
+    void SetForeground(WindowHandle window); // Also raises it to the top
+    // A move made by the user or another app (the engine's own moves go through Move)
+    void PlaceWindow(WindowHandle window, const LayoutRect& rect);
+    void OffsetWindow(WindowHandle window, int32_t dx, int32_t dy);
+    // Fills the monitor's area with the window's client area, frame pushed offscreen
+    void MaximizeWindow(WindowHandle window, int monitor);
+
+    void Advance(Clock::duration elapsed) { m_now += elapsed; }
+
+    const Window* Find(WindowHandle window) const;
+
+    // IWindowSystem
+    WindowHandle Foreground() override { return m_foreground; }
+    bool Exists(WindowHandle window) override { return Find(window) != nullptr; }
+    bool IsVisible(WindowHandle window) override;
+    bool IsOwnedByProcess(WindowHandle window) override;
+    bool WindowRect(WindowHandle window, LayoutRect* rect) override;
+    bool ClientRect(WindowHandle window, LayoutRect* rect) override;
+    void ForEachWindow(EnumProc proc, void* context) override;
+    bool SetRegion(WindowHandle window, const LayoutRect* region) override;
+    bool Move(WindowHandle window, const LayoutRect& rect) override;
+    Clock::time_point Now() override { return m_now; }
+
+private:
+    // Handles are spaced like real HWNDs and never reused
+    static constexpr WindowHandle kFirstHandle = 0x10010;
+    static constexpr WindowHandle kHandleStride = 4;
+
+    Window* FindMutable(WindowHandle window);
+    void Raise(WindowHandle window);
+    void Emit(WindowEventType type, WindowHandle window);
+
+    std::vector<Window> m_windows; // Indexed by (handle - kFirstHandle) / kHandleStride
+    std::vector<WindowHandle> m_zOrder; // Topmost first
+    std::vector<LayoutRect> m_monitors;
+    WindowHandle m_foreground = 0;
+    Clock::time_point m_now;
+    EventFn m_sink;
+};
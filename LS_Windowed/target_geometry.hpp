@@ -0,0 +1,18 @@
+#pragma once
+#include "layout.hpp"
+#include "seqlock.hpp"
+#include <windows.h>
+
+// Geometry of the tracked game window as last observed by the watcher thread.
+// The watcher is the only producer; hooks read it without locks or user32 calls.
+struct TargetGeometry {
+    RECT targetRect;   // Client area of the target window in screen coordinates
+    RECT lsRect;       // Where the LS window is placed (differs in Position mode)
+    HWND targetWindow;
+    HWND lsWindow;     // The LS window at lsRect, once found; kept after it is lost
+};
+
+inline LayoutRect ToLayoutRect(const RECT& rc) {
+    return {(int32_t)rc.left, (int32_t)rc.top, (int32_t)rc.right, (int32_t)rc.bottom};
+}
+inline RECT ToRECT(const LayoutRect& rc) { return {rc.left, rc.top, rc.right, rc.bottom}; }
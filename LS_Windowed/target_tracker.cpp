@@ -0,0 +1,96 @@
+#include "target_tracker.hpp"
+#include <algorithm>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+double TrackerStats::WakeupsPerMinute(Clock::time_point now) const {
+    double minutes = std::chrono::duration<double>(now - startTime).count() / 60.0;
+    return minutes > 0.0 ? wakeups / minutes : 0.0;
+}
+
+double TrackerStats::ApplyingWakeupsPerMinute(Clock::time_point now) const {
+    double minutes = std::chrono::duration<double>(now - startTime).count() / 60.0;
+    return minutes > 0.0 ? applyingWakeups / minutes : 0.0;
+}
+
+double TrackerStats::AverageLatencyUs() const {
+    return latencySamples ? latencyTotalUs / latencySamples : 0.0;
+}
+
+TargetTracker::TargetTracker(IWindowEventSource& source, ApplyFn apply, FilterFn isRelevant,
+                             TrackerOptions options)
+    : m_source(source), m_apply(std::move(apply)), m_isRelevant(std::move(isRelevant)), m_options(options) {}
+
+void TargetTracker::Run() {
+    bool eventDriven = m_source.Start();
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats = TrackerStats();
+        m_stats.eventDriven = eventDriven;
+        m_stats.startTime = Clock::now();
+    }
+
+    // Bring the layout up to date once before waiting for the first event
+    m_apply();
+    RecordApply(nullptr);
+
+    std::vector<WindowEvent> batch;
+    while (m_running) {
+        batch.clear();
+        bool gotEvents = m_source.WaitEvents(eventDriven ? kWaitForever : m_options.pollInterval, batch);
+        if (!m_running) break;
+
+        const WindowEvent* oldest = nullptr;
+        uint64_t ignored = 0;
+        for (const WindowEvent& event : batch) {
+            if (event.type != WindowEventType::Wake && m_isRelevant && !m_isRelevant(event)) {
+                ignored++;
+                continue;
+            }
+            if (!oldest || event.time < oldest->time) oldest = &event;
+        }
+
+        // Poll ticks always apply; event wake-ups only if something relevant arrived
+        bool applies = !gotEvents || oldest;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_stats.wakeups++;
+            m_stats.events += batch.size();
+            m_stats.ignoredEvents += ignored;
+            if (!gotEvents) m_stats.polls++;
+            if (applies) m_stats.applyingWakeups++;
+        }
+        if (!applies) continue;
+
+        m_apply();
+        RecordApply(oldest);
+    }
+
+    m_source.Stop();
+}
+
+void TargetTracker::RecordApply(const WindowEvent* oldest) {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.applies++;
+    if (oldest && oldest->type != WindowEventType::Wake) {
+        double latencyUs = std::chrono::duration<double, std::micro>(Clock::now() - oldest->time).count();
+        m_stats.latencySamples++;
+        m_stats.latencyTotalUs += latencyUs;
+        m_stats.latencyMaxUs = std::max(m_stats.latencyMaxUs, latencyUs);
+    }
+}
+
+void TargetTracker::Stop() {
+    m_running = false;
+    RequestUpdate();
+}
+
+void TargetTracker::RequestUpdate() {
+    m_source.Post({WindowEventType::Wake, 0, Clock::now()});
+}
+
+TrackerStats TargetTracker::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_stats;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "window_events.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+struct TrackerOptions {
+    // Tick interval used when the event source is unavailable.
+    std::chrono::milliseconds pollInterval{200};
+};
+
+struct TrackerStats {
+    bool eventDriven = false;
+    uint64_t wakeups = 0;        // Times the tracker thread woke up
+    uint64_t applyingWakeups = 0; // Wake-ups that led to an apply; the rest only saw filtered events
+    uint64_t polls = 0;          // Wake-ups caused by the poll timeout
+    uint64_t events = 0;         // Events received
+    uint64_t ignoredEvents = 0;  // Events rejected by the relevance filter
+    uint64_t applies = 0;        // Times the apply callback ran
+    uint64_t latencySamples = 0; // Event-driven applies with a measured latency
+    double latencyTotalUs = 0.0; // Sum of event-to-apply latencies
+    double latencyMaxUs = 0.0;
+    std::chrono::steady_clock::time_point startTime;
+
+    double WakeupsPerMinute(std::chrono::steady_clock::time_point now) const;
+    double ApplyingWakeupsPerMinute(std::chrono::steady_clock::time_point now) const;
+    double AverageLatencyUs() const;
+};
+
+// Runs the apply callback whenever a relevant window event arrives. Events that
+// queue up while the callback runs are coalesced into a single apply. If the
+// event source cannot start, the tracker degrades to a fixed-interval poll.
+class TargetTracker {
+public:
+    using ApplyFn = std::function<void()>;
+    using FilterFn = std::function<bool(const WindowEvent&)>;
+
+    TargetTracker(IWindowEventSource& source, ApplyFn apply, FilterFn isRelevant = nullptr,
+                  TrackerOptions options = {});
+
+    // Blocks on the calling thread until Stop() is called.
+    void Run();
+
+    // Thread-safe.
+    void Stop();
+    void RequestUpdate();
+    TrackerStats GetStats() const;
+
+private:
+    void RecordApply(const WindowEvent* oldest);
+
+    IWindowEventSource& m_source;
+    ApplyFn m_apply;
+    FilterFn m_isRelevant;
+    TrackerOptions m_options;
+    std::atomic<bool> m_running{true};
+
+    mutable std::mutex m_statsMutex;
+    TrackerStats m_stats;
+};
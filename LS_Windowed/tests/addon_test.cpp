@@ -0,0 +1,377 @@
+// Correctness checks for the addon's DXGI proxies and layout helpers, run by
+// ctest. Like ls_addon_bench, dxgi_proxy.cpp is compiled unchanged against the
+// Win32/DXGI stand-ins in bench/winapi and driven through the mocks in
+// bench/mock_dxgi.hpp. Every check is reported; any failure fails the run.
+//
+//   ls_addon_test [--framecap path/to/ls_framecap]
+//
+// With --framecap, a frame capture written here is decoded with ls_framecap
+// and compared with what was presented.
+#include "alloc_counter.hpp"
+#include "dxgi_proxy.hpp"
+#include "grid_layout.hpp"
+#include "mock_dxgi.hpp"
+#include "rcu_cell.hpp"
+#include "virtual_displays.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+// Defined by main.cpp in the DLL
+VirtualDisplays g_VirtualDisplays({{0, 0, 1920, 1080}, {0, 0, 1920, 1080}, nullptr, nullptr});
+
+namespace {
+
+int g_Failures = 0;
+
+void Check(bool ok, const char* what) {
+    fprintf(stderr, "%s %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok) g_Failures++;
+}
+
+// Two adapters: a 2560x1440 panel with five rates up to 240 Hz on the first,
+// a 60 Hz panel right of it on the second. Swap chains created through the
+// factory all wrap the same mock.
+struct MockSystem {
+    MockDXGIOutput6 output{RECT{0, 0, 2560, 1440}};
+    MockDXGIOutput6 secondaryOutput{RECT{2560, 0, 4480, 1080}, 2};
+    MockDXGIAdapter4 adapter0{LUID{0x1000, 0}, &output};
+    MockDXGIAdapter4 adapter1{LUID{0x2000, 0}, &secondaryOutput};
+    IDXGIAdapter4* adapters[2] = {&adapter0, &adapter1};
+    MockDXGISwapChain4 swapChain;
+    MockDXGIFactory6 factory{adapters, 2, &swapChain};
+};
+
+IDXGIOutput* EnumOutput(ProxyDXGIFactory* factory, UINT adapterIndex, UINT outputIndex) {
+    IDXGIAdapter* adapter = nullptr;
+    IDXGIOutput* output = nullptr;
+    if (FAILED(factory->EnumAdapters(adapterIndex, &adapter))) return nullptr;
+    if (FAILED(adapter->EnumOutputs(outputIndex, &output))) output = nullptr;
+    adapter->Release();
+    return output;
+}
+
+// Cells of every uniform grid tile the overlay exactly, even for sizes that
+// do not divide evenly; custom layouts survive a text round trip
+void TestGridLayout() {
+    bool tiles = true;
+    for (int columns = 1; columns <= kMaxGridDimension; columns++) {
+        for (int rows = 1; rows <= kMaxGridDimension; rows++) {
+            GridLayout uniform = GridLayout::Uniform(columns, rows);
+            int64_t area = 0;
+            for (int i = 0; i < uniform.cellCount; i++) {
+                LayoutRect rect;
+                GridCellRect(uniform, i, 1921, 1079, &rect);
+                area += (int64_t)rect.Width() * rect.Height();
+            }
+            tiles &= area == 1921 * 1079;
+        }
+    }
+    Check(tiles, "grid: uniform cells tile the overlay");
+
+    GridLayout grid, roundTrip;
+    ParseGridLayout("3x2:0,0,2,2;2,0,1,1;2,1,1,1", &grid);
+    Check(ParseGridLayout(FormatGridLayout(grid).c_str(), &roundTrip) && roundTrip == grid,
+          "grid: custom layout round-trips through text");
+    Check(!ParseGridLayout("2x2:0,0,2,1;1,0,1,1", &roundTrip), "grid: overlapping cells are rejected");
+}
+
+void TestEnumOutputs(ProxyDXGIFactory* factory) {
+    // Adapter 0 has one real output; the fake one is injected at index 1
+    IDXGIAdapter* adapter = nullptr;
+    factory->EnumAdapters(0, &adapter);
+    IDXGIOutput* enumerated = nullptr;
+    Check(SUCCEEDED(adapter->EnumOutputs(0, &enumerated)) && dynamic_cast<ProxyDXGIOutput*>(enumerated),
+          "enum_outputs: the real output comes first, wrapped");
+    if (enumerated) enumerated->Release();
+    Check(SUCCEEDED(adapter->EnumOutputs(1, &enumerated)) && dynamic_cast<FakeDXGIOutput*>(enumerated),
+          "enum_outputs: the fake output follows it");
+    if (enumerated) enumerated->Release();
+    Check(adapter->EnumOutputs(2, &enumerated) == DXGI_ERROR_NOT_FOUND, "enum_outputs: nothing after the fake output");
+
+    // The output list is built once; after that enumeration must not allocate
+    uint64_t allocationsBefore = AllocationCount();
+    for (UINT i = 0; i < 30000; i++) {
+        if (SUCCEEDED(adapter->EnumOutputs(i % 3, &enumerated))) enumerated->Release();
+    }
+    Check(AllocationCount() == allocationsBefore, "enum_outputs: no heap allocation once the list is built");
+
+    // Every virtual display gets its own fake output after the real one, and
+    // its own monitor handle
+    g_VirtualDisplays.SetCount(kMaxVirtualDisplays);
+    InvalidateOutputTopology();
+    UINT outputCount = 0;
+    bool handlesMatch = true;
+    for (; SUCCEEDED(adapter->EnumOutputs(outputCount, &enumerated)); outputCount++) {
+        DXGI_OUTPUT_DESC desc;
+        enumerated->GetDesc(&desc);
+        if (outputCount > 0) handlesMatch &= g_VirtualDisplays.IndexOf(desc.Monitor) == (int)outputCount - 1;
+        enumerated->Release();
+    }
+    Check(outputCount == 1 + kMaxVirtualDisplays, "enum_outputs: one fake output per virtual display");
+    Check(handlesMatch, "enum_outputs: each fake output reports its display's monitor handle");
+    g_VirtualDisplays.SetCount(1);
+    InvalidateOutputTopology();
+    adapter->Release();
+}
+
+// Threads that read once and exit hand their slot back to the next one, and
+// claiming it allocates nothing
+void TestRcuSlots() {
+    size_t slotsBefore = RcuDomain::SlotCount();
+    bool allocationFree = true;
+    for (int i = 0; i < 200; i++) {
+        std::thread([&] {
+            uint64_t allocationsBefore = AllocationCount();
+            RcuDomain::Enter();
+            RcuDomain::Leave();
+            allocationFree &= AllocationCount() == allocationsBefore;
+        }).join();
+    }
+    Check(RcuDomain::SlotCount() <= slotsBefore + 1, "rcu: exited threads' slots are reused");
+    Check(allocationFree, "rcu: a thread's first read does not allocate");
+}
+
+// Each invalidation replaces the output list (and, through EnumAdapters, the
+// wrapped adapter); the replaced ones are released once no call is inside
+void TestRetiredReclaim(ProxyDXGIFactory* factory, MockSystem& mocks) {
+    ULONG outputRefs = mocks.output.RefCount();
+    ULONG adapterRefs = mocks.adapter0.RefCount();
+    for (int i = 0; i < 100; i++) {
+        InvalidateOutputTopology();
+        if (IDXGIOutput* output = EnumOutput(factory, 0, 0)) output->Release();
+    }
+    Check(mocks.output.RefCount() <= outputRefs + 1, "retired: replaced output lists are released");
+    Check(mocks.adapter0.RefCount() <= adapterRefs + 1, "retired: replaced adapters are released");
+}
+
+void TestFakeModes(ProxyDXGIFactory* factory) {
+    IDXGIOutput* fake = EnumOutput(factory, 0, 1);
+    DXGI_MODE_DESC1 modes[256];
+    UINT modeCount = 256;
+    IDXGIOutput1* fake1 = nullptr;
+    fake->QueryInterface(__uuidof(IDXGIOutput1), (void**)&fake1);
+    fake->Release();
+    fake1->GetDisplayModeList1(DXGI_FORMAT_R8G8B8A8_UNORM, 0, &modeCount, modes);
+    const DXGI_RATIONAL& top = modes[modeCount - 1].RefreshRate;
+    Check(modeCount > 0 && top.Numerator == 240 * top.Denominator, "modes: the primary panel's rates, up to 240 Hz");
+
+    // Scaling variants triple the list
+    UINT scaledCount = 0;
+    fake1->GetDisplayModeList1(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_ENUM_MODES_SCALING, &scaledCount, nullptr);
+    Check(scaledCount == 3 * modeCount, "modes: DXGI_ENUM_MODES_SCALING adds centered and stretched variants");
+    fake1->Release();
+
+    // A virtual display whose target sits on the 60 Hz panel only offers that
+    // panel's rates
+    if (IDXGIOutput* secondary = EnumOutput(factory, 1, 0)) secondary->Release(); // Registers the panel's rates
+    g_VirtualDisplays.SetCount(2);
+    g_VirtualDisplays.Publish(1, {{2600, 40, 3880, 760}, {2600, 40, 3880, 760}, nullptr, nullptr});
+    InvalidateOutputTopology();
+    IDXGIOutput* secondaryFake = EnumOutput(factory, 0, 2);
+    DXGI_MODE_DESC secondaryModes[64];
+    UINT secondaryCount = 64;
+    secondaryFake->GetDisplayModeList(DXGI_FORMAT_R8G8B8A8_UNORM, 0, &secondaryCount, secondaryModes);
+    secondaryFake->Release();
+    g_VirtualDisplays.SetCount(1);
+    InvalidateOutputTopology();
+    const DXGI_RATIONAL& secondaryTop = secondaryModes[secondaryCount - 1].RefreshRate;
+    Check(secondaryCount > 0 && secondaryTop.Numerator == 60 * secondaryTop.Denominator,
+          "modes: a display on the 60 Hz panel tops out at 60 Hz");
+}
+
+// Every virtual display keeps its own clock and resyncs it with its own host,
+// however recently another display's clock was synced
+void TestVBlankPerDisplay(ProxyDXGIFactory* factory) {
+    g_VirtualDisplays.SetCount(2);
+    g_VirtualDisplays.Publish(1, {{2600, 40, 3880, 760}, {2600, 40, 3880, 760}, nullptr, nullptr});
+    InvalidateOutputTopology();
+    IDXGIOutput* primaryFake = EnumOutput(factory, 0, 1);
+    IDXGIOutput* secondaryFake = EnumOutput(factory, 0, 2);
+    DXGI_FRAME_STATISTICS stats;
+    primaryFake->GetFrameStatistics(&stats);
+    VBlankReference before = g_VirtualVBlank[1].Reference();
+    secondaryFake->GetFrameStatistics(&stats);
+    VBlankReference after = g_VirtualVBlank[1].Reference();
+    Check(after.vblankNs != before.vblankNs, "vblank: the second display syncs its own clock");
+    primaryFake->Release();
+    secondaryFake->Release();
+    g_VirtualDisplays.SetCount(1);
+    InvalidateOutputTopology();
+}
+
+// Runs before anything is presented in this process
+void TestFrameStatistics(ProxyDXGIFactory* factory) {
+    IDXGIOutput* fake = EnumOutput(factory, 0, 1);
+
+    // Across WaitForVBlank the statistics advance by whole refreshes, one
+    // period apart on the QPC clock (the DWM stand-in runs at 60 Hz)
+    DXGI_FRAME_STATISTICS before, after;
+    fake->GetFrameStatistics(&before);
+    fake->WaitForVBlank();
+    fake->WaitForVBlank();
+    fake->GetFrameStatistics(&after);
+    UINT refreshes = after.SyncRefreshCount - before.SyncRefreshCount;
+    double msPerRefresh =
+        refreshes ? (double)(after.SyncQPCTime.QuadPart - before.SyncQPCTime.QuadPart) / refreshes / 1e6 : 0;
+    Check(refreshes >= 1 && msPerRefresh > 16.0 && msPerRefresh < 17.4,
+          "frame_statistics: refreshes advance one 60 Hz period apart");
+    Check(after.PresentCount == 0 && after.PresentRefreshCount == 0, "frame_statistics: no presents before any present");
+
+    // Presents that reached the runtime are counted; test presents are not
+    IDXGISwapChain1* swapChain = nullptr;
+    factory->CreateSwapChainForHwnd(nullptr, (HWND)0x1234, nullptr, nullptr, nullptr, &swapChain);
+    for (int i = 0; i < 5; i++) swapChain->Present(0, 0);
+    swapChain->Present(0, DXGI_PRESENT_TEST);
+    DXGI_FRAME_STATISTICS presented;
+    fake->GetFrameStatistics(&presented);
+    Check(presented.PresentCount == 5, "frame_statistics: counts real presents only");
+    Check(presented.PresentRefreshCount <= presented.SyncRefreshCount,
+          "frame_statistics: no present is shown on a refresh still to come");
+    swapChain->Release();
+    fake->Release();
+}
+
+void TestSwapChains(ProxyDXGIFactory* factory, MockSystem& mocks) {
+    size_t listedBefore = 0;
+    g_SwapChainPresents.ForEach([&](const PresentStats&) { listedBefore++; });
+
+    // Window swap chains come back wrapped, their presents timed
+    IDXGISwapChain1* swapChain = nullptr;
+    factory->CreateSwapChainForHwnd(nullptr, (HWND)0x1234, nullptr, nullptr, nullptr, &swapChain);
+    Check(dynamic_cast<ProxyDXGISwapChain*>(swapChain) != nullptr, "swap_chain: window swap chains are wrapped");
+    for (int i = 0; i < 3; i++) swapChain->Present(1, 0);
+    uint64_t presents = 0;
+    size_t listed = 0;
+    g_SwapChainPresents.ForEach([&](const PresentStats& stats) {
+        if (stats.Window() == 0x1234) presents = stats.Summarize().presents;
+        listed++;
+    });
+    Check(listed == listedBefore + 1 && presents == 3, "swap_chain: presents are recorded while it lives");
+    swapChain->Release();
+    listed = 0;
+    g_SwapChainPresents.ForEach([&](const PresentStats&) { listed++; });
+    Check(listed == listedBefore, "swap_chain: unlisted once released");
+
+    // Composition swap chains are the runtime's own objects
+    IDXGISwapChain1* composition = nullptr;
+    factory->CreateSwapChainForComposition(nullptr, nullptr, nullptr, &composition);
+    Check(composition == static_cast<IDXGISwapChain1*>(&mocks.swapChain), "swap_chain: composition swap chains are not wrapped");
+    if (composition) composition->Release();
+}
+
+// Decodes the capture with ls_framecap --dump: every record a present of one
+// swap chain at sync interval 1 with no flags, vblanks never going back
+bool CaptureDecodes(const char* tool, const std::filesystem::path& path, uint64_t records) {
+    std::string command = std::string("\"") + tool + "\" --dump \"" + path.string() + "\"";
+    FILE* dump = popen(command.c_str(), "r");
+    if (!dump) return false;
+    char line[256];
+    uint64_t presents = 0, lastVBlank = 0;
+    unsigned firstChain = 0;
+    bool consistent = true;
+    while (fgets(line, sizeof(line), dump)) {
+        double ms;
+        unsigned chain, interval, flags;
+        unsigned long long vblank;
+        if (sscanf(line, "%lf ms present chain %u vblank %llu interval %u flags %x", &ms, &chain, &vblank, &interval,
+                   &flags) != 5) {
+            continue;
+        }
+        if (!presents) firstChain = chain;
+        consistent &= chain == firstChain && interval == 1 && flags == 0 && vblank >= lastVBlank &&
+                      !strstr(line, "FAILED");
+        lastVBlank = vblank;
+        presents++;
+    }
+    int status = pclose(dump);
+    return status == 0 && consistent && presents == records;
+}
+
+// Presents count toward the virtual display whose window presented them
+void TestPresentsPerDisplay(ProxyDXGIFactory* factory) {
+    g_VirtualDisplays.SetCount(2);
+    g_VirtualDisplays.Publish(0, {{0, 0, 1920, 1080}, {0, 0, 1920, 1080}, nullptr, (HWND)0xA00});
+    g_VirtualDisplays.Publish(1, {{2600, 40, 3880, 760}, {2600, 40, 3880, 760}, nullptr, (HWND)0xB00});
+    InvalidateOutputTopology();
+    IDXGIOutput* fakes[2] = {EnumOutput(factory, 0, 1), EnumOutput(factory, 0, 2)};
+    DXGI_FRAME_STATISTICS before[2], after[2];
+    for (int i = 0; i < 2; i++) fakes[i]->GetFrameStatistics(&before[i]);
+
+    IDXGISwapChain1* first = nullptr;
+    IDXGISwapChain1* second = nullptr;
+    factory->CreateSwapChainForHwnd(nullptr, (HWND)0xA00, nullptr, nullptr, nullptr, &first);
+    factory->CreateSwapChainForHwnd(nullptr, (HWND)0xB00, nullptr, nullptr, nullptr, &second);
+    for (int i = 0; i < 3; i++) first->Present(0, 0);
+    for (int i = 0; i < 5; i++) second->Present(0, 0);
+    for (int i = 0; i < 2; i++) fakes[i]->GetFrameStatistics(&after[i]);
+    Check(after[0].PresentCount - before[0].PresentCount == 3 && after[1].PresentCount - before[1].PresentCount == 5,
+          "presents: each display counts only its own swap chains");
+    Check(after[1].PresentRefreshCount <= after[1].SyncRefreshCount,
+          "presents: shown on a refresh of the display's own clock");
+
+    first->Release();
+    second->Release();
+    for (IDXGIOutput* fake : fakes) fake->Release();
+    g_VirtualDisplays.Publish(0, {{0, 0, 1920, 1080}, {0, 0, 1920, 1080}, nullptr, nullptr});
+    g_VirtualDisplays.SetCount(1);
+    InvalidateOutputTopology();
+}
+
+void TestFrameCapture(ProxyDXGIFactory* factory, const char* framecapTool) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "ls_addon_test.framecap";
+    IDXGISwapChain1* swapChain = nullptr;
+    factory->CreateSwapChainForHwnd(nullptr, (HWND)0x5678, nullptr, nullptr, nullptr, &swapChain);
+    bool started = g_FrameCapture.Start(path, g_VirtualVBlank[0].Period(), 1000);
+    Check(started, "frame_capture: starts");
+    for (int i = 0; i < 1200; i++) swapChain->Present(1, 0);
+    g_FrameCapture.Stop();
+    swapChain->Release();
+    Check(g_FrameCapture.Records() == 1000 && g_FrameCapture.Dropped() == 200,
+          "frame_capture: keeps the first records, counts the rest as dropped");
+    Check(started && std::filesystem::file_size(path) < 64 + 1001 * sizeof(FrameRecord),
+          "frame_capture: the file is trimmed to the records written");
+    if (framecapTool) {
+        Check(CaptureDecodes(framecapTool, path, g_FrameCapture.Records()), "frame_capture: ls_framecap decodes it");
+    }
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* framecapTool = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--framecap") == 0 && i + 1 < argc) framecapTool = argv[++i];
+    }
+
+    TestGridLayout();
+    TestRcuSlots();
+
+    // The proxy factory owns one reference to the mock; the adapter cache in
+    // dxgi_proxy.cpp is filled by the first EnumAdapters per LUID
+    MockSystem mocks;
+    mocks.factory.AddRef();
+    ProxyDXGIFactory* factory = new ProxyDXGIFactory(&mocks.factory);
+    TestEnumOutputs(factory);
+    TestRetiredReclaim(factory, mocks);
+    TestFakeModes(factory);
+    TestFrameStatistics(factory);
+    TestVBlankPerDisplay(factory);
+    TestSwapChains(factory, mocks);
+    TestPresentsPerDisplay(factory);
+    TestFrameCapture(factory, framecapTool);
+    factory->Release();
+
+    fprintf(stderr, "%d check(s) failed\n", g_Failures);
+    return g_Failures ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+// Counting replacements for the global allocation functions. Kept in their own
+// translation unit so the compiler cannot inline delete down to free() at a
+// call site that only sees the replaced operator new.
+#include "alloc_counter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> g_Allocations{0};
+
+uint64_t AllocationCount() { return g_Allocations.load(std::memory_order_relaxed); }
+
+void* operator new(size_t size) {
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdint>
+
+// Heap allocations made through the global operator new since start-up, for
+// checking that hot paths are allocation-free. Linking alloc_counter.cpp
+// replaces the global allocation functions.
+uint64_t AllocationCount();
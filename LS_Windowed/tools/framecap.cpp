@@ -0,0 +1,245 @@
+// Analyzes frame captures (LS_Windowed.framecap): frame-time percentiles and
+// stutters per swap chain, and how often slow frames follow a layout change
+// (a target window moving, or an overlay being moved after it).
+//
+// A stutter is a frame that took more than --stutter times the swap chain's
+// median frame time. A frame is near a layout change when one happened
+// between --window milliseconds before the previous present and its own
+// present.
+//
+//   ls_framecap [--stutter 2.0] [--window 50] [--dump] <file.framecap>
+#include "frame_capture.hpp"
+#include "percentile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <vector>
+
+namespace {
+
+struct Options {
+    double stutterFactor = 2.0;
+    uint64_t windowNs = 50000000;
+    bool dump = false;
+};
+
+const char* KindName(FrameEventKind kind) {
+    switch (kind) {
+    case FrameEventKind::None: return "none";
+    case FrameEventKind::Present: return "present";
+    case FrameEventKind::TargetRect: return "target";
+    case FrameEventKind::OverlayMove: return "overlay";
+    }
+    return "?";
+}
+
+bool IsShown(const FrameRecord& record) {
+    return !record.present.failed && !(record.flags & 0x0001); // DXGI_PRESENT_TEST shows nothing
+}
+
+void Dump(const std::vector<FrameRecord>& records, uint64_t baseNs) {
+    for (const FrameRecord& record : records) {
+        double ms = (double)(int64_t)(record.timeNs - baseNs) / 1e6;
+        if (record.kind == FrameEventKind::Present) {
+            printf("%12.3f ms  present  chain %u  vblank %llu  interval %u  flags 0x%x  %.1f us%s\n", ms,
+                   record.source, (unsigned long long)record.present.vblank, record.present.syncInterval,
+                   record.flags, record.present.durationNs / 1e3, record.present.failed ? "  FAILED" : "");
+        } else {
+            printf("%12.3f ms  %-7s  slot %u   %d,%d %dx%d\n", ms, KindName(record.kind), record.source,
+                   record.rect.left, record.rect.top, record.rect.right - record.rect.left,
+                   record.rect.bottom - record.rect.top);
+        }
+    }
+}
+
+// One shown frame: from the previous shown present of its swap chain to its own
+struct Frame {
+    uint64_t startNs;
+    uint64_t endNs;
+    uint64_t vblanks; // Virtual vblanks between the two presents
+    uint8_t syncInterval;
+    bool nearLayout = false;
+};
+
+void AnalyzeSwapChain(unsigned source, const std::vector<const FrameRecord*>& presents,
+                      const std::vector<uint64_t>& layoutTimes, const Options& options) {
+    std::vector<Frame> frames;
+    std::vector<uint64_t> costs;
+    size_t failed = 0, tests = 0;
+    const FrameRecord* previous = nullptr;
+    for (const FrameRecord* present : presents) {
+        if (present->present.failed) failed++;
+        else if (!IsShown(*present)) tests++;
+        if (!IsShown(*present)) continue;
+        costs.push_back(present->present.durationNs);
+        if (previous && present->timeNs > previous->timeNs) {
+            frames.push_back({previous->timeNs, present->timeNs, present->present.vblank - previous->present.vblank,
+                              present->present.syncInterval});
+        }
+        previous = present;
+    }
+    printf("swap chain %u: %zu presents (%zu failed, %zu test), %zu frames\n", source, presents.size(), failed,
+           tests, frames.size());
+    if (frames.empty()) return;
+
+    std::vector<uint64_t> times;
+    times.reserve(frames.size());
+    for (const Frame& frame : frames) times.push_back(frame.endNs - frame.startNs);
+    std::sort(times.begin(), times.end());
+    std::sort(costs.begin(), costs.end());
+    uint64_t median = Percentile(times, 0.50);
+    double seconds = (double)(frames.back().endNs - frames.front().startNs) / 1e9;
+    printf("  %.1f fps over %.1f s\n", (double)frames.size() / seconds, seconds);
+    printf("  frame time: p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, p99.9 %.2f ms, max %.2f ms\n", median / 1e6,
+           Percentile(times, 0.90) / 1e6, Percentile(times, 0.99) / 1e6, Percentile(times, 0.999) / 1e6,
+           times.back() / 1e6);
+    printf("  present call: p50 %.0f us, p99 %.0f us, max %.0f us\n", Percentile(costs, 0.50) / 1e3,
+           Percentile(costs, 0.99) / 1e3, costs.back() / 1e3);
+
+    // Mark the frames a layout change may have disturbed; both lists are in
+    // time order, so one pass over each does it
+    size_t next = 0;
+    for (Frame& frame : frames) {
+        uint64_t from = frame.startNs > options.windowNs ? frame.startNs - options.windowNs : 0;
+        while (next < layoutTimes.size() && layoutTimes[next] < from) next++;
+        frame.nearLayout = next < layoutTimes.size() && layoutTimes[next] <= frame.endNs;
+    }
+
+    uint64_t threshold = (uint64_t)((double)median * options.stutterFactor);
+    size_t stutters = 0, stuttersNearLayout = 0, nearLayout = 0, heldVBlanks = 0;
+    std::vector<uint64_t> nearTimes, otherTimes;
+    for (const Frame& frame : frames) {
+        uint64_t time = frame.endNs - frame.startNs;
+        bool stutter = time > threshold;
+        stutters += stutter;
+        stuttersNearLayout += stutter && frame.nearLayout;
+        nearLayout += frame.nearLayout;
+        (frame.nearLayout ? nearTimes : otherTimes).push_back(time);
+        // With vsync a frame should span exactly its sync interval
+        if (frame.syncInterval && frame.vblanks > frame.syncInterval) heldVBlanks++;
+    }
+    printf("  stutters (> %.1fx median, %.2f ms): %zu (%.2f%%, %.1f/min)\n", options.stutterFactor, threshold / 1e6,
+           stutters, 100.0 * stutters / frames.size(), stutters / seconds * 60.0);
+    printf("  frames spanning more vblanks than their sync interval: %zu\n", heldVBlanks);
+
+    if (layoutTimes.empty()) return;
+    double baseRate = (double)nearLayout / frames.size();
+    printf("  frames near a layout change: %zu (%.2f%%)\n", nearLayout, 100.0 * baseRate);
+    if (stutters) {
+        double stutterRate = (double)stuttersNearLayout / stutters;
+        printf("  stutters near a layout change: %zu of %zu (%.2f%%)", stuttersNearLayout, stutters,
+               100.0 * stutterRate);
+        if (baseRate > 0) printf(", %.1fx the rate of all frames", stutterRate / baseRate);
+        printf("\n");
+    }
+    std::sort(nearTimes.begin(), nearTimes.end());
+    std::sort(otherTimes.begin(), otherTimes.end());
+    if (!nearTimes.empty() && !otherTimes.empty()) {
+        printf("  frame time p50/p99 near layout changes %.2f/%.2f ms, elsewhere %.2f/%.2f ms\n",
+               Percentile(nearTimes, 0.50) / 1e6, Percentile(nearTimes, 0.99) / 1e6,
+               Percentile(otherTimes, 0.50) / 1e6, Percentile(otherTimes, 0.99) / 1e6);
+    }
+}
+
+int AnalyzeFile(const char* path, const Options& options) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    FrameCaptureHeader header;
+    if (data.size() < sizeof(header)) {
+        fprintf(stderr, "%s: file too short\n", path);
+        return 1;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != kFrameCaptureMagic || header.version != kFrameCaptureVersion ||
+        header.recordSize != sizeof(FrameRecord)) {
+        fprintf(stderr, "%s: not a version %u frame capture\n", path, kFrameCaptureVersion);
+        return 1;
+    }
+    if (header.recordOffset > data.size()) {
+        fprintf(stderr, "%s: corrupt header\n", path);
+        return 1;
+    }
+
+    // A capture cut short by a crash has no count; take every record present
+    uint64_t available = (data.size() - header.recordOffset) / sizeof(FrameRecord);
+    uint64_t count = std::min<uint64_t>(available, header.recordCapacity);
+    bool complete = header.flags & kFrameCaptureComplete;
+    if (complete) count = std::min(count, header.recordCount);
+
+    std::vector<FrameRecord> records;
+    records.reserve((size_t)count);
+    size_t torn = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        FrameRecord record;
+        memcpy(&record, &data[header.recordOffset + i * sizeof(FrameRecord)], sizeof(record));
+        if (record.kind == FrameEventKind::None || record.kind > FrameEventKind::OverlayMove) {
+            torn++;
+            continue;
+        }
+        records.push_back(record);
+    }
+    // Records are claimed in order but finished out of order across threads
+    std::stable_sort(records.begin(), records.end(),
+                     [](const FrameRecord& a, const FrameRecord& b) { return a.timeNs < b.timeNs; });
+
+    printf("==== %s: %zu records%s", path, records.size(), complete ? "" : ", DID NOT STOP CLEANLY");
+    if (header.dropped) printf(", %llu dropped (file full)", (unsigned long long)header.dropped);
+    if (header.vblankPeriodNs) printf(", virtual display at %.2f Hz", 1e9 / (double)header.vblankPeriodNs);
+    printf("\n");
+    if (torn && complete) fprintf(stderr, "warning: %zu unreadable records\n", torn);
+
+    if (options.dump) {
+        Dump(records, header.steadyBaseNs);
+        return 0;
+    }
+
+    std::map<unsigned, std::vector<const FrameRecord*>> swapChains;
+    std::vector<uint64_t> layoutTimes;
+    size_t targetMoves = 0, overlayMoves = 0;
+    for (const FrameRecord& record : records) {
+        switch (record.kind) {
+        case FrameEventKind::Present: swapChains[record.source].push_back(&record); break;
+        case FrameEventKind::TargetRect: targetMoves++; layoutTimes.push_back(record.timeNs); break;
+        case FrameEventKind::OverlayMove: overlayMoves++; layoutTimes.push_back(record.timeNs); break;
+        default: break;
+        }
+    }
+    printf("layout changes: %zu target rect changes, %zu overlay moves\n", targetMoves, overlayMoves);
+    for (const auto& [source, presents] : swapChains) AnalyzeSwapChain(source, presents, layoutTimes, options);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stutter") == 0 && i + 1 < argc) {
+            options.stutterFactor = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            options.windowNs = (uint64_t)(atof(argv[++i]) * 1e6);
+        } else if (strcmp(argv[i], "--dump") == 0) {
+            options.dump = true;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() || options.stutterFactor <= 1.0) {
+        fprintf(stderr, "usage: %s [--stutter factor > 1] [--window ms] [--dump] <file.framecap>...\n", argv[0]);
+        return 2;
+    }
+
+    int result = 0;
+    for (const char* path : paths) result |= AnalyzeFile(path, options);
+    return result;
+}
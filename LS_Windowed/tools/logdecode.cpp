@@ -0,0 +1,163 @@
+// Renders binary logs (LS_Windowed.binlog and its rotated predecessors) as
+// text, oldest surviving record first.
+//
+//   ls_logdecode [--level trace|debug|info|warn|error] <file>...
+#include "log_record.hpp"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct FormatDef {
+    LogLevel level;
+    std::string text;
+};
+
+bool ParseLevel(const char* name, LogLevel& level) {
+    for (int i = (int)LogLevel::Trace; i <= (int)LogLevel::Error; i++) {
+        std::string candidate = LogLevelName((LogLevel)i);
+        for (char& c : candidate) c = (char)tolower((unsigned char)c);
+        if (candidate == name) {
+            level = (LogLevel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FormatTimestamp(uint64_t unixNs, char* out, size_t size) {
+    time_t seconds = (time_t)(unixNs / 1000000000ull);
+    unsigned millis = (unsigned)(unixNs / 1000000ull % 1000);
+    struct tm utc;
+#ifdef _WIN32
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+    size_t length = strftime(out, size, "%Y-%m-%d %H:%M:%S", &utc);
+    snprintf(out + length, size - length, ".%03u", millis);
+}
+
+// Walks the records of one region: FormatDef records of the format table or
+// Message records of the ring, in logical order from begin to end
+template <class Visit>
+void ForEachRecord(const uint8_t* region, uint64_t capacity, uint64_t begin, uint64_t end, Visit&& visit) {
+    uint64_t offset = begin;
+    while (offset < end) {
+        uint64_t physical = offset % capacity;
+        uint64_t remaining = capacity - physical;
+        if (remaining < kLogRecordHeaderSize || (LogRecordKind)region[physical] == LogRecordKind::Pad) {
+            offset += remaining;
+            continue;
+        }
+        uint16_t length;
+        memcpy(&length, region + physical + 1, sizeof(length));
+        if (kLogRecordHeaderSize + length > remaining || offset + kLogRecordHeaderSize + length > end) {
+            fprintf(stderr, "warning: corrupt record at ring offset %llu\n", (unsigned long long)offset);
+            return;
+        }
+        visit((LogRecordKind)region[physical], region + physical + kLogRecordHeaderSize, length);
+        offset += kLogRecordHeaderSize + length;
+    }
+}
+
+int DecodeFile(const char* path, LogLevel minLevel) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    LogFileHeader header;
+    if (data.size() < sizeof(header)) {
+        fprintf(stderr, "%s: file too short\n", path);
+        return 1;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != kLogFileMagic || header.version != kLogFileVersion) {
+        fprintf(stderr, "%s: not a version %u binary log\n", path, kLogFileVersion);
+        return 1;
+    }
+    if ((uint64_t)header.formatOffset + header.formatCapacity > data.size() || header.formatBytes > header.formatCapacity ||
+        header.ringOffset + header.ringCapacity > data.size() || header.ringCapacity == 0 ||
+        header.ringTail > header.ringHead || header.ringHead - header.ringTail > header.ringCapacity) {
+        fprintf(stderr, "%s: corrupt header\n", path);
+        return 1;
+    }
+
+    std::unordered_map<uint16_t, FormatDef> formats;
+    ForEachRecord(&data[header.formatOffset], header.formatCapacity, 0, header.formatBytes,
+                  [&](LogRecordKind kind, const uint8_t* body, uint16_t length) {
+                      if (kind != LogRecordKind::FormatDef || length < 3) return;
+                      uint16_t id;
+                      memcpy(&id, body, sizeof(id));
+                      formats[id] = {(LogLevel)body[2],
+                                     std::string(reinterpret_cast<const char*>(body + 3), length - 3)};
+                  });
+
+    char timestamp[64];
+    FormatTimestamp(header.unixBaseNs, timestamp, sizeof(timestamp));
+    printf("==== %s: session started %s UTC%s%s\n", path, timestamp,
+           header.ringTail ? ", oldest records overwritten" : "",
+           header.flags & kLogFileCleanShutdown ? "" : ", DID NOT SHUT DOWN CLEANLY");
+
+    size_t messages = 0;
+    ForEachRecord(&data[header.ringOffset], header.ringCapacity, header.ringTail, header.ringHead,
+                  [&](LogRecordKind kind, const uint8_t* body, uint16_t length) {
+                      if (kind != LogRecordKind::Message || length < sizeof(LogMessageHeader)) return;
+                      LogMessageHeader message;
+                      memcpy(&message, body, sizeof(message));
+                      if (message.level < minLevel) return;
+
+                      auto format = formats.find(message.formatId);
+                      std::string text = format == formats.end()
+                                             ? "<unknown format " + std::to_string(message.formatId) + ">"
+                                             : RenderLogMessage(format->second.text.c_str(), body + sizeof(message),
+                                                                length - sizeof(message));
+                      if (message.flags & kLogFlagTruncated) text += " <truncated>";
+
+                      FormatTimestamp(header.unixBaseNs + (message.timeNs - header.steadyBaseNs), timestamp,
+                                      sizeof(timestamp));
+                      printf("%s [%-5s] [%5u] %s\n", timestamp, LogLevelName(message.level), message.threadId,
+                             text.c_str());
+                      messages++;
+                  });
+    fprintf(stderr, "%s: %zu messages, %zu formats\n", path, messages, formats.size());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LogLevel minLevel = LogLevel::Trace;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--level") == 0) {
+            if (i + 1 >= argc || !ParseLevel(argv[i + 1], minLevel)) {
+                fprintf(stderr, "--level expects trace, debug, info, warn or error\n");
+                return 2;
+            }
+            i++;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        fprintf(stderr, "usage: %s [--level trace|debug|info|warn|error] <file.binlog>...\n", argv[0]);
+        return 2;
+    }
+
+    // Sessions are printed in the order given, e.g. LS_Windowed.2.binlog
+    // LS_Windowed.1.binlog LS_Windowed.binlog for oldest-first
+    int result = 0;
+    for (const char* path : paths) result |= DecodeFile(path, minLevel);
+    return result;
+}
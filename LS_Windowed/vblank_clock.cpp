@@ -0,0 +1,232 @@
+#include "vblank_clock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Bounds of the final spin: enough to absorb scheduler wake-up latency,
+// small enough not to burn a meaningful share of a frame
+constexpr int64_t kMinSpinNs = 50000;
+constexpr int64_t kMaxSpinNs = 2000000;
+constexpr int64_t kSpinMarginNs = 50000;
+
+#ifdef _WIN32
+constexpr int64_t kInitialOvershootNs = 500000; // High-resolution timers fire within ~0.5 ms
+#else
+constexpr int64_t kInitialOvershootNs = 100000;
+#endif
+
+void CpuRelax() {
+#if defined(_WIN32)
+    YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+#ifdef _WIN32
+// One timer per waiting thread, closed when the thread exits
+struct ThreadTimer {
+    HANDLE handle;
+    bool raisedResolution = false;
+
+    ThreadTimer() {
+        // High-resolution timers exist since Windows 10 1803; fall back to a
+        // regular one, which needs the system timer at 1 ms to be usable
+        handle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!handle) {
+            RaiseResolution();
+            handle = CreateWaitableTimerW(nullptr, TRUE, nullptr);
+        }
+    }
+    ~ThreadTimer() {
+        if (handle) CloseHandle(handle);
+        if (raisedResolution) timeEndPeriod(1);
+    }
+
+    // The default 15.6 ms tick would make Sleep and regular timers overshoot
+    // whole frames; held until the thread exits
+    void RaiseResolution() {
+        if (!raisedResolution) raisedResolution = timeBeginPeriod(1) == TIMERR_NOERROR;
+    }
+};
+#endif
+
+} // namespace
+
+VBlankClock::VBlankClock(uint64_t periodNs)
+    : m_timeline({{NowNs(), periodNs, 0}, 0}), m_timerOvershootNs(kInitialOvershootNs) {}
+
+uint64_t VBlankClock::NowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int64_t VBlankClock::PeriodsSince(const Timeline& timeline, uint64_t timeNs) {
+    int64_t delta = (int64_t)(timeNs - timeline.reference.vblankNs);
+    int64_t period = (int64_t)timeline.Period();
+    return delta >= 0 ? delta / period : -((-delta + period - 1) / period);
+}
+
+VBlankSample VBlankClock::LastVBlank(const Timeline& timeline, uint64_t nowNs) {
+    int64_t periods = PeriodsSince(timeline, nowNs);
+    VBlankSample sample;
+    sample.count = timeline.reference.index + (uint64_t)periods;
+    sample.timeNs = timeline.reference.vblankNs + (uint64_t)(periods * (int64_t)timeline.Period());
+    return sample;
+}
+
+// Moves the reference and/or the period without disturbing the vblank count:
+// the new reference vblank takes the count of the nearest vblank on the old
+// timeline. Called with m_timelineWriter held.
+void VBlankClock::Rebase(const Timeline& next) {
+    Timeline old = m_timeline.Load();
+    int64_t delta = (int64_t)(next.reference.vblankNs - old.reference.vblankNs);
+    int64_t period = (int64_t)old.Period();
+    int64_t periods = (delta >= 0 ? delta + period / 2 : delta - period / 2) / period;
+
+    // A reference older than the clock (the compositor's last vblank, right
+    // after start-up) would take the count below zero
+    if (periods < 0 && (uint64_t)-periods > old.reference.index) periods = -(int64_t)old.reference.index;
+
+    Timeline rebased = next;
+    rebased.reference.index = old.reference.index + (uint64_t)periods;
+    m_timeline.Store(rebased);
+}
+
+void VBlankClock::SetReference(const VBlankReference& reference) {
+    if (!reference.periodNs) return;
+    std::unique_lock<std::mutex> lock(m_timelineWriter, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+    Timeline next = m_timeline.Load();
+    next.reference = reference;
+    Rebase(next);
+}
+
+void VBlankClock::SetPeriodOverride(uint64_t periodNs) {
+    std::lock_guard<std::mutex> lock(m_timelineWriter);
+    Timeline next = m_timeline.Load();
+    if (next.periodOverrideNs == periodNs) return;
+    // Re-anchor on the latest vblank so the new period starts from it
+    next.reference.vblankNs = LastVBlank(next, NowNs()).timeNs;
+    next.periodOverrideNs = periodNs;
+    Rebase(next);
+}
+
+uint64_t VBlankClock::Period() const {
+    return m_timeline.Load().Period();
+}
+
+uint64_t VBlankClock::NextVBlank(uint64_t nowNs) const {
+    Timeline timeline = m_timeline.Load();
+    return timeline.reference.vblankNs + (uint64_t)((PeriodsSince(timeline, nowNs) + 1) * (int64_t)timeline.Period());
+}
+
+VBlankSample VBlankClock::LastVBlank(uint64_t nowNs) const {
+    return LastVBlank(m_timeline.Load(), nowNs);
+}
+
+VBlankSample VBlankClock::PublishedVBlank(uint64_t nowNs) {
+    VBlankSample sample = LastVBlank(nowNs);
+    std::lock_guard<std::mutex> lock(m_publishedMutex);
+    m_published.count = std::max(m_published.count, sample.count);
+    m_published.timeNs = std::max(m_published.timeNs, sample.timeNs);
+    return m_published;
+}
+
+void VBlankClock::SleepUntil(uint64_t deadlineNs) {
+    int64_t overshoot = m_timerOvershootNs.load(std::memory_order_relaxed);
+    int64_t spin = std::min(std::max(overshoot + kSpinMarginNs, kMinSpinNs), kMaxSpinNs);
+
+    uint64_t now = NowNs();
+    if (deadlineNs > now + (uint64_t)spin) {
+        uint64_t timerDeadline = deadlineNs - (uint64_t)spin;
+#ifdef _WIN32
+        static thread_local ThreadTimer timer;
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)((timerDeadline - now) / 100); // Relative, in 100 ns units
+        if (timer.handle && SetWaitableTimer(timer.handle, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(timer.handle, INFINITE);
+        } else {
+            timer.RaiseResolution();
+            Sleep((DWORD)((timerDeadline - now) / 1000000));
+        }
+#else
+        std::this_thread::sleep_for(std::chrono::nanoseconds(timerDeadline - now));
+#endif
+        // Smooth the observed lateness (1/8 weight per sample) to size the next spin
+        int64_t lateness = (int64_t)(NowNs() - timerDeadline);
+        m_timerOvershootNs.store(overshoot + (lateness - overshoot) / 8, std::memory_order_relaxed);
+    }
+
+    while (NowNs() < deadlineNs) CpuRelax();
+}
+
+uint64_t VBlankClock::Wait() {
+    uint64_t vblank = NextVBlank(NowNs());
+    SleepUntil(vblank);
+    uint64_t woke = NowNs();
+
+    Record(vblank, woke, Period());
+    return vblank;
+}
+
+void VBlankClock::Record(uint64_t vblankNs, uint64_t wokeNs, uint64_t periodNs) {
+    uint64_t lateness = wokeNs > vblankNs ? wokeNs - vblankNs : 0;
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_waits++;
+    if (lateness > periodNs / 2) m_missed++;
+    double delta = (double)lateness - m_mean;
+    m_mean += delta / (double)m_waits;
+    m_m2 += delta * ((double)lateness - m_mean);
+    m_max = std::max(m_max, lateness);
+    m_histogram[std::min<uint64_t>(lateness / 1000, kHistogramUs)]++;
+}
+
+VBlankStats VBlankClock::Stats() const {
+    VBlankStats stats;
+    stats.spinNs = (double)std::min(
+        std::max(m_timerOvershootNs.load(std::memory_order_relaxed) + kSpinMarginNs, kMinSpinNs), kMaxSpinNs);
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    stats.waits = m_waits;
+    stats.missed = m_missed;
+    if (!m_waits) return stats;
+    stats.meanLatenessNs = m_mean;
+    stats.stddevNs = m_waits > 1 ? std::sqrt(m_m2 / (double)(m_waits - 1)) : 0.0;
+    stats.maxNs = (double)m_max;
+
+    auto percentile = [&](double fraction) {
+        uint64_t rank = (uint64_t)std::ceil(fraction * (double)m_waits);
+        uint64_t seen = 0;
+        for (size_t i = 0; i <= kHistogramUs; i++) {
+            seen += m_histogram[i];
+            if (seen >= rank) return (double)(i + 1) * 1000.0; // Bucket upper bound
+        }
+        return (double)(kHistogramUs + 1) * 1000.0;
+    };
+    stats.p50Ns = percentile(0.50);
+    stats.p99Ns = percentile(0.99);
+    return stats;
+}
+
+void VBlankClock::ResetStats() {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_waits = 0;
+    m_missed = 0;
+    m_mean = 0;
+    m_m2 = 0;
+    m_max = 0;
+    std::fill(std::begin(m_histogram), std::end(m_histogram), 0u);
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "seqlock.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// A known vblank and the refresh period, in steady_clock nanoseconds. index is
+// the vblank count at vblankNs; it carries over when the reference moves.
+struct VBlankReference {
+    uint64_t vblankNs = 0;
+    uint64_t periodNs = 0;
+    uint64_t index = 0;
+};
+
+// One vblank on the clock's timeline
+struct VBlankSample {
+    uint64_t count = 0; // Vblanks since the clock was created
+    uint64_t timeNs = 0;
+};
+
+struct VBlankStats {
+    uint64_t waits = 0;
+    uint64_t missed = 0;      // Woke up more than half a period after the vblank
+    double meanLatenessNs = 0; // Wake-up time minus the vblank it waited for
+    double stddevNs = 0;
+    double p50Ns = 0; // Percentiles have 1 us resolution, capped at kHistogramUs
+    double p99Ns = 0;
+    double maxNs = 0;
+    double spinNs = 0; // Current final-spin budget
+};
+
+// Emulated vertical blank for the virtual output. Wait() blocks until the next
+// vblank boundary of the reference timeline: it sleeps on a high-resolution
+// timer (a waitable timer on Windows) until shortly before the boundary, then
+// spins for the rest. The spin budget tracks how late the timer tends to fire,
+// so it stays short on systems with precise timers. Thread-safe.
+class VBlankClock {
+public:
+    static constexpr size_t kHistogramUs = 2000;
+
+    explicit VBlankClock(uint64_t periodNs = 1000000000ull / 60);
+
+    // Phase-locks to an observed vblank (e.g. from the compositor); the
+    // reference's index is ignored and continued from the current timeline.
+    // Calls racing with another update are dropped.
+    void SetReference(const VBlankReference& reference);
+    VBlankReference Reference() const { return m_timeline.Load().reference; }
+
+    // Forces a refresh period while keeping the reference phase; 0 follows
+    // the reference period
+    void SetPeriodOverride(uint64_t periodNs);
+    uint64_t Period() const;
+
+    // First vblank strictly after nowNs
+    uint64_t NextVBlank(uint64_t nowNs) const;
+
+    // Latest vblank at or before nowNs, with its count
+    VBlankSample LastVBlank(uint64_t nowNs) const;
+
+    // LastVBlank for reporting to applications: neither the count nor the time
+    // is ever below what an earlier call returned. A resync that moves the
+    // phase back holds them until the new timeline catches up.
+    VBlankSample PublishedVBlank(uint64_t nowNs);
+
+    // Returns the vblank time waited for
+    uint64_t Wait();
+
+    VBlankStats Stats() const;
+    void ResetStats();
+
+    static uint64_t NowNs();
+
+private:
+    struct Timeline {
+        VBlankReference reference;
+        uint64_t periodOverrideNs = 0;
+        uint64_t Period() const { return periodOverrideNs ? periodOverrideNs : reference.periodNs; }
+    };
+    // Signed number of whole periods from the reference to timeNs, rounded down
+    static int64_t PeriodsSince(const Timeline& timeline, uint64_t timeNs);
+    static VBlankSample LastVBlank(const Timeline& timeline, uint64_t nowNs);
+    void Rebase(const Timeline& next);
+
+    void SleepUntil(uint64_t deadlineNs);
+    void Record(uint64_t vblankNs, uint64_t wokeNs, uint64_t periodNs);
+
+    SeqLock<Timeline> m_timeline;
+    std::mutex m_timelineWriter;
+    std::mutex m_publishedMutex;
+    VBlankSample m_published;
+    std::atomic<int64_t> m_timerOvershootNs; // Smoothed lateness of the timer wake-up
+
+    mutable std::mutex m_statsMutex;
+    uint64_t m_waits = 0;
+    uint64_t m_missed = 0;
+    double m_mean = 0; // Welford running mean / sum of squared deviations
+    double m_m2 = 0;
+    uint64_t m_max = 0;
+    uint32_t m_histogram[kHistogramUs + 1] = {};
+};
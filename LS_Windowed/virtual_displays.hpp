@@ -0,0 +1,87 @@
+#pragma once
+#include "target_geometry.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+
+constexpr size_t kMaxVirtualDisplays = 4;
+
+// The virtual monitors injected into GDI and DXGI enumeration. Their monitor
+// handles are consecutive values from kMonitorBase, so mapping a handle back to
+// its display is a subtraction and a bounds check. Each display has its own
+// geometry slot, written only by the layout bound to it and read lock-free by
+// the hooks; a display nothing has been published to yet mirrors display 0.
+class VirtualDisplays {
+public:
+    static constexpr uintptr_t kMonitorBase = 0xBADF00D;
+
+    explicit VirtualDisplays(const TargetGeometry& initial) {
+        for (size_t i = 0; i < kMaxVirtualDisplays; i++) {
+            Display& display = m_displays[i];
+            display.geometry.Store(initial);
+            if (i == 0) {
+                swprintf(display.monitorName, 32, L"\\\\.\\DISPLAY_WINDOWED");
+                swprintf(display.outputName, 32, L"\\\\.\\DISPLAY_VIRTUAL");
+            } else {
+                swprintf(display.monitorName, 32, L"\\\\.\\DISPLAY_WINDOWED%u", (unsigned)(i + 1));
+                swprintf(display.outputName, 32, L"\\\\.\\DISPLAY_VIRTUAL%u", (unsigned)(i + 1));
+            }
+        }
+    }
+
+    // Displays currently exposed, 1 to kMaxVirtualDisplays
+    size_t Count() const { return m_count.load(std::memory_order_acquire); }
+
+    // Returns true if the count changed; output lists must then be invalidated
+    bool SetCount(size_t count) {
+        count = count < 1 ? 1 : (count > kMaxVirtualDisplays ? kMaxVirtualDisplays : count);
+        return m_count.exchange(count, std::memory_order_acq_rel) != count;
+    }
+
+    static HMONITOR Monitor(size_t index) { return (HMONITOR)(kMonitorBase + index); }
+
+    // Index of an exposed virtual display, or -1 for any other handle
+    int IndexOf(HMONITOR monitor) const {
+        uintptr_t index = (uintptr_t)monitor - kMonitorBase;
+        return index < Count() ? (int)index : -1;
+    }
+
+    // Exposed display whose LS window or target window is window, or -1
+    int IndexOfWindow(HWND window) const {
+        if (!window) return -1;
+        for (size_t i = 0; i < Count(); i++) {
+            TargetGeometry geometry = Geometry(i);
+            if (geometry.lsWindow == window || geometry.targetWindow == window) return (int)i;
+        }
+        return -1;
+    }
+
+    TargetGeometry Geometry(size_t index) const {
+        const Display& display = m_displays[index].bound.load(std::memory_order_acquire) ? m_displays[index] : m_displays[0];
+        return display.geometry.Load();
+    }
+
+    // Must only be called by the single producer bound to this display
+    void Publish(size_t index, const TargetGeometry& geometry) {
+        m_displays[index].geometry.Store(geometry);
+        m_displays[index].bound.store(true, std::memory_order_release);
+    }
+
+    // GDI device name (MONITORINFOEXW::szDevice) and DXGI output device name
+    const wchar_t* MonitorName(size_t index) const { return m_displays[index].monitorName; }
+    const wchar_t* OutputName(size_t index) const { return m_displays[index].outputName; }
+
+private:
+    struct Display {
+        SeqLock<TargetGeometry> geometry;
+        std::atomic<bool> bound{false};
+        wchar_t monitorName[32];
+        wchar_t outputName[32];
+    };
+
+    std::atomic<size_t> m_count{1};
+    Display m_displays[kMaxVirtualDisplays];
+};
+
+extern VirtualDisplays g_VirtualDisplays;
@@ -0,0 +1,199 @@
+#include "win32_event_source.hpp"
+#include "logger.hpp"
+#include <algorithm>
+
+// The module this code lives in. The display change window's class is
+// registered under it rather than the host EXE, so it goes away with the DLL.
+extern "C" IMAGE_DOS_HEADER __ImageBase;
+
+static const wchar_t* kDisplayClass = L"LS_Windowed_DisplayChange";
+
+// WinEvent callbacks carry no user data, so the active source is kept here
+static Win32WindowEventSource* s_activeSource = nullptr;
+
+Win32WindowEventSource::Win32WindowEventSource(DisplayChangeFn onDisplayChange)
+    : m_onDisplayChange(std::move(onDisplayChange)) {
+    m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+}
+
+Win32WindowEventSource::~Win32WindowEventSource() {
+    Stop();
+    if (m_wakeEvent) CloseHandle(m_wakeEvent);
+}
+
+bool Win32WindowEventSource::Start() {
+    if (!m_wakeEvent) return false;
+
+    struct HookRange {
+        DWORD min;
+        DWORD max;
+    };
+    const HookRange ranges[] = {
+        {EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND},
+        {EVENT_OBJECT_DESTROY, EVENT_OBJECT_SHOW},
+    };
+
+    s_activeSource = this;
+    for (const HookRange& range : ranges) {
+        HWINEVENTHOOK hook = SetWinEventHook(range.min, range.max, nullptr, WinEventProc, 0, 0,
+                                             WINEVENT_OUTOFCONTEXT);
+        if (!hook) {
+            LOG_WARN("[LS_Windowed] SetWinEventHook(0x%04X) failed, falling back to polling.", range.min);
+            Stop();
+            return false;
+        }
+        m_hooks.push_back(hook);
+    }
+
+    // Never shown; without it topology changes are only seen through IDXGIFactory::IsCurrent
+    WNDCLASSW windowClass = {};
+    windowClass.lpfnWndProc = DisplayWndProc;
+    windowClass.hInstance = (HINSTANCE)&__ImageBase;
+    windowClass.lpszClassName = kDisplayClass;
+    RegisterClassW(&windowClass); // Stop() unregisters it, so this only fails if the window is still up
+    m_displayWindow = CreateWindowExW(WS_EX_TOOLWINDOW, kDisplayClass, L"", WS_POPUP, 0, 0, 0, 0, nullptr, nullptr,
+                                      windowClass.hInstance, nullptr);
+    if (!m_displayWindow) {
+        LOG_WARN("[LS_Windowed] Display change window could not be created (%lu).", GetLastError());
+    }
+    return true;
+}
+
+void Win32WindowEventSource::Stop() {
+    for (HWINEVENTHOOK hook : m_hooks) {
+        UnhookWinEvent(hook);
+    }
+    m_hooks.clear();
+    for (const MoveHook& moveHook : m_moveHooks) {
+        UnhookWinEvent(moveHook.hook);
+    }
+    m_moveHooks.clear();
+    if (m_displayWindow) {
+        DestroyWindow(m_displayWindow);
+        m_displayWindow = nullptr;
+    }
+    // A class left registered would outlive the DLL and its window procedure
+    UnregisterClassW(kDisplayClass, (HINSTANCE)&__ImageBase);
+    if (s_activeSource == this) s_activeSource = nullptr;
+}
+
+void Win32WindowEventSource::WatchMoves(const std::vector<uint32_t>& processes) {
+    if (m_hooks.empty()) return; // Not started; the tracker polls
+
+    auto watched = [&](uint32_t process) {
+        return std::find(processes.begin(), processes.end(), process) != processes.end();
+    };
+    auto stale = std::remove_if(m_moveHooks.begin(), m_moveHooks.end(), [&](const MoveHook& moveHook) {
+        if (watched(moveHook.process)) return false;
+        UnhookWinEvent(moveHook.hook);
+        return true;
+    });
+    m_moveHooks.erase(stale, m_moveHooks.end());
+
+    for (uint32_t process : processes) {
+        bool hooked = std::any_of(m_moveHooks.begin(), m_moveHooks.end(),
+                                  [&](const MoveHook& moveHook) { return moveHook.process == process; });
+        if (!process || hooked) continue;
+        HWINEVENTHOOK hook = SetWinEventHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, nullptr,
+                                             WinEventProc, process, 0, WINEVENT_OUTOFCONTEXT);
+        if (!hook) {
+            LOG_WARN("[LS_Windowed] SetWinEventHook(LOCATIONCHANGE) for process %u failed.", process);
+            continue;
+        }
+        m_moveHooks.push_back({process, hook});
+    }
+}
+
+bool Win32WindowEventSource::WaitEvents(std::chrono::milliseconds timeout, std::vector<WindowEvent>& out) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (TakePending(out)) return true;
+        }
+
+        DWORD waitMs = INFINITE;
+        if (timeout != kWaitForever) {
+            auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) return false;
+            waitMs = (DWORD)remaining.count();
+        }
+
+        DWORD result = MsgWaitForMultipleObjectsEx(1, &m_wakeEvent, waitMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        if (result == WAIT_TIMEOUT) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return TakePending(out);
+        }
+
+        // Dispatching runs WinEventProc, which queues into m_pending
+        MSG msg;
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+}
+
+void Win32WindowEventSource::Post(const WindowEvent& event) {
+    WindowEventQueue::Post(event);
+    SetEvent(m_wakeEvent);
+}
+
+void CALLBACK Win32WindowEventSource::WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                                   LONG idChild, DWORD idEventThread, DWORD dwmsEventTime) {
+    // Only whole top-level windows matter; location changes also fire for
+    // carets, cursors and child objects.
+    if (!hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) return;
+    if (!s_activeSource) return;
+
+    WindowEventType type;
+    switch (event) {
+    case EVENT_SYSTEM_FOREGROUND:
+        type = WindowEventType::Foreground;
+        break;
+    case EVENT_OBJECT_LOCATIONCHANGE:
+        type = WindowEventType::MoveSize;
+        break;
+    case EVENT_OBJECT_SHOW:
+        type = WindowEventType::Show;
+        break;
+    case EVENT_OBJECT_DESTROY:
+        type = WindowEventType::Destroy;
+        break;
+    default:
+        return;
+    }
+
+    // Already on the waiting thread: queue without signalling the wake event.
+    // Events delivered more than a timer tick late are stamped with when they
+    // happened, so follow latency includes that delivery delay.
+    s_activeSource->WindowEventQueue::Post({type, (uintptr_t)hwnd, EventTime(dwmsEventTime)});
+}
+
+std::chrono::steady_clock::time_point Win32WindowEventSource::EventTime(DWORD dwmsEventTime) {
+    // dwmsEventTime is on the GetTickCount clock; the unsigned difference
+    // survives its 49-day wrap. That clock only advances once per timer tick
+    // (15.6 ms by default), so an age up to one tick may be nothing but
+    // rounding: such events keep the dispatch time, and their queue delay is
+    // not counted. A time ahead of now or implausibly old is not trusted.
+    static const DWORD tickMs = [] {
+        DWORD increment = 0, adjustment = 0;
+        BOOL disabled = FALSE;
+        if (!GetSystemTimeAdjustment(&adjustment, &increment, &disabled) || !increment) return (DWORD)16;
+        return (DWORD)((increment + 9999) / 10000); // 100 ns units
+    }();
+    auto now = std::chrono::steady_clock::now();
+    DWORD ageMs = GetTickCount() - dwmsEventTime;
+    if (ageMs <= tickMs || ageMs > kMaxEventAgeMs) return now;
+    return now - std::chrono::milliseconds(ageMs);
+}
+
+LRESULT CALLBACK Win32WindowEventSource::DisplayWndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) {
+    if (message == WM_DISPLAYCHANGE && s_activeSource) {
+        if (s_activeSource->m_onDisplayChange) s_activeSource->m_onDisplayChange();
+        s_activeSource->WindowEventQueue::Post(
+            {WindowEventType::DisplayChange, 0, std::chrono::steady_clock::now()});
+        return 0;
+    }
+    return DefWindowProcW(hwnd, message, wParam, lParam);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "window_events.hpp"
+#include <functional>
+#include <windows.h>
+
+// Delivers foreground, move/size, show and destroy notifications through
+// out-of-context WinEvent hooks, and display changes through a hidden window
+// that receives the WM_DISPLAYCHANGE broadcast. Both are dispatched from the
+// message loop of the thread that created them, so Start(), WatchMoves() and
+// WaitEvents() must be called from the same thread. Location changes fire for
+// every window being dragged or animated anywhere on the desktop, so they are
+// hooked per watched process rather than globally.
+class Win32WindowEventSource : public WindowEventQueue {
+public:
+    using DisplayChangeFn = std::function<void()>;
+
+    // onDisplayChange runs on the event thread as soon as WM_DISPLAYCHANGE
+    // arrives, before the DisplayChange event is queued
+    explicit Win32WindowEventSource(DisplayChangeFn onDisplayChange = nullptr);
+    ~Win32WindowEventSource() override;
+
+    bool Start() override;
+    void Stop() override;
+    bool WaitEvents(std::chrono::milliseconds timeout, std::vector<WindowEvent>& out) override;
+    void Post(const WindowEvent& event) override;
+    void WatchMoves(const std::vector<uint32_t>& processes) override;
+
+private:
+    struct MoveHook {
+        uint32_t process;
+        HWINEVENTHOOK hook;
+    };
+
+    static constexpr DWORD kMaxEventAgeMs = 10000;
+
+    // Converts a WinEvent's dwmsEventTime to the steady clock events are
+    // stamped with; ages within one timer tick are taken as zero
+    static std::chrono::steady_clock::time_point EventTime(DWORD dwmsEventTime);
+    static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                      LONG idChild, DWORD idEventThread, DWORD dwmsEventTime);
+    static LRESULT CALLBACK DisplayWndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
+
+    DisplayChangeFn m_onDisplayChange;
+    HANDLE m_wakeEvent = nullptr;
+    HWND m_displayWindow = nullptr; // Top-level: message-only windows miss broadcasts
+    std::vector<HWINEVENTHOOK> m_hooks;
+    std::vector<MoveHook> m_moveHooks; // EVENT_OBJECT_LOCATIONCHANGE, one per watched process
+};
@@ -0,0 +1,82 @@
+#include "win32_window_system.hpp"
+#include "target_geometry.hpp"
+
+namespace {
+
+HWND ToHWND(WindowHandle window) { return (HWND)window; }
+
+struct EnumContext {
+    IWindowSystem::EnumProc proc;
+    void* context;
+};
+
+BOOL CALLBACK EnumWindowsThunk(HWND hwnd, LPARAM lParam) {
+    EnumContext* enumContext = (EnumContext*)lParam;
+    return enumContext->proc((WindowHandle)hwnd, enumContext->context) ? TRUE : FALSE;
+}
+
+} // namespace
+
+WindowHandle Win32WindowSystem::Foreground() {
+    return (WindowHandle)GetForegroundWindow();
+}
+
+bool Win32WindowSystem::Exists(WindowHandle window) {
+    return window && IsWindow(ToHWND(window));
+}
+
+bool Win32WindowSystem::IsVisible(WindowHandle window) {
+    return IsWindowVisible(ToHWND(window)) != FALSE;
+}
+
+bool Win32WindowSystem::IsOwnedByProcess(WindowHandle window) {
+    DWORD pid = 0;
+    GetWindowThreadProcessId(ToHWND(window), &pid);
+    return pid == GetCurrentProcessId();
+}
+
+bool Win32WindowSystem::WindowRect(WindowHandle window, LayoutRect* rect) {
+    RECT rc;
+    if (!GetWindowRect(ToHWND(window), &rc)) return false;
+    *rect = ToLayoutRect(rc);
+    return true;
+}
+
+bool Win32WindowSystem::ClientRect(WindowHandle window, LayoutRect* rect) {
+    // GetClientRect + ClientToScreen gives the content area, excluding the
+    // title bar and borders
+    RECT rcClient;
+    if (!GetClientRect(ToHWND(window), &rcClient)) return false;
+
+    POINT tl = {rcClient.left, rcClient.top};
+    POINT br = {rcClient.right, rcClient.bottom};
+    ClientToScreen(ToHWND(window), &tl);
+    ClientToScreen(ToHWND(window), &br);
+    *rect = {(int32_t)tl.x, (int32_t)tl.y, (int32_t)br.x, (int32_t)br.y};
+    return true;
+}
+
+void Win32WindowSystem::ForEachWindow(EnumProc proc, void* context) {
+    EnumContext enumContext = {proc, context};
+    EnumWindows(EnumWindowsThunk, (LPARAM)&enumContext);
+}
+
+bool Win32WindowSystem::SetRegion(WindowHandle window, const LayoutRect* region) {
+    if (!region) return SetWindowRgn(ToHWND(window), NULL, TRUE) != 0;
+
+    HRGN hrgn = CreateRectRgn(region->left, region->top, region->right, region->bottom);
+    if (!hrgn) return false;
+    // On success the system owns the region
+    if (SetWindowRgn(ToHWND(window), hrgn, TRUE)) return true;
+    DeleteObject(hrgn);
+    return false;
+}
+
+bool Win32WindowSystem::Move(WindowHandle window, const LayoutRect& rect) {
+    return SetWindowPos(ToHWND(window), NULL, rect.left, rect.top, rect.Width(), rect.Height(),
+                        SWP_NOZORDER | SWP_NOACTIVATE) != FALSE;
+}
+
+std::chrono::steady_clock::time_point Win32WindowSystem::Now() {
+    return std::chrono::steady_clock::now();
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "window_system.hpp"
+#include <windows.h>
+
+// IWindowSystem over user32 for the live desktop.
+class Win32WindowSystem : public IWindowSystem {
+public:
+    WindowHandle Foreground() override;
+    bool Exists(WindowHandle window) override;
+    bool IsVisible(WindowHandle window) override;
+    bool IsOwnedByProcess(WindowHandle window) override;
+    bool WindowRect(WindowHandle window, LayoutRect* rect) override;
+    bool ClientRect(WindowHandle window, LayoutRect* rect) override;
+    void ForEachWindow(EnumProc proc, void* context) override;
+    bool SetRegion(WindowHandle window, const LayoutRect* region) override;
+    bool Move(WindowHandle window, const LayoutRect& rect) override;
+    std::chrono::steady_clock::time_point Now() override;
+};
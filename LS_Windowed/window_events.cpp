@@ -0,0 +1,51 @@
+#include "window_events.hpp"
+#include <algorithm>
+
+bool WindowEventQueue::TakePending(std::vector<WindowEvent>& out) {
+    if (m_pending.empty()) return false;
+    out.insert(out.end(), m_pending.begin(), m_pending.end());
+    m_pending.clear();
+    return true;
+}
+
+bool WindowEventQueue::WaitEvents(std::chrono::milliseconds timeout, std::vector<WindowEvent>& out) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto hasEvents = [this] { return !m_pending.empty(); };
+    if (timeout == kWaitForever) {
+        m_cv.wait(lock, hasEvents);
+    } else if (!m_cv.wait_for(lock, timeout, hasEvents)) {
+        return false;
+    }
+    return TakePending(out);
+}
+
+void WindowEventQueue::Post(const WindowEvent& event) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(event);
+    }
+    m_cv.notify_one();
+}
+
+void SimulatedEventSource::Post(const WindowEvent& event) {
+    // Without hooks only explicit wake-ups reach the tracker
+    if (!m_available && event.type != WindowEventType::Wake) return;
+    WindowEventQueue::Post(event);
+}
+
+void SimulatedEventSource::WatchMoves(const std::vector<uint32_t>& processes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_movesScoped = true;
+    m_moveProcesses = processes;
+}
+
+void SimulatedEventSource::Emit(WindowEventType type, uintptr_t window, uint32_t process) {
+    if (type == WindowEventType::MoveSize) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_movesScoped &&
+            std::find(m_moveProcesses.begin(), m_moveProcesses.end(), process) == m_moveProcesses.end()) {
+            return;
+        }
+    }
+    Post({type, window, std::chrono::steady_clock::now()});
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Window events the target tracker wakes up for. Handles are kept opaque so the
+// scheduling core builds without user32.
+enum class WindowEventType {
+    Foreground,    // A different window became the foreground window
+    MoveSize,      // A window moved or was resized
+    Show,          // A window was shown (e.g. the LS overlay appearing)
+    Destroy,       // A window was destroyed
+    DisplayChange, // Monitors were added, removed or changed mode
+    Wake,          // Explicit wake-up (settings changed, shutdown)
+};
+
+struct WindowEvent {
+    WindowEventType type = WindowEventType::Wake;
+    uintptr_t window = 0;
+    std::chrono::steady_clock::time_point time;
+};
+
+// Passed to WaitEvents to block until an event arrives.
+constexpr std::chrono::milliseconds kWaitForever{-1};
+
+class IWindowEventSource {
+public:
+    virtual ~IWindowEventSource() = default;
+
+    // Starts delivering events on the calling thread. Returns false if the
+    // source is unavailable, in which case the caller has to poll.
+    virtual bool Start() = 0;
+    virtual void Stop() = 0;
+
+    // Blocks until at least one event is queued or the timeout expires, then
+    // moves every pending event into out. Returns false on timeout.
+    virtual bool WaitEvents(std::chrono::milliseconds timeout, std::vector<WindowEvent>& out) = 0;
+
+    // Thread-safe: queues an event and wakes the waiting thread.
+    virtual void Post(const WindowEvent& event) = 0;
+
+    // Limits MoveSize events to windows of these processes; the other types
+    // stay global. Until the first call every move is delivered. Called on the
+    // thread that called Start(), whenever the set changes.
+    virtual void WatchMoves(const std::vector<uint32_t>& processes) = 0;
+};
+
+// Mutex/condition-variable backed queue shared by the concrete sources.
+class WindowEventQueue : public IWindowEventSource {
+public:
+    bool WaitEvents(std::chrono::milliseconds timeout, std::vector<WindowEvent>& out) override;
+    void Post(const WindowEvent& event) override;
+
+protected:
+    // Moves pending events into out without blocking. Returns true if any.
+    bool TakePending(std::vector<WindowEvent>& out);
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<WindowEvent> m_pending;
+};
+
+// Scripted event source used to drive the tracker off Windows. When created as
+// unavailable it behaves like a platform without event hooks: only Wake events
+// are delivered and the tracker has to fall back to polling.
+class SimulatedEventSource : public WindowEventQueue {
+public:
+    explicit SimulatedEventSource(bool available = true) : m_available(available) {}
+
+    bool Start() override { return m_available; }
+    void Stop() override {}
+    void Post(const WindowEvent& event) override;
+    void WatchMoves(const std::vector<uint32_t>& processes) override;
+
+    // Convenience for scripts: posts an event stamped with the current time,
+    // as raised by a window of process. Moves outside the watched processes
+    // are dropped, as the system would not deliver them.
+    void Emit(WindowEventType type, uintptr_t window, uint32_t process = 0);
+
+private:
+    bool m_available;
+    bool m_movesScoped = false; // Guarded by m_mutex
+    std::vector<uint32_t> m_moveProcesses;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include "layout.hpp"
+#include <chrono>
+#include <cstdint>
+
+// Opaque top-level window handle (an HWND on Windows)
+using WindowHandle = uintptr_t;
+
+// The user32 calls the layout engine needs, so the engine can run against the
+// real desktop (Win32WindowSystem) or an in-memory one (SimulatedDesktop).
+// All rectangles are in screen coordinates unless noted otherwise.
+class IWindowSystem {
+public:
+    // Return false to stop the enumeration
+    using EnumProc = bool (*)(WindowHandle window, void* context);
+
+    virtual ~IWindowSystem() = default;
+
+    virtual WindowHandle Foreground() = 0;
+    virtual bool Exists(WindowHandle window) = 0;
+    virtual bool IsVisible(WindowHandle window) = 0;
+    virtual bool IsOwnedByProcess(WindowHandle window) = 0; // Belongs to the calling process (LS itself)
+    virtual bool WindowRect(WindowHandle window, LayoutRect* rect) = 0;
+    virtual bool ClientRect(WindowHandle window, LayoutRect* rect) = 0;
+
+    // Top-level windows in z-order, topmost first
+    virtual void ForEachWindow(EnumProc proc, void* context) = 0;
+
+    // Clips the window to region (relative to its upper-left corner); nullptr
+    // removes the clip. Returns false if the region was not applied.
+    virtual bool SetRegion(WindowHandle window, const LayoutRect* region) = 0;
+    // Moves and resizes without activating or changing the z-order
+    virtual bool Move(WindowHandle window, const LayoutRect& rect) = 0;
+
+    virtual std::chrono::steady_clock::time_point Now() = 0;
+};